@@ -1,6 +1,7 @@
 const express = require('express');
 const path = require('path');
 const os = require('os'); // 用于获取本机 IP
+const { FrameEncoder, CONTENT_TYPE: DELTA_CONTENT_TYPE } = require('./public/frame_codec');
 
 const app = express();
 const PORT = 3000;
@@ -24,6 +25,54 @@ app.get('/', (req, res) => {
     res.sendFile(path.join(__dirname, 'public', 'index.html'));
 });
 
+// 帧转发：{"ip":"192.168.1.50","brightness":20,"data":[0xRRGGBB, ...]}
+// 服务端按设备维护编码器，把整帧压缩成差分帧后发给设备的 /api/matrix/raw，
+// 适合脚本/定时任务推送动画，不用每次传 64 个十进制整数
+const encoders = new Map();   // ip -> { encoder, brightness }
+
+async function pushDelta(ip, rgb, brightness, retry = true) {
+    let state = encoders.get(ip);
+    if (!state || state.encoder.pixels !== rgb.length / 3) {
+        state = { encoder: new FrameEncoder(rgb.length / 3), brightness };
+        encoders.set(ip, state);
+    }
+    if (state.brightness !== brightness) {
+        state.encoder.forceKey();
+        state.brightness = brightness;
+    }
+    const res = await fetch(`http://${ip}/api/matrix/raw?brightness=${brightness}`, {
+        method: 'POST',
+        headers: { 'Content-Type': DELTA_CONTENT_TYPE },
+        body: state.encoder.encode(rgb),
+    });
+    if (res.status === 409 && retry) {
+        // 设备重启或丢帧，补发关键帧
+        state.encoder.forceKey();
+        return pushDelta(ip, rgb, brightness, false);
+    }
+    return res;
+}
+
+app.post('/api/push', async (req, res) => {
+    const { ip, data, brightness = 100 } = req.body || {};
+    if (!ip || !Array.isArray(data) || data.length === 0) {
+        return res.status(400).json({ error: 'need ip and data' });
+    }
+    const rgb = new Uint8Array(data.length * 3);
+    data.forEach((c, i) => {
+        rgb[i * 3] = (c >> 16) & 0xFF;
+        rgb[i * 3 + 1] = (c >> 8) & 0xFF;
+        rgb[i * 3 + 2] = c & 0xFF;
+    });
+    try {
+        const r = await pushDelta(ip, rgb, brightness);
+        res.status(r.ok ? 200 : 502).json({ status: r.status });
+    } catch (err) {
+        encoders.delete(ip);
+        res.status(502).json({ error: err.message });
+    }
+});
+
 // 404 处理 (当访问不存在的页面时)
 app.use((req, res) => {
     res.status(404).send('<h1>404 Not Found</h1><p>找不到这个页面，请检查 URL。</p>');
@@ -0,0 +1,147 @@
+// 压缩帧基准：比较 JSON 帧、原始 RGB888 帧和差分+游程压缩帧的线上字节数和解码耗时
+//
+//   node bench/codec_bench.js                       # 内置的几段典型动画，8x8 画布
+//   node bench/codec_bench.js --size 32x16          # 内置动画，指定画布宽x高 (与设备的 /api/canvas 一致)
+//   node bench/codec_bench.js rec1.json ...         # 录制的序列：[[0xRRGGBB x 像素数], ...]，画布大小取自录制
+//
+// 字节数按 WebSocket 消息计 (含 6 字节帧头；JSON 为 HTTP Body)。
+// 解码耗时是本机 Node 运行 JS 解码器 (public/frame_codec.js) 的时间，只适合比较几种格式的相对开销，
+// 不代表设备上 C 解码器 (main/frame_codec.c) 的耗时；设备上的数字看 GET /api/stats 的 fb_update。
+const fs = require('fs');
+const path = require('path');
+const { FrameEncoder, FrameDecoder } = require('../public/frame_codec');
+
+const WS_HDR = 6;
+
+function hsv(h, v = 1) {
+    const f = (n) => {
+        const k = (n + h * 6) % 6;
+        return Math.round(255 * v * (1 - Math.max(0, Math.min(k, 4 - k, 1))));
+    };
+    return (f(5) << 16) | (f(3) << 8) | f(1);
+}
+
+// 固定种子，结果可重复
+function rng(seed) {
+    return () => (seed = (seed * 1103515245 + 12345) & 0x7fffffff) / 0x7fffffff;
+}
+
+// 各生成器按 W x H 画布生成帧序列 (每帧为 W*H 个 0xRRGGBB)
+const builtin = {
+    // 单色文字从右往左滚动，每帧整体移动一列
+    scroll_text: (W, H) => {
+        const N = W * H, cols = [];
+        for (let i = 0; i < 150 + W; i++) cols.push((i % 6 < 5) ? (0x3C >> (i % 3)) | 0x42 : 0);
+        return Array.from({ length: 150 }, (_, t) => Array.from({ length: N }, (_, i) => {
+            const x = i % W, y = ((i / W) | 0) - ((H - 8) >> 1);    // 8 行高的字形垂直居中
+            return y >= 0 && (cols[t + x] >> y) & 1 ? 0x0F0F0F : 0;
+        }));
+    },
+    // 一个 2x2 小方块在黑底上弹跳
+    sprite: (W, H) => {
+        const N = W * H;
+        let x = 0, y = H >> 1, dx = 1, dy = 1;
+        return Array.from({ length: 150 }, () => {
+            const f = new Array(N).fill(0);
+            for (const [ox, oy] of [[0, 0], [1, 0], [0, 1], [1, 1]]) f[(y + oy) * W + x + ox] = 0xFF4000;
+            if (x + dx < 0 || x + dx > W - 2) dx = -dx;
+            if (y + dy < 0 || y + dy > H - 2) dy = -dy;
+            x += dx; y += dy;
+            return f;
+        });
+    },
+    // 在画板上逐点作画：每帧多一两个像素
+    painting: (W, H) => {
+        const N = W * H, r = rng(1), f = new Array(N).fill(0);
+        return Array.from({ length: 120 }, () => {
+            for (let k = 0; k < 1 + (r() < 0.3); k++) f[(r() * N) | 0] = hsv(r());
+            return f.slice();
+        });
+    },
+    // 彩虹整屏渐变：每帧所有像素都变
+    rainbow: (W, H) => Array.from({ length: 150 }, (_, t) =>
+        Array.from({ length: W * H }, (_, i) => hsv(((i % W) + (i / W | 0) + t) / 16 % 1, 0.3))),
+    // 随机噪点：最坏情况
+    noise: (W, H) => {
+        const r = rng(7);
+        return Array.from({ length: 100 }, () => Array.from({ length: W * H }, () => (r() * 0x1000000) | 0));
+    },
+};
+
+function toRgb(frame) {
+    const rgb = new Uint8Array(frame.length * 3);
+    frame.forEach((c, i) => {
+        rgb[i * 3] = (c >> 16) & 0xFF;
+        rgb[i * 3 + 1] = (c >> 8) & 0xFF;
+        rgb[i * 3 + 2] = c & 0xFF;
+    });
+    return rgb;
+}
+
+function timeIt(fn, rounds) {
+    fn();   // 预热
+    const t0 = process.hrtime.bigint();
+    for (let r = 0; r < rounds; r++) fn();
+    return Number(process.hrtime.bigint() - t0) / rounds;
+}
+
+function bench(name, frames) {
+    const pixels = frames[0].length;
+    const json = frames.map((f) => Buffer.from(JSON.stringify({ data: f, brightness: 20 })));
+    const raw = frames.map(toRgb);
+    const enc = new FrameEncoder(pixels, 30);
+    const delta = raw.map((f) => enc.encode(f));
+
+    // 解码结果必须与原帧一致
+    const check = new FrameDecoder(pixels);
+    delta.forEach((d, i) => {
+        if (check.decode(d) !== 'ok' || !Buffer.from(check.ref).equals(Buffer.from(raw[i]))) {
+            throw new Error(`${name}: frame ${i} does not round-trip`);
+        }
+    });
+
+    const bytes = {
+        json: json.reduce((s, b) => s + b.length, 0),
+        raw: raw.reduce((s, b) => s + b.length + WS_HDR, 0),
+        delta: delta.reduce((s, b) => s + b.length + WS_HDR, 0),
+    };
+    const rounds = Math.max(1, Math.round(20000 / frames.length));
+    const out = new Uint8Array(pixels * 3);
+    const ns = {
+        json: timeIt(() => json.forEach((b) => {
+            const data = JSON.parse(b).data;
+            for (let i = 0; i < data.length; i++) {
+                out[i * 3] = data[i] >> 16; out[i * 3 + 1] = data[i] >> 8; out[i * 3 + 2] = data[i];
+            }
+        }), rounds) / frames.length,
+        raw: timeIt(() => raw.forEach((b) => out.set(b)), rounds) / frames.length,
+        delta: timeIt(() => {
+            const dec = new FrameDecoder(pixels);
+            delta.forEach((b) => dec.decode(b));
+        }, rounds) / frames.length,
+    };
+
+    const row = (k) => `  ${k.padEnd(6)} ${String(Math.round(bytes[k] / frames.length)).padStart(6)} B/frame ` +
+        `${(bytes[k] / bytes.json * 100).toFixed(1).padStart(6)}% of JSON ${(ns[k] / 1000).toFixed(2).padStart(8)} us decode (Node)`;
+    console.log(`${name} (${frames.length} frames, ${pixels} px)`);
+    ['json', 'raw', 'delta'].forEach((k) => console.log(row(k)));
+}
+
+const args = process.argv.slice(2);
+let size = '8x8';
+const sizeAt = args.indexOf('--size');
+if (sizeAt >= 0) size = args.splice(sizeAt, 2)[1] || '';
+const m = /^(\d+)x(\d+)$/.exec(size);
+// 帧头像素数为 uint16，sprite 需要至少 2x2
+if (!m || m[1] < 2 || m[2] < 2 || m[1] * m[2] > 0xFFFF) {
+    console.error(`bad --size '${size}', expected WxH with W, H >= 2 and at most 65535 pixels`);
+    process.exit(2);
+}
+
+if (args.length) {
+    args.forEach((f) => bench(path.basename(f), JSON.parse(fs.readFileSync(f, 'utf8'))));
+} else {
+    const W = +m[1], H = +m[2];
+    console.log(`canvas ${W}x${H}; decode times are the JS decoder in Node on this host, not the device`);
+    Object.entries(builtin).forEach(([name, gen]) => bench(name, gen(W, H)));
+}
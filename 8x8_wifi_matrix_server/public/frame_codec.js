@@ -0,0 +1,132 @@
+// 压缩帧编码 (XOR 差分 + 游程编码)，格式与固件 main/frame_codec.h 一致
+// 浏览器中通过 <script> 引入 (全局 FrameCodec)，Node 中 require('./public/frame_codec')
+(function (root, factory) {
+    if (typeof module === 'object' && module.exports) module.exports = factory();
+    else root.FrameCodec = factory();
+})(this, function () {
+    const HDR_LEN = 4;
+    const FLAG_KEY = 0x01;
+    const OP_REPEAT = 0x40;
+    const OP_SKIP = 0x80;
+    const RUN_MAX = 64;
+    const SKIP_MAX = 128;
+
+    // 第 i 个像素与 j 个像素的 XOR 值是否相同
+    function samePixel(x, i, j) {
+        return x[i * 3] === x[j * 3] && x[i * 3 + 1] === x[j * 3 + 1] && x[i * 3 + 2] === x[j * 3 + 2];
+    }
+
+    function isZero(x, i) {
+        return (x[i * 3] | x[i * 3 + 1] | x[i * 3 + 2]) === 0;
+    }
+
+    // 对 XOR 后的像素做游程编码，返回操作字节数组
+    function rle(x, pixels, out) {
+        let i = 0;
+        while (i < pixels) {
+            if (isZero(x, i)) {
+                let n = 1;
+                while (i + n < pixels && n < SKIP_MAX && isZero(x, i + n)) n++;
+                out.push(OP_SKIP | (n - 1));
+                i += n;
+                continue;
+            }
+            let n = 1;
+            while (i + n < pixels && n < RUN_MAX && samePixel(x, i, i + n)) n++;
+            if (n >= 2) {
+                // 2 个以上相同像素用重复比字面量短
+                out.push(OP_REPEAT | (n - 1), x[i * 3], x[i * 3 + 1], x[i * 3 + 2]);
+                i += n;
+                continue;
+            }
+            // 字面量一直延续到遇到 0 或相同像素为止
+            n = 1;
+            while (i + n < pixels && n < RUN_MAX && !isZero(x, i + n) &&
+                   !(i + n + 1 < pixels && samePixel(x, i + n, i + n + 1))) n++;
+            out.push(n - 1);
+            for (let k = i * 3; k < (i + n) * 3; k++) out.push(x[k]);
+            i += n;
+        }
+    }
+
+    class FrameEncoder {
+        // keyInterval: 每隔多少帧强制发一次关键帧
+        constructor(pixels, keyInterval = 30) {
+            this.pixels = pixels;
+            this.keyInterval = keyInterval;
+            this.prev = new Uint8Array(pixels * 3);
+            this.xor = new Uint8Array(pixels * 3);
+            this.id = 0;
+            this.sinceKey = 0;
+            this.needKey = true;
+        }
+
+        // 下一帧改发关键帧 (设备要求、亮度变化或重新连接时)
+        forceKey() {
+            this.needKey = true;
+        }
+
+        // rgb: Uint8Array(pixels*3)，返回编码后的 Uint8Array
+        encode(rgb) {
+            const key = this.needKey || this.sinceKey >= this.keyInterval;
+            for (let i = 0; i < this.pixels * 3; i++) {
+                this.xor[i] = key ? rgb[i] : rgb[i] ^ this.prev[i];
+            }
+            this.id = (this.id + 1) & 0xFF;
+            const out = [key ? FLAG_KEY : 0, this.id, this.pixels & 0xFF, this.pixels >> 8];
+            rle(this.xor, this.pixels, out);
+            this.prev.set(rgb.subarray(0, this.pixels * 3));
+            this.sinceKey = key ? 1 : this.sinceKey + 1;
+            this.needKey = false;
+            return Uint8Array.from(out);
+        }
+    }
+
+    // 参考解码器，逻辑与固件 frame_decode 相同，用于测试和基准
+    class FrameDecoder {
+        constructor(pixels) {
+            this.pixels = pixels;
+            this.ref = new Uint8Array(pixels * 3);
+            this.lastId = 0;
+            this.valid = false;
+        }
+
+        // 返回 'ok' / 'bad' / 'need_key'
+        decode(buf) {
+            if (buf.length < HDR_LEN || (buf[2] | (buf[3] << 8)) !== this.pixels) return 'bad';
+            const key = (buf[0] & FLAG_KEY) !== 0;
+            if (!key && (!this.valid || buf[1] !== ((this.lastId + 1) & 0xFF))) return 'need_key';
+            const next = key ? new Uint8Array(this.pixels * 3) : this.ref.slice();
+            let p = HDR_LEN;
+            let index = 0;
+            while (p < buf.length) {
+                const op = buf[p++];
+                let n;
+                if (op & OP_SKIP) {
+                    n = (op & 0x7F) + 1;
+                } else if (op & OP_REPEAT) {
+                    n = (op & 0x3F) + 1;
+                    if (p + 3 > buf.length || index + n > this.pixels) return 'bad';
+                    for (let i = 0; i < n; i++) {
+                        for (let c = 0; c < 3; c++) next[(index + i) * 3 + c] ^= buf[p + c];
+                    }
+                    p += 3;
+                } else {
+                    n = op + 1;
+                    if (p + n * 3 > buf.length || index + n > this.pixels) return 'bad';
+                    for (let k = 0; k < n * 3; k++) next[index * 3 + k] ^= buf[p + k];
+                    p += n * 3;
+                }
+                index += n;
+                if (index > this.pixels) return 'bad';
+            }
+            if (index !== this.pixels) return 'bad';
+            this.ref = next;
+            this.lastId = buf[1];
+            this.valid = true;
+            return 'ok';
+        }
+    }
+
+    return { FrameEncoder, FrameDecoder, FORMAT_ID: 3, CONTENT_TYPE: 'application/x-matrix-delta' };
+});
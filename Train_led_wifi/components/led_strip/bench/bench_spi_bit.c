@@ -0,0 +1,17 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// `__led_strip_spi_bit` is static inline, build the SPI backend into this unit to reach it.
+// The backend is not linked a second time: led_strip_bench links this unit instead of led_strip_spi_dev.c
+#include "led_strip_spi_dev.c"
+#include "bench_stubs.h"
+
+void bench_spi_bit(const uint8_t *data, size_t len, uint8_t *buf)
+{
+    for (size_t i = 0; i < len; i++) {
+        __led_strip_spi_bit(data[i], buf);
+        buf += SPI_BYTES_PER_COLOR_BYTE;
+    }
+}
@@ -0,0 +1,384 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// Host benchmark: RMT and SPI driver calls replaced by in-memory stand-ins.
+// The RMT side keeps the real contract of the encoder API: a channel owns a memory block of
+// `mem_block_symbols`, encoders write into it and report RMT_ENCODING_MEM_FULL when it is full,
+// the "hardware" drains the block and calls the encoder again until RMT_ENCODING_COMPLETE.
+// That way `rmt_encode_led_strip` runs through the same yields as in the RMT ISR.
+// Channels under a sync manager hold their transmission until every channel of the manager is loaded,
+// like the hardware: a channel left out keeps the others waiting and `rmt_tx_wait_all_done` times out.
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "driver/rmt_tx.h"
+#include "driver/spi_master.h"
+#include "soc/spi_periph.h"
+#include "bench_stubs.h"
+
+#define STUB_RMT_MAX_CHANNELS 8
+
+struct rmt_channel_t {
+    int gpio_num;
+    struct rmt_sync_manager_t *synchro;
+    bool sync_loaded;   // loaded since the last rmt_sync_reset, held until the whole group is loaded
+    rmt_symbol_word_t *mem;
+    size_t mem_symbols;
+    size_t offset;      // symbols written into the memory block since it was last drained
+    size_t sent;        // symbols drained by the last transmission
+    rmt_symbol_word_t *capture; // copy of the drained symbols, see bench_rmt_capture
+    size_t capture_max;
+    size_t capture_len;
+};
+
+typedef struct {
+    rmt_encoder_t base;
+    rmt_symbol_word_t bit0;
+    rmt_symbol_word_t bit1;
+    size_t byte_pos;
+    int bit_pos;
+} stub_bytes_encoder_t;
+
+typedef struct {
+    rmt_encoder_t base;
+    size_t symbol_pos;
+} stub_copy_encoder_t;
+
+struct rmt_sync_manager_t {
+    rmt_channel_handle_t channels[STUB_RMT_MAX_CHANNELS];
+    size_t num_channels;
+};
+
+const spi_signal_conn_t spi_periph_signal[3];
+static rmt_channel_handle_t s_channels[STUB_RMT_MAX_CHANNELS]; // live channels, see bench_rmt_find_channel
+
+static size_t stub_encode_bytes(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
+{
+    stub_bytes_encoder_t *bytes_encoder = __containerof(encoder, stub_bytes_encoder_t, base);
+    const uint8_t *data = primary_data;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    size_t encoded_symbols = 0;
+    while (bytes_encoder->byte_pos < data_size) {
+        if (channel->offset == channel->mem_symbols) {
+            state |= RMT_ENCODING_MEM_FULL;
+            goto out;
+        }
+        // MSB first, like every LED model supported by the led_strip encoder
+        uint8_t mask = 0x80 >> bytes_encoder->bit_pos;
+        channel->mem[channel->offset++] = (data[bytes_encoder->byte_pos] & mask) ? bytes_encoder->bit1 : bytes_encoder->bit0;
+        encoded_symbols++;
+        if (++bytes_encoder->bit_pos == 8) {
+            bytes_encoder->bit_pos = 0;
+            bytes_encoder->byte_pos++;
+        }
+    }
+    bytes_encoder->byte_pos = 0;
+    state |= RMT_ENCODING_COMPLETE;
+    if (channel->offset == channel->mem_symbols) {
+        state |= RMT_ENCODING_MEM_FULL;
+    }
+out:
+    *ret_state = state;
+    return encoded_symbols;
+}
+
+static size_t stub_encode_copy(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
+{
+    stub_copy_encoder_t *copy_encoder = __containerof(encoder, stub_copy_encoder_t, base);
+    const rmt_symbol_word_t *symbols = primary_data;
+    size_t num_symbols = data_size / sizeof(rmt_symbol_word_t);
+    size_t free_symbols = channel->mem_symbols - channel->offset;
+    size_t copy_symbols = num_symbols - copy_encoder->symbol_pos;
+    if (copy_symbols > free_symbols) {
+        copy_symbols = free_symbols;
+    }
+    memcpy(channel->mem + channel->offset, symbols + copy_encoder->symbol_pos, copy_symbols * sizeof(rmt_symbol_word_t));
+    channel->offset += copy_symbols;
+    copy_encoder->symbol_pos += copy_symbols;
+
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    if (copy_encoder->symbol_pos == num_symbols) {
+        copy_encoder->symbol_pos = 0;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    if (channel->offset == channel->mem_symbols) {
+        state |= RMT_ENCODING_MEM_FULL;
+    }
+    *ret_state = state;
+    return copy_symbols;
+}
+
+static esp_err_t stub_reset_bytes(rmt_encoder_t *encoder)
+{
+    stub_bytes_encoder_t *bytes_encoder = __containerof(encoder, stub_bytes_encoder_t, base);
+    bytes_encoder->byte_pos = 0;
+    bytes_encoder->bit_pos = 0;
+    return ESP_OK;
+}
+
+static esp_err_t stub_reset_copy(rmt_encoder_t *encoder)
+{
+    stub_copy_encoder_t *copy_encoder = __containerof(encoder, stub_copy_encoder_t, base);
+    copy_encoder->symbol_pos = 0;
+    return ESP_OK;
+}
+
+static esp_err_t stub_del_bytes(rmt_encoder_t *encoder)
+{
+    free(__containerof(encoder, stub_bytes_encoder_t, base));
+    return ESP_OK;
+}
+
+static esp_err_t stub_del_copy(rmt_encoder_t *encoder)
+{
+    free(__containerof(encoder, stub_copy_encoder_t, base));
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_bytes_encoder(const rmt_bytes_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    stub_bytes_encoder_t *bytes_encoder = calloc(1, sizeof(stub_bytes_encoder_t));
+    if (!bytes_encoder) {
+        return ESP_ERR_NO_MEM;
+    }
+    bytes_encoder->base.encode = stub_encode_bytes;
+    bytes_encoder->base.reset = stub_reset_bytes;
+    bytes_encoder->base.del = stub_del_bytes;
+    bytes_encoder->bit0 = config->bit0;
+    bytes_encoder->bit1 = config->bit1;
+    *ret_encoder = &bytes_encoder->base;
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    stub_copy_encoder_t *copy_encoder = calloc(1, sizeof(stub_copy_encoder_t));
+    if (!copy_encoder) {
+        return ESP_ERR_NO_MEM;
+    }
+    copy_encoder->base.encode = stub_encode_copy;
+    copy_encoder->base.reset = stub_reset_copy;
+    copy_encoder->base.del = stub_del_copy;
+    *ret_encoder = &copy_encoder->base;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder)
+{
+    return encoder->del(encoder);
+}
+
+esp_err_t rmt_encoder_reset(rmt_encoder_handle_t encoder)
+{
+    return encoder->reset(encoder);
+}
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *ret_chan)
+{
+    struct rmt_channel_t *channel = calloc(1, sizeof(struct rmt_channel_t));
+    if (!channel) {
+        return ESP_ERR_NO_MEM;
+    }
+    channel->gpio_num = config->gpio_num;
+    channel->mem_symbols = config->mem_block_symbols;
+    channel->mem = calloc(channel->mem_symbols, sizeof(rmt_symbol_word_t));
+    if (!channel->mem) {
+        free(channel);
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < STUB_RMT_MAX_CHANNELS; i++) {
+        if (!s_channels[i]) {
+            s_channels[i] = channel;
+            break;
+        }
+    }
+    *ret_chan = channel;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_channel(rmt_channel_handle_t channel)
+{
+    for (size_t i = 0; i < STUB_RMT_MAX_CHANNELS; i++) {
+        if (s_channels[i] == channel) {
+            s_channels[i] = NULL;
+        }
+    }
+    free(channel->mem);
+    free(channel);
+    return ESP_OK;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t channel)
+{
+    return ESP_OK;
+}
+
+esp_err_t rmt_disable(rmt_channel_handle_t channel)
+{
+    return ESP_OK;
+}
+
+esp_err_t rmt_transmit(rmt_channel_handle_t channel, rmt_encoder_handle_t encoder, const void *payload, size_t payload_bytes, const rmt_transmit_config_t *config)
+{
+    if (channel->synchro) {
+        if (channel->sync_loaded) {
+            return ESP_ERR_INVALID_STATE; // the sync manager must be reset before the next transmission
+        }
+        channel->sync_loaded = true;
+    }
+    bench_rmt_run_encoder(channel, encoder, payload, payload_bytes);
+    return ESP_OK;
+}
+
+esp_err_t rmt_tx_wait_all_done(rmt_channel_handle_t channel, int timeout_ms)
+{
+    return bench_rmt_waits_for_sync(channel) ? ESP_ERR_TIMEOUT : ESP_OK;
+}
+
+esp_err_t rmt_new_sync_manager(const rmt_sync_manager_config_t *config, rmt_sync_manager_handle_t *ret_synchro)
+{
+    if (config->array_size > STUB_RMT_MAX_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct rmt_sync_manager_t *synchro = calloc(1, sizeof(struct rmt_sync_manager_t));
+    if (!synchro) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < config->array_size; i++) {
+        if (config->tx_channel_array[i]->synchro) {
+            free(synchro);
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    for (size_t i = 0; i < config->array_size; i++) {
+        synchro->channels[i] = config->tx_channel_array[i];
+        synchro->channels[i]->synchro = synchro;
+        synchro->channels[i]->sync_loaded = false;
+    }
+    synchro->num_channels = config->array_size;
+    *ret_synchro = synchro;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_sync_manager(rmt_sync_manager_handle_t synchro)
+{
+    for (size_t i = 0; i < synchro->num_channels; i++) {
+        synchro->channels[i]->synchro = NULL;
+    }
+    free(synchro);
+    return ESP_OK;
+}
+
+esp_err_t rmt_sync_reset(rmt_sync_manager_handle_t synchro)
+{
+    for (size_t i = 0; i < synchro->num_channels; i++) {
+        synchro->channels[i]->sync_loaded = false;
+    }
+    return ESP_OK;
+}
+
+bool bench_rmt_waits_for_sync(rmt_channel_handle_t channel)
+{
+    struct rmt_sync_manager_t *synchro = channel->synchro;
+    if (!synchro || !channel->sync_loaded) {
+        return false;
+    }
+    for (size_t i = 0; i < synchro->num_channels; i++) {
+        if (!synchro->channels[i]->sync_loaded) {
+            return true;
+        }
+    }
+    return false;
+}
+
+rmt_channel_handle_t bench_rmt_find_channel(int gpio_num)
+{
+    for (size_t i = 0; i < STUB_RMT_MAX_CHANNELS; i++) {
+        if (s_channels[i] && s_channels[i]->gpio_num == gpio_num) {
+            return s_channels[i];
+        }
+    }
+    return NULL;
+}
+
+size_t bench_rmt_run_encoder(rmt_channel_handle_t channel, rmt_encoder_handle_t encoder, const void *payload, size_t payload_bytes)
+{
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    channel->sent = 0;
+    do {
+        // the previous memory block has been sent out, refill it from the start
+        channel->offset = 0;
+        channel->sent += encoder->encode(encoder, channel, payload, payload_bytes, &state);
+        size_t n = channel->offset;
+        if (n > channel->capture_max - channel->capture_len) {
+            n = channel->capture_max - channel->capture_len;
+        }
+        if (n) {
+            memcpy(channel->capture + channel->capture_len, channel->mem, n * sizeof(rmt_symbol_word_t));
+            channel->capture_len += n;
+        }
+    } while (!(state & RMT_ENCODING_COMPLETE));
+    return channel->sent;
+}
+
+void bench_rmt_capture(rmt_channel_handle_t channel, rmt_symbol_word_t *buf, size_t max_symbols)
+{
+    channel->capture = buf;
+    channel->capture_max = buf ? max_symbols : 0;
+    channel->capture_len = 0;
+}
+
+size_t bench_rmt_captured(rmt_channel_handle_t channel)
+{
+    return channel->capture_len;
+}
+
+struct spi_device_t {
+    spi_transaction_t *pending;
+};
+
+esp_err_t spi_bus_initialize(spi_host_device_t host_id, const spi_bus_config_t *bus_config, int dma_chan)
+{
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host_id)
+{
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host_id, const spi_device_interface_config_t *dev_config, spi_device_handle_t *handle)
+{
+    *handle = calloc(1, sizeof(struct spi_device_t));
+    return *handle ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle)
+{
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_actual_freq(spi_device_handle_t handle, int *freq_khz)
+{
+    *freq_khz = 2500;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans_desc, TickType_t ticks_to_wait)
+{
+    handle->pending = trans_desc;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans_desc, TickType_t ticks_to_wait)
+{
+    if (!handle->pending) {
+        return ESP_ERR_TIMEOUT;
+    }
+    *trans_desc = handle->pending;
+    handle->pending = NULL;
+    return ESP_OK;
+}
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "driver/rmt_encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Drive an RMT encoder over a payload the way the RMT driver does, draining the channel memory block on every RMT_ENCODING_MEM_FULL
+ *
+ * @return Number of RMT symbols produced, including the reset code
+ */
+size_t bench_rmt_run_encoder(rmt_channel_handle_t channel, rmt_encoder_handle_t encoder, const void *payload, size_t payload_bytes);
+
+/**
+ * @brief Keep a copy of every symbol the channel sends from now on, in the order the hardware would send them
+ *
+ * @param buf Capture buffer, NULL to stop capturing; symbols past `max_symbols` are dropped
+ */
+void bench_rmt_capture(rmt_channel_handle_t channel, rmt_symbol_word_t *buf, size_t max_symbols);
+
+/**
+ * @brief Number of symbols captured since `bench_rmt_capture`
+ */
+size_t bench_rmt_captured(rmt_channel_handle_t channel);
+
+/**
+ * @brief Whether the channel has loaded a transmission that its sync manager holds back, because another channel
+ *        of the group has not been loaded since the last `rmt_sync_reset`
+ */
+bool bench_rmt_waits_for_sync(rmt_channel_handle_t channel);
+
+/**
+ * @brief Find a live RMT TX channel by the GPIO it was created for
+ *
+ * @return Channel handle, NULL if no channel drives that GPIO
+ */
+rmt_channel_handle_t bench_rmt_find_channel(int gpio_num);
+
+/**
+ * @brief Encode color bytes one by one with `__led_strip_spi_bit` from the SPI backend
+ */
+void bench_spi_bit(const uint8_t *data, size_t len, uint8_t *buf);
+
+#ifdef __cplusplus
+}
+#endif
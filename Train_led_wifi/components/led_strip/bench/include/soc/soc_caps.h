@@ -0,0 +1,10 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+// RMT TX of the ESP32-S3: 4 channels that the sync manager can start together
+#define SOC_RMT_TX_CANDIDATES_PER_GROUP 4
+#define SOC_RMT_SUPPORT_TX_SYNCHRO      1
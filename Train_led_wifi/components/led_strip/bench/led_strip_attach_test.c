@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// Host test of RMT strips created with `external_buffer`, built against the stubbed RMT driver (see bench_stubs.c).
+// Until a buffer is attached every call that reads or writes pixel memory must fail with ESP_ERR_INVALID_STATE
+// instead of dereferencing NULL. Once attached, the pixels land in the application's buffer in the strip's order
+// and the strip sends the same symbols as a strip with its own buffers. Both without and with the symbol cache.
+//   ./bench/build/led_strip_attach_test
+// Exit status 0 when every check passes, 1 otherwise.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "led_strip.h"
+#include "led_strip_rmt_encoder.h"
+#include "led_strip_rmt_dev.h"
+#include "driver/rmt_tx.h"
+#include "bench_stubs.h"
+
+#define TEST_STRIP_LEDS     20
+#define TEST_MAX_SYMBOLS    (TEST_STRIP_LEDS * 4 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1)
+
+static int s_failures;
+
+static void expect(bool ok, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    printf("  ");
+    vprintf(fmt, args);
+    printf(": %s\n", ok ? "ok" : "FAIL");
+    va_end(args);
+    if (!ok) {
+        s_failures++;
+    }
+}
+
+static led_strip_handle_t new_strip(bool external_buffer, bool use_symbol_cache)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = TEST_STRIP_LEDS,
+        .led_model = LED_MODEL_SK6812,
+        .color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRBW,
+    };
+    led_strip_rmt_config_t rmt_config = {
+        .flags.external_buffer = external_buffer,
+        .flags.use_symbol_cache = use_symbol_cache,
+    };
+    led_strip_handle_t strip = NULL;
+    if (led_strip_new_rmt_device(&strip_config, &rmt_config, &strip) != ESP_OK) {
+        printf("  cannot create the strip\n");
+        exit(1);
+    }
+    return strip;
+}
+
+// refresh the strip and return what its channel sent
+static size_t refresh_captured(led_strip_handle_t strip, rmt_symbol_word_t *out)
+{
+    rmt_channel_handle_t chan = NULL;
+    led_strip_rmt_get_channel(strip, &chan);
+    bench_rmt_capture(chan, out, TEST_MAX_SYMBOLS);
+    led_strip_refresh(strip);
+    size_t n = bench_rmt_captured(chan);
+    bench_rmt_capture(chan, NULL, 0);
+    return n;
+}
+
+static void test_external_buffer(bool use_symbol_cache)
+{
+    static rmt_symbol_word_t ref[TEST_MAX_SYMBOLS];
+    static rmt_symbol_word_t got[TEST_MAX_SYMBOLS];
+    static uint8_t pixels[TEST_STRIP_LEDS * 4];
+    static uint8_t rgb[TEST_STRIP_LEDS * 3];
+    led_strip_handle_t strip = new_strip(true, use_symbol_cache);
+
+    expect(led_strip_set_pixel(strip, 0, 1, 2, 3) == ESP_ERR_INVALID_STATE, "set_pixel before attach");
+    expect(led_strip_set_pixel_rgbw(strip, 0, 1, 2, 3, 4) == ESP_ERR_INVALID_STATE, "set_pixel_rgbw before attach");
+    expect(led_strip_set_pixel_hsv(strip, 0, 120, 255, 255) == ESP_ERR_INVALID_STATE, "set_pixel_hsv before attach");
+    expect(led_strip_set_pixels(strip, 0, rgb, TEST_STRIP_LEDS, LED_STRIP_COLOR_COMPONENT_FMT_RGB) == ESP_ERR_INVALID_STATE,
+           "set_pixels before attach");
+    expect(led_strip_clear(strip) == ESP_ERR_INVALID_STATE, "clear before attach");
+    expect(led_strip_refresh(strip) == ESP_ERR_INVALID_STATE, "refresh before attach");
+    expect(led_strip_refresh_async(strip) == ESP_ERR_INVALID_STATE, "refresh_async before attach");
+    expect(led_strip_refresh_partial_async(strip, 1) == ESP_ERR_INVALID_STATE, "refresh_partial_async before attach");
+    expect(led_strip_attach_buffer(strip, NULL) == ESP_ERR_INVALID_STATE, "attach NULL without own buffers");
+
+    // the same pixels through a strip with its own buffers give the reference
+    led_strip_handle_t plain = new_strip(false, use_symbol_cache);
+    memset(pixels, 0xa5, sizeof(pixels));
+    expect(led_strip_attach_buffer(strip, pixels) == ESP_OK, "attach");
+    bool set_ok = true;
+    for (uint32_t i = 0; i < TEST_STRIP_LEDS; i++) {
+        set_ok &= led_strip_set_pixel_rgbw(strip, i, i, i + 40, i + 80, i + 120) == ESP_OK;
+        led_strip_set_pixel_rgbw(plain, i, i, i + 40, i + 80, i + 120);
+    }
+    expect(set_ok, "set_pixel_rgbw after attach");
+    expect(pixels[0] == 40 && pixels[1] == 0 && pixels[2] == 80 && pixels[3] == 120 &&
+           pixels[(TEST_STRIP_LEDS - 1) * 4 + 3] == TEST_STRIP_LEDS - 1 + 120, "pixels in the attached buffer, GRBW order");
+    size_t ref_len = refresh_captured(plain, ref);
+    size_t got_len = refresh_captured(strip, got);
+    expect(ref_len == TEST_MAX_SYMBOLS && got_len == ref_len && memcmp(got, ref, ref_len * sizeof(ref[0])) == 0,
+           "refresh sends the same as a strip with its own buffers");
+    expect(led_strip_clear(strip) == ESP_OK && pixels[0] == 0, "clear after attach");
+
+    led_strip_del(plain);
+    led_strip_del(strip);
+}
+
+int main(void)
+{
+    printf("external buffer, %d LEDs\n", TEST_STRIP_LEDS);
+    test_external_buffer(false);
+    printf("external buffer with symbol cache, %d LEDs\n", TEST_STRIP_LEDS);
+    test_external_buffer(true);
+
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,457 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// Host benchmark of the led_strip hot paths, built against stubbed RMT/SPI drivers (see bench_stubs.c).
+// Every case is measured as `runs` samples of at least `sample_us` each, one line of statistics per
+// (op, color component format, strip length), in CSV or JSON lines so results can be diffed across versions.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include "esp_check.h"
+#include "led_strip.h"
+#include "led_strip_rmt_encoder.h"
+#include "driver/rmt_tx.h"
+#include "bench_stubs.h"
+
+#ifndef LED_STRIP_VERSION
+#define LED_STRIP_VERSION "unknown"
+#endif
+
+#define BENCH_MAX_RUNS 101
+#define BENCH_RMT_MEM_BLOCK_SYMBOLS 48 // same as the RMT backend default on ESP32-C3/S3
+
+typedef enum {
+    BENCH_BACKEND_RMT,
+    BENCH_BACKEND_RMT_CACHE,
+    BENCH_BACKEND_SPI,
+} bench_backend_t;
+
+typedef struct bench_ctx bench_ctx_t;
+
+typedef struct {
+    const char *name;
+    bench_backend_t backend;
+    void (*run)(bench_ctx_t *ctx);
+} bench_op_t;
+
+struct bench_ctx {
+    uint32_t leds;
+    led_color_component_format_t fmt;
+    uint8_t bytes_per_pixel;
+    led_strip_handle_t strip;
+    uint8_t *colors;               // leds * bytes_per_pixel color bytes in strip order
+    uint8_t *spi_buf;              // SPI bit patterns of `colors`
+    rmt_channel_handle_t rmt_chan; // encoder benchmarks
+    rmt_encoder_handle_t encoder;
+    const void *payload;
+    size_t payload_bytes;
+    uint32_t seq;                  // changes the drawn colors between iterations
+};
+
+static struct {
+    int runs;
+    int warmup;
+    uint32_t sample_us;
+    bool json;
+    const char *ops;
+    const char *fmts;
+    uint32_t lengths[16];
+    int num_lengths;
+} s_opts = {
+    .runs = 15,
+    .warmup = 2,
+    .sample_us = 2000,
+    .lengths = {64, 128, 256, 512, 1024, 2048, 4096},
+    .num_lengths = 7,
+};
+
+static void run_set_pixel(bench_ctx_t *ctx)
+{
+    uint32_t seq = ctx->seq++;
+    for (uint32_t i = 0; i < ctx->leds; i++) {
+        led_strip_set_pixel(ctx->strip, i, i + seq, (i >> 1) + seq, (i >> 2) + seq);
+    }
+}
+
+static void run_clear(bench_ctx_t *ctx)
+{
+    led_strip_clear(ctx->strip);
+}
+
+// the application draws one pixel per frame straight into the attached buffer, as a mostly static matrix does
+static void run_attached_refresh(bench_ctx_t *ctx)
+{
+    uint32_t index = ctx->seq++ % ctx->leds;
+    ctx->colors[index * ctx->bytes_per_pixel]++;
+    led_strip_refresh(ctx->strip);
+}
+
+// same, but the changed pixel is reported, so the symbol cache re-encodes only that one
+static void run_marked_refresh(bench_ctx_t *ctx)
+{
+    uint32_t index = ctx->seq++ % ctx->leds;
+    ctx->colors[index * ctx->bytes_per_pixel]++;
+    led_strip_mark_changed(ctx->strip, index, 1);
+    led_strip_refresh(ctx->strip);
+}
+
+static void run_spi_bit(bench_ctx_t *ctx)
+{
+    bench_spi_bit(ctx->colors, ctx->leds * ctx->bytes_per_pixel, ctx->spi_buf);
+}
+
+static void run_encode(bench_ctx_t *ctx)
+{
+    bench_rmt_run_encoder(ctx->rmt_chan, ctx->encoder, ctx->payload, ctx->payload_bytes);
+}
+
+static const bench_op_t s_ops[] = {
+    {"rmt_set_pixel", BENCH_BACKEND_RMT, run_set_pixel},
+    {"rmt_cache_set_pixel", BENCH_BACKEND_RMT_CACHE, run_set_pixel},
+    {"spi_set_pixel", BENCH_BACKEND_SPI, run_set_pixel},
+    {"spi_bit", BENCH_BACKEND_SPI, run_spi_bit},
+    // clear = zero the pixel buffer + a full refresh through the stubbed driver (encoding included for RMT)
+    {"rmt_clear", BENCH_BACKEND_RMT, run_clear},
+    {"rmt_cache_clear", BENCH_BACKEND_RMT_CACHE, run_clear},
+    {"spi_clear", BENCH_BACKEND_SPI, run_clear},
+    // refresh of an attached buffer with one changed pixel, without and with led_strip_mark_changed
+    {"rmt_cache_attached_refresh", BENCH_BACKEND_RMT_CACHE, run_attached_refresh},
+    {"rmt_cache_marked_refresh", BENCH_BACKEND_RMT_CACHE, run_marked_refresh},
+    // rmt_encode_led_strip on its own: color bytes through the bytes encoder, or pre-encoded symbols through the copy encoder
+    {"rmt_encode", BENCH_BACKEND_RMT, run_encode},
+    {"rmt_cache_encode", BENCH_BACKEND_RMT_CACHE, run_encode},
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    uint32_t iters;
+    double median;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+} bench_stats_t;
+
+static uint64_t time_iters(bench_ctx_t *ctx, const bench_op_t *op, uint32_t iters)
+{
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        op->run(ctx);
+    }
+    return now_ns() - start;
+}
+
+static bench_stats_t measure(bench_ctx_t *ctx, const bench_op_t *op)
+{
+    bench_stats_t stats = {0};
+    // grow the iteration count until one sample lasts at least sample_us
+    uint32_t iters = 1;
+    uint64_t target_ns = (uint64_t)s_opts.sample_us * 1000;
+    uint64_t elapsed;
+    while ((elapsed = time_iters(ctx, op, iters)) < target_ns) {
+        uint64_t scale = elapsed ? (target_ns * 5 / 4) / elapsed : 16;
+        iters = iters * (scale < 2 ? 2 : scale > 16 ? 16 : scale);
+    }
+    for (int i = 0; i < s_opts.warmup; i++) {
+        time_iters(ctx, op, iters);
+    }
+
+    double samples[BENCH_MAX_RUNS];
+    double pixels = (double)iters * ctx->leds;
+    for (int i = 0; i < s_opts.runs; i++) {
+        samples[i] = time_iters(ctx, op, iters) / pixels;
+        stats.mean += samples[i];
+    }
+    stats.mean /= s_opts.runs;
+    for (int i = 0; i < s_opts.runs; i++) {
+        stats.stddev += (samples[i] - stats.mean) * (samples[i] - stats.mean);
+    }
+    stats.stddev = s_opts.runs > 1 ? sqrt(stats.stddev / (s_opts.runs - 1)) : 0;
+    qsort(samples, s_opts.runs, sizeof(double), cmp_double);
+    stats.iters = iters;
+    stats.median = samples[s_opts.runs / 2];
+    stats.min = samples[0];
+    stats.max = samples[s_opts.runs - 1];
+    return stats;
+}
+
+static void print_header(void)
+{
+    if (!s_opts.json) {
+        printf("version,op,fmt,leds,runs,iters,ns_per_pixel_median,ns_per_pixel_mean,ns_per_pixel_stddev,ns_per_pixel_min,ns_per_pixel_max\n");
+    }
+}
+
+static void print_result(const char *op, const char *fmt, uint32_t leds, const bench_stats_t *stats)
+{
+    if (s_opts.json) {
+        printf("{\"version\":\"%s\",\"op\":\"%s\",\"fmt\":\"%s\",\"leds\":%u,\"runs\":%d,\"iters\":%u,"
+               "\"ns_per_pixel\":{\"median\":%.3f,\"mean\":%.3f,\"stddev\":%.3f,\"min\":%.3f,\"max\":%.3f}}\n",
+               LED_STRIP_VERSION, op, fmt, leds, s_opts.runs, stats->iters,
+               stats->median, stats->mean, stats->stddev, stats->min, stats->max);
+    } else {
+        printf("%s,%s,%s,%u,%d,%u,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+               LED_STRIP_VERSION, op, fmt, leds, s_opts.runs, stats->iters,
+               stats->median, stats->mean, stats->stddev, stats->min, stats->max);
+    }
+    fflush(stdout);
+}
+
+static esp_err_t ctx_init(bench_ctx_t *ctx, const bench_op_t *op)
+{
+    bool use_cache = op->backend == BENCH_BACKEND_RMT_CACHE;
+    led_strip_config_t strip_config = {
+        .strip_gpio_num = 0,
+        .max_leds = ctx->leds,
+        .led_model = LED_MODEL_WS2812,
+        .color_component_format = ctx->fmt,
+    };
+    size_t num_bytes = ctx->leds * ctx->bytes_per_pixel;
+    ctx->colors = malloc(num_bytes);
+    ctx->spi_buf = malloc(num_bytes * 3);
+    if (!ctx->colors || !ctx->spi_buf) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < num_bytes; i++) {
+        ctx->colors[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    if (op->backend == BENCH_BACKEND_SPI) {
+        led_strip_spi_config_t spi_config = {
+            .spi_bus = SPI2_HOST,
+            .flags.with_dma = true,
+        };
+        return led_strip_new_spi_device(&strip_config, &spi_config, &ctx->strip);
+    }
+
+    led_strip_rmt_config_t rmt_config = {
+        .mem_block_symbols = BENCH_RMT_MEM_BLOCK_SYMBOLS,
+        .flags.use_symbol_cache = use_cache,
+    };
+    esp_err_t ret = led_strip_new_rmt_device(&strip_config, &rmt_config, &ctx->strip);
+    if (ret == ESP_OK && (op->run == run_attached_refresh || op->run == run_marked_refresh)) {
+        return led_strip_attach_buffer(ctx->strip, ctx->colors);
+    }
+    if (ret != ESP_OK || op->run != run_encode) {
+        return ret;
+    }
+
+    // a bare encoder on its own channel, fed the same data as the backend would
+    rmt_tx_channel_config_t chan_config = {
+        .mem_block_symbols = BENCH_RMT_MEM_BLOCK_SYMBOLS,
+        .resolution_hz = 10 * 1000 * 1000,
+    };
+    led_strip_encoder_config_t encoder_config = {
+        .resolution = chan_config.resolution_hz,
+        .led_model = LED_MODEL_WS2812,
+        .flags.pre_encoded = use_cache,
+    };
+    ESP_RETURN_ON_ERROR(rmt_new_tx_channel(&chan_config, &ctx->rmt_chan), "bench", "create channel failed");
+    ESP_RETURN_ON_ERROR(rmt_new_led_strip_encoder(&encoder_config, &ctx->encoder), "bench", "create encoder failed");
+    if (use_cache) {
+        rmt_symbol_word_t (*lut)[LED_STRIP_RMT_SYMBOLS_PER_BYTE] = malloc(256 * sizeof(*lut));
+        rmt_symbol_word_t *symbols = malloc(num_bytes * sizeof(*lut));
+        if (!lut || !symbols) {
+            free(lut);
+            free(symbols);
+            return ESP_ERR_NO_MEM;
+        }
+        rmt_led_strip_encoder_build_lut(&encoder_config, lut);
+        for (size_t i = 0; i < num_bytes; i++) {
+            memcpy(&symbols[i * LED_STRIP_RMT_SYMBOLS_PER_BYTE], lut[ctx->colors[i]], sizeof(*lut));
+        }
+        free(lut);
+        ctx->payload = symbols;
+        ctx->payload_bytes = num_bytes * sizeof(*lut);
+    } else {
+        ctx->payload = ctx->colors;
+        ctx->payload_bytes = num_bytes;
+    }
+
+    // the stub has to produce every symbol of the frame plus the reset code, or the numbers mean nothing
+    size_t expect = num_bytes * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1;
+    size_t got = bench_rmt_run_encoder(ctx->rmt_chan, ctx->encoder, ctx->payload, ctx->payload_bytes);
+    ESP_RETURN_ON_FALSE(got == expect, ESP_FAIL, "bench", "encoder produced %zu symbols, expect %zu", got, expect);
+    return ESP_OK;
+}
+
+static void ctx_deinit(bench_ctx_t *ctx)
+{
+    if (ctx->strip) {
+        led_strip_del(ctx->strip);
+    }
+    if (ctx->encoder) {
+        rmt_del_encoder(ctx->encoder);
+    }
+    if (ctx->rmt_chan) {
+        rmt_del_channel(ctx->rmt_chan);
+    }
+    if (ctx->payload != ctx->colors) {
+        free((void *)ctx->payload);
+    }
+    free(ctx->colors);
+    free(ctx->spi_buf);
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+// name of a format: the component letters in transmission order, e.g. GRB, GRBW
+static void fmt_name(led_color_component_format_t fmt, char *name)
+{
+    name[fmt.format.r_pos] = 'R';
+    name[fmt.format.g_pos] = 'G';
+    name[fmt.format.b_pos] = 'B';
+    if (fmt.format.num_components > 3) {
+        name[fmt.format.w_pos] = 'W';
+    }
+    name[fmt.format.num_components] = '\0';
+}
+
+// every order of 3 and 4 color components
+static int all_formats(led_color_component_format_t *fmts)
+{
+    int count = 0;
+    for (int num = 3; num <= 4; num++) {
+        for (int r = 0; r < num; r++) {
+            for (int g = 0; g < num; g++) {
+                for (int b = 0; b < num; b++) {
+                    int w = 6 - r - g - b;
+                    if (r == g || r == b || g == b || (num == 4 && (w == r || w == g || w == b || w > 3))) {
+                        continue;
+                    }
+                    fmts[count++] = (led_color_component_format_t) {
+                        .format = {.r_pos = r, .g_pos = g, .b_pos = b, .w_pos = num == 4 ? w : 3, .num_components = num}
+                    };
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// match a name against a comma separated list, NULL list matches everything
+static bool in_list(const char *list, const char *name)
+{
+    if (!list) {
+        return true;
+    }
+    size_t len = strlen(name);
+    for (const char *p = list; p; p = strchr(p, ',')) {
+        p += (*p == ',');
+        if (strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-j] [-r RUNS] [-t SAMPLE_US] [-n LEN,LEN...] [-o OP,OP...] [-f FMT,FMT...] [-l]\n"
+            "  -j  JSON lines instead of CSV\n"
+            "  -r  samples per case (default %d, max %d)\n"
+            "  -t  minimum duration of one sample in us (default %u)\n"
+            "  -n  strip lengths (default 64,128,256,512,1024,2048,4096)\n"
+            "  -o  only these ops, -f only these formats (e.g. GRB,RGBW)\n"
+            "  -l  list ops and formats\n",
+            prog, s_opts.runs, BENCH_MAX_RUNS, (unsigned)s_opts.sample_us);
+}
+
+int main(int argc, char **argv)
+{
+    led_color_component_format_t fmts[30];
+    int num_fmts = all_formats(fmts);
+    char name[5];
+
+    int opt;
+    while ((opt = getopt(argc, argv, "jr:t:n:o:f:lh")) != -1) {
+        switch (opt) {
+        case 'j':
+            s_opts.json = true;
+            break;
+        case 'r':
+            s_opts.runs = atoi(optarg);
+            break;
+        case 't':
+            s_opts.sample_us = strtoul(optarg, NULL, 0);
+            break;
+        case 'n':
+            s_opts.num_lengths = 0;
+            for (char *tok = strtok(optarg, ","); tok && s_opts.num_lengths < 16; tok = strtok(NULL, ",")) {
+                s_opts.lengths[s_opts.num_lengths++] = strtoul(tok, NULL, 0);
+            }
+            break;
+        case 'o':
+            s_opts.ops = optarg;
+            break;
+        case 'f':
+            s_opts.fmts = optarg;
+            break;
+        case 'l':
+            for (size_t i = 0; i < sizeof(s_ops) / sizeof(s_ops[0]); i++) {
+                printf("op %s\n", s_ops[i].name);
+            }
+            for (int i = 0; i < num_fmts; i++) {
+                fmt_name(fmts[i], name);
+                printf("fmt %s\n", name);
+            }
+            return 0;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (s_opts.runs < 1 || s_opts.runs > BENCH_MAX_RUNS || s_opts.num_lengths == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    print_header();
+    int failed = 0;
+    for (size_t o = 0; o < sizeof(s_ops) / sizeof(s_ops[0]); o++) {
+        const bench_op_t *op = &s_ops[o];
+        if (!in_list(s_opts.ops, op->name)) {
+            continue;
+        }
+        for (int f = 0; f < num_fmts; f++) {
+            fmt_name(fmts[f], name);
+            if (!in_list(s_opts.fmts, name)) {
+                continue;
+            }
+            for (int l = 0; l < s_opts.num_lengths; l++) {
+                bench_ctx_t ctx = {
+                    .leds = s_opts.lengths[l],
+                    .fmt = fmts[f],
+                    .bytes_per_pixel = fmts[f].format.num_components,
+                };
+                if (ctx_init(&ctx, op) != ESP_OK) {
+                    fprintf(stderr, "%s %s %u: setup failed\n", op->name, name, ctx.leds);
+                    failed++;
+                } else {
+                    bench_stats_t stats = measure(&ctx, op);
+                    print_result(op->name, name, ctx.leds, &stats);
+                }
+                ctx_deinit(&ctx);
+            }
+        }
+    }
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// Host test of the symbol cache encoding, built against the stubbed RMT driver (see bench_stubs.c).
+// For every LED model, all 256 byte values encoded through the lookup table of `rmt_led_strip_encoder_build_lut`
+// must give exactly the symbols of the reference bit expansion done by the bytes encoder: table entry by entry,
+// as a pre-encoded stream sent by the copy encoder, and through whole RMT strips with and without the symbol
+// cache (including pixels re-encoded after a change). Then prints the ns/pixel of both paths for a full refresh.
+//   ./bench/build/led_strip_encoder_test
+// Exit status 0 when every check passes, 1 otherwise.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include "led_strip.h"
+#include "led_strip_rmt_encoder.h"
+#include "led_strip_rmt_dev.h"
+#include "driver/rmt_tx.h"
+#include "bench_stubs.h"
+
+#define TEST_RESOLUTION_HZ      (10 * 1000 * 1000)
+#define TEST_MEM_BLOCK_SYMBOLS  48          // same as the RMT backend default on ESP32-C3/S3
+#define TEST_STRIP_LEDS         86          // 258 color bytes: every byte value, across many memory blocks
+#define TEST_BENCH_LEDS         1024
+#define TEST_BENCH_REPS         200
+
+static int s_failures;
+
+static void expect(bool ok, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    printf("  ");
+    vprintf(fmt, args);
+    printf(": %s\n", ok ? "ok" : "FAIL");
+    va_end(args);
+    if (!ok) {
+        s_failures++;
+    }
+}
+
+static const struct {
+    led_model_t model;
+    const char *name;
+} s_models[] = {
+    {LED_MODEL_WS2812, "WS2812"},
+    {LED_MODEL_SK6812, "SK6812"},
+    {LED_MODEL_WS2811, "WS2811"},
+};
+
+// run a fresh led strip encoder over the payload on its own channel, return the number of symbols sent
+static size_t encode(const led_strip_encoder_config_t *config, const void *payload, size_t payload_bytes,
+                     rmt_symbol_word_t *out, size_t max_symbols)
+{
+    rmt_tx_channel_config_t chan_config = {
+        .mem_block_symbols = TEST_MEM_BLOCK_SYMBOLS,
+        .resolution_hz = config->resolution,
+    };
+    rmt_channel_handle_t chan = NULL;
+    rmt_encoder_handle_t encoder = NULL;
+    if (rmt_new_tx_channel(&chan_config, &chan) != ESP_OK || rmt_new_led_strip_encoder(config, &encoder) != ESP_OK) {
+        printf("  cannot create the channel or encoder\n");
+        exit(1);
+    }
+    bench_rmt_capture(chan, out, max_symbols);
+    bench_rmt_run_encoder(chan, encoder, payload, payload_bytes);
+    size_t n = bench_rmt_captured(chan);
+    rmt_del_encoder(encoder);
+    rmt_del_channel(chan);
+    return n;
+}
+
+static void test_lut(led_model_t model, const char *name)
+{
+    static rmt_symbol_word_t ref[256 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1];
+    static rmt_symbol_word_t got[256 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1];
+    static rmt_symbol_word_t symbols[256 * LED_STRIP_RMT_SYMBOLS_PER_BYTE];
+    static rmt_symbol_word_t lut[256][LED_STRIP_RMT_SYMBOLS_PER_BYTE];
+    uint8_t values[256];
+    for (int i = 0; i < 256; i++) {
+        values[i] = i;
+    }
+
+    led_strip_encoder_config_t config = {
+        .resolution = TEST_RESOLUTION_HZ,
+        .led_model = model,
+    };
+    size_t ref_len = encode(&config, values, sizeof(values), ref, sizeof(ref) / sizeof(ref[0]));
+    expect(ref_len == sizeof(ref) / sizeof(ref[0]), "%s: bytes encoder sends 8 symbols per byte and the reset code", name);
+
+    expect(rmt_led_strip_encoder_build_lut(&config, lut) == ESP_OK, "%s: build the table", name);
+    int mismatches = 0;
+    for (int value = 0; value < 256; value++) {
+        for (int bit = 0; bit < LED_STRIP_RMT_SYMBOLS_PER_BYTE; bit++) {
+            if (lut[value][bit].val != ref[value * LED_STRIP_RMT_SYMBOLS_PER_BYTE + bit].val) {
+                if (mismatches++ == 0) {
+                    printf("  first mismatch: byte 0x%02x bit %d, table 0x%08x, reference 0x%08x\n", value, bit,
+                           (unsigned)lut[value][bit].val, (unsigned)ref[value * LED_STRIP_RMT_SYMBOLS_PER_BYTE + bit].val);
+                }
+            }
+        }
+    }
+    expect(mismatches == 0, "%s: all 256 table entries equal the reference expansion", name);
+
+    // the symbol cache payload: table lookups, sent by the copy encoder, followed by the same reset code
+    for (int value = 0; value < 256; value++) {
+        memcpy(&symbols[value * LED_STRIP_RMT_SYMBOLS_PER_BYTE], lut[values[value]], sizeof(lut[0]));
+    }
+    config.flags.pre_encoded = 1;
+    size_t got_len = encode(&config, symbols, sizeof(symbols), got, sizeof(got) / sizeof(got[0]));
+    expect(got_len == ref_len && memcmp(got, ref, ref_len * sizeof(ref[0])) == 0,
+           "%s: pre-encoded stream equals the reference stream", name);
+}
+
+static led_strip_handle_t new_strip(led_model_t model, uint32_t leds, bool use_symbol_cache)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = leds,
+        .led_model = model,
+        .color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRB,
+    };
+    led_strip_rmt_config_t rmt_config = {
+        .resolution_hz = TEST_RESOLUTION_HZ,
+        .mem_block_symbols = TEST_MEM_BLOCK_SYMBOLS,
+        .flags.use_symbol_cache = use_symbol_cache,
+    };
+    led_strip_handle_t strip = NULL;
+    if (led_strip_new_rmt_device(&strip_config, &rmt_config, &strip) != ESP_OK) {
+        printf("  cannot create the strip\n");
+        exit(1);
+    }
+    return strip;
+}
+
+// refresh the strip and return what its channel sent
+static size_t refresh_captured(led_strip_handle_t strip, rmt_symbol_word_t *out, size_t max_symbols)
+{
+    rmt_channel_handle_t chan = NULL;
+    led_strip_rmt_get_channel(strip, &chan);
+    bench_rmt_capture(chan, out, max_symbols);
+    led_strip_refresh(strip);
+    size_t n = bench_rmt_captured(chan);
+    bench_rmt_capture(chan, NULL, 0);
+    return n;
+}
+
+static bool strips_send_the_same(led_strip_handle_t plain, led_strip_handle_t cached)
+{
+    static rmt_symbol_word_t ref[TEST_STRIP_LEDS * 3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1];
+    static rmt_symbol_word_t got[TEST_STRIP_LEDS * 3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1];
+    size_t ref_len = refresh_captured(plain, ref, sizeof(ref) / sizeof(ref[0]));
+    size_t got_len = refresh_captured(cached, got, sizeof(got) / sizeof(got[0]));
+    return ref_len == sizeof(ref) / sizeof(ref[0]) && got_len == ref_len && memcmp(got, ref, ref_len * sizeof(ref[0])) == 0;
+}
+
+static void test_strip(led_model_t model, const char *name)
+{
+    led_strip_handle_t plain = new_strip(model, TEST_STRIP_LEDS, false);
+    led_strip_handle_t cached = new_strip(model, TEST_STRIP_LEDS, true);
+    uint8_t colors[TEST_STRIP_LEDS * 3];
+    for (size_t i = 0; i < sizeof(colors); i++) {
+        colors[i] = i;
+    }
+    led_color_component_format_t native_fmt = {0};
+    led_strip_set_pixels(plain, 0, colors, TEST_STRIP_LEDS, native_fmt);
+    led_strip_set_pixels(cached, 0, colors, TEST_STRIP_LEDS, native_fmt);
+    expect(strips_send_the_same(plain, cached), "%s: symbol cache strip sends the same symbols as the plain strip", name);
+
+    // only the changed pixels are re-encoded, the rest comes from the cache
+    for (uint32_t i = 0; i < TEST_STRIP_LEDS; i += 7) {
+        led_strip_set_pixel(plain, i, 255 - i, i ^ 0x5a, i * 3);
+        led_strip_set_pixel(cached, i, 255 - i, i ^ 0x5a, i * 3);
+    }
+    expect(strips_send_the_same(plain, cached), "%s: same symbols after changing some pixels", name);
+
+    led_strip_del(plain);
+    led_strip_del(cached);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// full refresh with every pixel changed: re-encode the whole strip and send it
+static double refresh_ns_per_pixel(bool use_symbol_cache)
+{
+    led_strip_handle_t strip = new_strip(LED_MODEL_WS2812, TEST_BENCH_LEDS, use_symbol_cache);
+    static uint8_t colors[TEST_BENCH_LEDS * 3];
+    led_color_component_format_t native_fmt = {0};
+    double start = now_ns();
+    for (int rep = 0; rep < TEST_BENCH_REPS; rep++) {
+        for (size_t i = 0; i < sizeof(colors); i++) {
+            colors[i] = i * 37 + rep;
+        }
+        led_strip_set_pixels(strip, 0, colors, TEST_BENCH_LEDS, native_fmt);
+        led_strip_refresh(strip);
+    }
+    double ns = (now_ns() - start) / TEST_BENCH_REPS / TEST_BENCH_LEDS;
+    led_strip_del(strip);
+    return ns;
+}
+
+int main(void)
+{
+    for (size_t i = 0; i < sizeof(s_models) / sizeof(s_models[0]); i++) {
+        printf("%s\n", s_models[i].name);
+        test_lut(s_models[i].model, s_models[i].name);
+        test_strip(s_models[i].model, s_models[i].name);
+    }
+
+    printf("full refresh, WS2812 GRB, %d LEDs, every pixel changed:\n", TEST_BENCH_LEDS);
+    printf("  bit expansion (bytes encoder)       %8.3f ns/pixel\n", refresh_ns_per_pixel(false));
+    printf("  lookup table (symbol cache)         %8.3f ns/pixel\n", refresh_ns_per_pixel(true));
+
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// Host test of the multi-channel RMT strip, built against the stubbed RMT driver and sync manager (see bench_stubs.c).
+// Every LED gets a color of its own; the symbols each channel sends are decoded back to LEDs, so the test sees
+// which LEDs went out on which GPIO. For lengths that divide evenly across the channels and lengths that don't,
+// with and without the symbol cache:
+//   - the segments are contiguous, in GPIO order, and the first `max_leds % num_channels` take one more LED;
+//   - set_pixel and set_pixels across segment boundaries land on the right LED;
+//   - a partial refresh sends the front of every segment below `num_leds`, the first LED of the segments past it,
+//     and every channel is loaded so the sync manager starts the transfer.
+//   ./bench/build/led_strip_multi_test
+// Exit status 0 when every check passes, 1 otherwise.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "led_strip.h"
+#include "led_strip_rmt_encoder.h"
+#include "driver/rmt_tx.h"
+#include "bench_stubs.h"
+
+#define TEST_RESOLUTION_HZ      (10 * 1000 * 1000)
+#define TEST_MEM_BLOCK_SYMBOLS  48
+#define TEST_MAX_LEDS           200
+#define TEST_FIRST_GPIO         4
+
+static int s_failures;
+static rmt_symbol_word_t s_bit0;
+static rmt_symbol_word_t s_bit1;
+
+static void expect(bool ok, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    printf("  ");
+    vprintf(fmt, args);
+    printf(": %s\n", ok ? "ok" : "FAIL");
+    va_end(args);
+    if (!ok) {
+        s_failures++;
+    }
+}
+
+// color of LED `index` in the given frame, different for every LED of the strip and every frame
+static void led_color(uint32_t index, uint32_t frame, uint8_t rgb[3])
+{
+    rgb[0] = index;
+    rgb[1] = 255 - index;
+    rgb[2] = frame * 16 + 1;
+}
+
+typedef struct {
+    uint32_t leds;              // LEDs sent by the channel, -1 if the symbols are not a whole number of LEDs
+    uint32_t first;             // strip index of the first LED sent
+    bool in_order;              // the LEDs are consecutive strip indices
+    uint32_t frame;             // frame of the first LED sent
+} sent_t;
+
+// decode the GRB bytes a channel sent back to strip indices and frames
+static sent_t decode(const rmt_symbol_word_t *symbols, size_t num_symbols)
+{
+    sent_t sent = { .leds = (uint32_t)-1 };
+    if (num_symbols == 0 || (num_symbols - 1) % (3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE)) {
+        return sent;
+    }
+    sent.leds = (num_symbols - 1) / (3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE);
+    sent.in_order = true;
+    for (uint32_t i = 0; i < sent.leds; i++) {
+        uint8_t grb[3] = {0};
+        for (int b = 0; b < 3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE; b++) {
+            rmt_symbol_word_t s = symbols[i * 3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + b];
+            if (s.val != s_bit0.val && s.val != s_bit1.val) {
+                sent.leds = (uint32_t)-1;
+                return sent;
+            }
+            grb[b / 8] = grb[b / 8] << 1 | (s.val == s_bit1.val);
+        }
+        uint32_t index = grb[1];
+        if (grb[0] != (uint8_t)(255 - index)) {
+            sent.in_order = false;
+        }
+        if (i == 0) {
+            sent.first = index;
+            sent.frame = grb[2] / 16;
+        } else if (index != (uint8_t)(sent.first + i)) {
+            sent.in_order = false;
+        }
+    }
+    return sent;
+}
+
+typedef struct {
+    uint32_t leds;
+    size_t channels;
+    bool use_symbol_cache;
+    led_strip_handle_t strip;
+    rmt_channel_handle_t chan[4];
+    rmt_symbol_word_t *capture[4];
+    uint32_t seg_start[4];      // expected split
+    uint32_t seg_len[4];
+} multi_ctx_t;
+
+static void capture_start(multi_ctx_t *ctx)
+{
+    size_t max_symbols = TEST_MAX_LEDS * 3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1;
+    for (size_t i = 0; i < ctx->channels; i++) {
+        bench_rmt_capture(ctx->chan[i], ctx->capture[i], max_symbols);
+    }
+}
+
+// draw the given frame on the front `num_leds` LEDs
+static void set_frame(multi_ctx_t *ctx, uint32_t frame, uint32_t num_leds, bool per_pixel)
+{
+    static uint8_t rgb[TEST_MAX_LEDS * 3];
+    for (uint32_t i = 0; i < num_leds; i++) {
+        led_color(i, frame, &rgb[i * 3]);
+        if (per_pixel) {
+            led_strip_set_pixel(ctx->strip, i, rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+    }
+    if (!per_pixel) {
+        // in two calls, both crossing segment boundaries on a whole strip
+        uint32_t half = (num_leds + 1) / 2;
+        led_strip_set_pixels(ctx->strip, 0, rgb, half, LED_STRIP_COLOR_COMPONENT_FMT_RGB);
+        led_strip_set_pixels(ctx->strip, half, rgb + half * 3, num_leds - half, LED_STRIP_COLOR_COMPONENT_FMT_RGB);
+    }
+}
+
+// refresh the front `num_leds` and check what every channel sent
+static bool refresh_sends(multi_ctx_t *ctx, uint32_t num_leds, uint32_t frame, uint32_t old_frame)
+{
+    bool ok = true;
+    capture_start(ctx);
+    esp_err_t err = num_leds == ctx->leds ? led_strip_refresh(ctx->strip) :
+                    led_strip_refresh_partial_async(ctx->strip, num_leds);
+    if (err == ESP_OK) {
+        err = led_strip_wait_refresh_done(ctx->strip, -1);
+    }
+    if (err != ESP_OK) {
+        printf("  refresh of %u LEDs failed: 0x%x\n", (unsigned)num_leds, err);
+        return false;
+    }
+    for (size_t i = 0; i < ctx->channels; i++) {
+        uint32_t start = ctx->seg_start[i];
+        uint32_t expect_leds = num_leds > start ? num_leds - start : 0;
+        if (expect_leds > ctx->seg_len[i]) {
+            expect_leds = ctx->seg_len[i];
+        }
+        // the segments past num_leds still send their first LED, with the frame it already shows
+        uint32_t expect_frame = expect_leds ? frame : old_frame;
+        if (expect_leds == 0 && ctx->channels > 1) {
+            expect_leds = 1;
+        }
+        sent_t sent = decode(ctx->capture[i], bench_rmt_captured(ctx->chan[i]));
+        bool seg_ok = sent.leds == expect_leds &&
+                      (expect_leds == 0 || (sent.first == start && sent.in_order && sent.frame == expect_frame));
+        if (!seg_ok) {
+            printf("  GPIO %d: sent %d LEDs from %u (frame %u), expected %u from %u (frame %u)\n", TEST_FIRST_GPIO + (int)i,
+                   (int)sent.leds, (unsigned)sent.first, (unsigned)sent.frame, (unsigned)expect_leds, (unsigned)start,
+                   (unsigned)expect_frame);
+            ok = false;
+        }
+        if (bench_rmt_waits_for_sync(ctx->chan[i])) {
+            printf("  GPIO %d still waits for the sync manager\n", TEST_FIRST_GPIO + (int)i);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static void test_multi(uint32_t leds, size_t channels, bool use_symbol_cache)
+{
+    multi_ctx_t ctx = {
+        .leds = leds,
+        .channels = channels,
+        .use_symbol_cache = use_symbol_cache,
+    };
+    const char *mode = use_symbol_cache ? "symbol cache" : "bytes encoder";
+    printf("%u LEDs on %d channels, %s\n", (unsigned)leds, (int)channels, mode);
+
+    int gpio_nums[4] = {0};
+    for (size_t i = 0; i < channels; i++) {
+        gpio_nums[i] = TEST_FIRST_GPIO + i;
+    }
+    led_strip_config_t strip_config = {
+        .max_leds = leds,
+        .led_model = LED_MODEL_WS2812,
+        .color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRB,
+    };
+    led_strip_rmt_config_t rmt_config = {
+        .resolution_hz = TEST_RESOLUTION_HZ,
+        .mem_block_symbols = TEST_MEM_BLOCK_SYMBOLS,
+        .flags.use_symbol_cache = use_symbol_cache,
+    };
+    if (led_strip_new_rmt_multi_device(&strip_config, &rmt_config, gpio_nums, channels, &ctx.strip) != ESP_OK) {
+        expect(false, "create the strip");
+        return;
+    }
+
+    // the documented split: even shares, the first `leds % channels` segments one LED longer
+    uint32_t start = 0;
+    bool channels_ok = true;
+    for (size_t i = 0; i < channels; i++) {
+        ctx.seg_start[i] = start;
+        ctx.seg_len[i] = leds / channels + (i < leds % channels ? 1 : 0);
+        start += ctx.seg_len[i];
+        ctx.chan[i] = bench_rmt_find_channel(gpio_nums[i]);
+        ctx.capture[i] = malloc((TEST_MAX_LEDS * 3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1) * sizeof(rmt_symbol_word_t));
+        channels_ok &= ctx.chan[i] && ctx.capture[i];
+    }
+    expect(channels_ok, "one RMT channel per GPIO");
+    if (!channels_ok) {
+        exit(1);
+    }
+
+    set_frame(&ctx, 1, leds, true);
+    expect(refresh_sends(&ctx, leds, 1, 0), "set_pixel: every segment sends its own LEDs, in GPIO order");
+
+    set_frame(&ctx, 2, leds, false);
+    expect(refresh_sends(&ctx, leds, 2, 1), "set_pixels across segment boundaries");
+
+    // front of the strip only: inside the first segment, on a boundary, one past it, and the whole strip minus one
+    uint32_t cuts[] = {1, ctx.seg_len[0], ctx.seg_len[0] + 1, leds - 1};
+    uint32_t frame = 2;
+    for (size_t c = 0; c < sizeof(cuts) / sizeof(cuts[0]); c++) {
+        if (cuts[c] == 0 || cuts[c] > leds) {
+            continue;
+        }
+        // a whole frame first, then only the front changes, as the partial refresh requires
+        set_frame(&ctx, ++frame, leds, false);
+        expect(refresh_sends(&ctx, leds, frame, frame - 1), "full refresh");
+        set_frame(&ctx, ++frame, cuts[c], false);
+        expect(refresh_sends(&ctx, cuts[c], frame, frame - 1), "partial refresh of %u LEDs", (unsigned)cuts[c]);
+    }
+
+    // clear refreshes by itself: every channel sends its whole segment, all bits zero
+    capture_start(&ctx);
+    bool cleared = led_strip_clear(ctx.strip) == ESP_OK;
+    for (size_t i = 0; i < channels; i++) {
+        size_t n = bench_rmt_captured(ctx.chan[i]);
+        cleared &= n == ctx.seg_len[i] * 3 * LED_STRIP_RMT_SYMBOLS_PER_BYTE + 1;
+        for (size_t s = 0; cleared && s + 1 < n; s++) {
+            cleared &= ctx.capture[i][s].val == s_bit0.val;
+        }
+    }
+    expect(cleared, "clear turns every segment off");
+
+    led_strip_del(ctx.strip);
+    for (size_t i = 0; i < channels; i++) {
+        free(ctx.capture[i]);
+    }
+}
+
+int main(void)
+{
+    rmt_symbol_word_t lut[256][LED_STRIP_RMT_SYMBOLS_PER_BYTE];
+    led_strip_encoder_config_t encoder_config = {
+        .resolution = TEST_RESOLUTION_HZ,
+        .led_model = LED_MODEL_WS2812,
+    };
+    if (rmt_led_strip_encoder_build_lut(&encoder_config, lut) != ESP_OK) {
+        printf("cannot build the symbol table\n");
+        return 1;
+    }
+    s_bit0 = lut[0x00][0];
+    s_bit1 = lut[0xff][0];
+
+    static const struct {
+        uint32_t leds;
+        size_t channels;
+    } cases[] = {
+        {64, 2},    // divides evenly
+        {64, 4},
+        {65, 4},    // one longer segment
+        {67, 4},    // three longer segments
+        {10, 3},
+        {4, 4},     // one LED per channel
+        {30, 1},    // single channel, no sync manager
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        test_multi(cases[i].leds, cases[i].channels, false);
+        test_multi(cases[i].leds, cases[i].channels, true);
+    }
+
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
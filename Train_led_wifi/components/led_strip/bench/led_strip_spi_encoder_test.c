@@ -0,0 +1,221 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+// Host test of the SPI bit encoder, built against the stubbed SPI driver (see bench_stubs.c).
+// `s_spi_encode_lut` replaced the per-bit encoder that OR-ed the SPI bits into a zeroed buffer; a copy of that
+// encoder is kept here as the reference. All 256 byte values must give the same 3 bytes through the table,
+// through the bulk `__led_strip_spi_encode`, and in the buffer a whole SPI strip sends after set_pixel,
+// set_pixel_rgbw, set_pixels (strip order and converted order) and clear, over buffers that held other data.
+//   ./bench/build/led_strip_spi_encoder_test
+// Exit status 0 when every check passes, 1 otherwise.
+// `__led_strip_spi_bit` and `__led_strip_spi_encode` are static, build the SPI backend into this unit to reach them
+#include "led_strip_spi_dev.c"
+#include <stdio.h>
+#include <stdarg.h>
+
+#define TEST_STRIP_LEDS 86          // 258 color bytes: every byte value
+
+static int s_failures;
+
+static void expect(bool ok, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    printf("  ");
+    vprintf(fmt, args);
+    printf(": %s\n", ok ? "ok" : "FAIL");
+    va_end(args);
+    if (!ok) {
+        s_failures++;
+    }
+}
+
+// the encoder before the lookup table, unchanged; the buffer must be zero-initialized
+static void legacy_spi_bit(uint8_t data, uint8_t *buf)
+{
+    // Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110
+    // So a color byte occupies 3 bytes of SPI.
+    *(buf + 2) |= data & BIT(0) ? BIT(2) | BIT(1) : BIT(2);
+    *(buf + 2) |= data & BIT(1) ? BIT(5) | BIT(4) : BIT(5);
+    *(buf + 2) |= data & BIT(2) ? BIT(7) : 0x00;
+    *(buf + 1) |= BIT(0);
+    *(buf + 1) |= data & BIT(3) ? BIT(3) | BIT(2) : BIT(3);
+    *(buf + 1) |= data & BIT(4) ? BIT(6) | BIT(5) : BIT(6);
+    *(buf + 0) |= data & BIT(5) ? BIT(1) | BIT(0) : BIT(1);
+    *(buf + 0) |= data & BIT(6) ? BIT(4) | BIT(3) : BIT(4);
+    *(buf + 0) |= data & BIT(7) ? BIT(7) | BIT(6) : BIT(7);
+}
+
+// reference SPI stream of color bytes already in the strip's order
+static void legacy_encode(const uint8_t *data, size_t len, uint8_t *buf)
+{
+    memset(buf, 0, len * SPI_BYTES_PER_COLOR_BYTE);
+    for (size_t i = 0; i < len; i++) {
+        legacy_spi_bit(data[i], buf + i * SPI_BYTES_PER_COLOR_BYTE);
+    }
+}
+
+static bool same_bytes(const uint8_t *got, const uint8_t *ref, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (got[i] != ref[i]) {
+            printf("  first mismatch: color byte %u, got %02x %02x %02x, reference %02x %02x %02x\n",
+                   (unsigned)(i / SPI_BYTES_PER_COLOR_BYTE), got[i - i % 3], got[i - i % 3 + 1], got[i - i % 3 + 2],
+                   ref[i - i % 3], ref[i - i % 3 + 1], ref[i - i % 3 + 2]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_table(void)
+{
+    uint8_t values[256];
+    uint8_t ref[256 * SPI_BYTES_PER_COLOR_BYTE];
+    uint8_t got[256 * SPI_BYTES_PER_COLOR_BYTE];
+    for (int i = 0; i < 256; i++) {
+        values[i] = i;
+    }
+    legacy_encode(values, sizeof(values), ref);
+
+    // stale content must be overwritten, the table path does not rely on a zeroed buffer
+    memset(got, 0xa5, sizeof(got));
+    for (int i = 0; i < 256; i++) {
+        __led_strip_spi_bit(values[i], got + i * SPI_BYTES_PER_COLOR_BYTE);
+    }
+    expect(same_bytes(got, ref, sizeof(ref)), "all 256 table entries equal the per-bit encoder");
+
+    memset(got, 0xff, sizeof(got));
+    __led_strip_spi_encode(values, sizeof(values), got);
+    expect(same_bytes(got, ref, sizeof(ref)), "bulk encoder equals the per-bit encoder");
+}
+
+static led_strip_handle_t new_strip(led_color_component_format_t format)
+{
+    led_strip_config_t strip_config = {
+        .max_leds = TEST_STRIP_LEDS,
+        .led_model = LED_MODEL_WS2812,
+        .color_component_format = format,
+    };
+    led_strip_spi_config_t spi_config = {
+        .spi_bus = SPI2_HOST,
+    };
+    led_strip_handle_t strip = NULL;
+    if (led_strip_new_spi_device(&strip_config, &spi_config, &strip) != ESP_OK) {
+        printf("  cannot create the strip\n");
+        exit(1);
+    }
+    return strip;
+}
+
+// refresh the strip and compare what the SPI transaction sends with the reference encoding of `colors`
+static bool sends(led_strip_handle_t strip, const uint8_t *colors, size_t len)
+{
+    static uint8_t ref[TEST_STRIP_LEDS * 4 * SPI_BYTES_PER_COLOR_BYTE];
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    if (led_strip_refresh(strip) != ESP_OK) {
+        return false;
+    }
+    legacy_encode(colors, len, ref);
+    return spi_strip->tx_trans.length == len * SPI_BYTES_PER_COLOR_BYTE * 8 &&
+           same_bytes(spi_strip->tx_trans.tx_buffer, ref, len * SPI_BYTES_PER_COLOR_BYTE);
+}
+
+static void test_strip_rgb(void)
+{
+    led_strip_handle_t strip = new_strip(LED_STRIP_COLOR_COMPONENT_FMT_GRB);
+    uint8_t native[TEST_STRIP_LEDS * 3];
+    uint8_t rgb[TEST_STRIP_LEDS * 3];
+    led_color_component_format_t native_fmt = {0};
+
+    for (size_t i = 0; i < sizeof(native); i++) {
+        native[i] = i;
+    }
+    led_strip_set_pixels(strip, 0, native, TEST_STRIP_LEDS, native_fmt);
+    expect(sends(strip, native, sizeof(native)), "GRB: set_pixels in strip order");
+
+    // every byte value again, on top of the previous frame: R, G, B through set_pixel
+    for (uint32_t i = 0; i < TEST_STRIP_LEDS; i++) {
+        uint8_t r = 255 - i, g = i * 3, b = i ^ 0x5a;
+        led_strip_set_pixel(strip, i, r, g, b);
+        native[i * 3 + 0] = g;
+        native[i * 3 + 1] = r;
+        native[i * 3 + 2] = b;
+    }
+    expect(sends(strip, native, sizeof(native)), "GRB: set_pixel over a drawn frame");
+
+    for (uint32_t i = 0; i < TEST_STRIP_LEDS; i++) {
+        rgb[i * 3 + 0] = i * 7;
+        rgb[i * 3 + 1] = i + 100;
+        rgb[i * 3 + 2] = 200 - i;
+        native[i * 3 + 0] = rgb[i * 3 + 1];
+        native[i * 3 + 1] = rgb[i * 3 + 0];
+        native[i * 3 + 2] = rgb[i * 3 + 2];
+    }
+    led_strip_set_pixels(strip, 0, rgb, TEST_STRIP_LEDS, LED_STRIP_COLOR_COMPONENT_FMT_RGB);
+    expect(sends(strip, native, sizeof(native)), "GRB: set_pixels converted from RGB");
+
+    led_strip_clear(strip);
+    memset(native, 0, sizeof(native));
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    uint8_t ref[sizeof(native) * SPI_BYTES_PER_COLOR_BYTE];
+    legacy_encode(native, sizeof(native), ref);
+    expect(same_bytes(spi_strip->tx_trans.tx_buffer, ref, sizeof(ref)), "GRB: clear");
+
+    led_strip_del(strip);
+}
+
+static void test_strip_rgbw(void)
+{
+    led_strip_handle_t strip = new_strip(LED_STRIP_COLOR_COMPONENT_FMT_GRBW);
+    uint8_t native[TEST_STRIP_LEDS * 4];
+    uint8_t rgb[TEST_STRIP_LEDS * 3];
+
+    for (uint32_t i = 0; i < TEST_STRIP_LEDS; i++) {
+        uint8_t r = i, g = i + 86, b = i + 172, w = 255 - i;
+        led_strip_set_pixel_rgbw(strip, i, r, g, b, w);
+        native[i * 4 + 0] = g;
+        native[i * 4 + 1] = r;
+        native[i * 4 + 2] = b;
+        native[i * 4 + 3] = w;
+    }
+    expect(sends(strip, native, sizeof(native)), "GRBW: set_pixel_rgbw");
+
+    // set_pixel turns the white component off
+    for (uint32_t i = 0; i < TEST_STRIP_LEDS; i += 5) {
+        led_strip_set_pixel(strip, i, 1, 2, 3);
+        native[i * 4 + 0] = 2;
+        native[i * 4 + 1] = 1;
+        native[i * 4 + 2] = 3;
+        native[i * 4 + 3] = 0;
+    }
+    expect(sends(strip, native, sizeof(native)), "GRBW: set_pixel over a drawn frame");
+
+    for (uint32_t i = 0; i < TEST_STRIP_LEDS; i++) {
+        rgb[i * 3 + 0] = i * 11;
+        rgb[i * 3 + 1] = i * 13;
+        rgb[i * 3 + 2] = i * 17;
+        native[i * 4 + 0] = rgb[i * 3 + 1];
+        native[i * 4 + 1] = rgb[i * 3 + 0];
+        native[i * 4 + 2] = rgb[i * 3 + 2];
+        native[i * 4 + 3] = 0;
+    }
+    led_strip_set_pixels(strip, 0, rgb, TEST_STRIP_LEDS, LED_STRIP_COLOR_COMPONENT_FMT_RGB);
+    expect(sends(strip, native, sizeof(native)), "GRBW: set_pixels converted from RGB");
+
+    led_strip_del(strip);
+}
+
+int main(void)
+{
+    printf("lookup table\n");
+    test_table();
+    printf("SPI strip, %d LEDs\n", TEST_STRIP_LEDS);
+    test_strip_rgb();
+    test_strip_rgbw();
+
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_rmt.h"
+#include "led_strip_spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set RGB for a specific pixel
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param red: red part of color
+ * @param green: green part of color
+ * @param blue: blue part of color
+ *
+ * @return
+ *      - ESP_OK: Set RGB for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGB for a specific pixel failed because of invalid parameters
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Set RGB for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
+
+/**
+ * @brief Set RGBW for a specific pixel
+ *
+ * @note Only call this function if your led strip does have the white component (e.g. SK6812-RGBW)
+ * @note Also see `led_strip_set_pixel` if you only want to specify the RGB part of the color and bypass the white component
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param red: red part of color
+ * @param green: green part of color
+ * @param blue: blue part of color
+ * @param white: separate white component
+ *
+ * @return
+ *      - ESP_OK: Set RGBW color for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGBW color for a specific pixel failed because of an invalid argument
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Set RGBW color for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white);
+
+/**
+ * @brief Set a range of pixels from a contiguous buffer
+ *
+ * @note The buffer is converted to the strip's color component order in one pass, and copied directly
+ *       if `src_format` already matches the strip's format.
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param pixels: packed pixel data, `count * src_format.format.num_components` bytes
+ * @param count: number of pixels to set
+ * @param src_format: color component order of `pixels` (e.g. `LED_STRIP_COLOR_COMPONENT_FMT_RGB`),
+ *                    format_id 0 means the data is already in the strip's own format
+ *
+ * @return
+ *      - ESP_OK: Set pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Set pixels failed because of invalid parameters
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Set pixels failed because other error occurred
+ */
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, const uint8_t *pixels, uint32_t count, led_color_component_format_t src_format);
+
+/**
+ * @brief Set HSV for a specific pixel
+ *
+ * @param strip: LED strip
+ * @param index: index of pixel to set
+ * @param hue: hue part of color (0 - 360)
+ * @param saturation: saturation part of color (0 - 255, rescaled from 0 - 1. e.g. saturation = 0.5, rescaled to 127)
+ * @param value: value part of color (0 - 255, rescaled from 0 - 1. e.g. value = 0.5, rescaled to 127)
+ *
+ * @return
+ *      - ESP_OK: Set HSV color for a specific pixel successfully
+ *      - ESP_ERR_INVALID_ARG: Set HSV color for a specific pixel failed because of an invalid argument
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Set HSV color for a specific pixel failed because other error occurred
+ */
+esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value);
+
+/**
+ * @brief Refresh memory colors to LEDs
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Refresh successfully
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ *
+ * @note:
+ *      After updating the LED colors in the memory, a following invocation of this API is needed to flush colors to strip.
+ */
+esp_err_t led_strip_refresh(led_strip_handle_t strip);
+
+/**
+ * @brief Start flushing memory colors to LEDs and return without waiting for the transfer to finish
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Refresh started successfully
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ *
+ * @note:
+ *      The current pixels are handed over to the backend as a whole frame, so it's safe to set pixels for the next
+ *      frame right after this function returns. If a previous transfer is still in progress, this function waits for
+ *      it to finish first. Backends without asynchronous support fall back to a blocking `led_strip_refresh`.
+ */
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip);
+
+/**
+ * @brief Like `led_strip_refresh_async`, but only transmit the first `num_leds` LEDs
+ *
+ * LEDs further down the chain don't receive new data and keep showing their current color,
+ * so this is only correct when nothing changed beyond `num_leds` since the last refresh.
+ *
+ * @param strip: LED strip
+ * @param num_leds: number of LEDs to transmit, counted from the start of the strip
+ *
+ * @return
+ *      - ESP_OK: Refresh started successfully
+ *      - ESP_ERR_INVALID_ARG: Refresh failed because of invalid parameters
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ *
+ * @note:
+ *      Backends without partial refresh support transmit the whole strip instead.
+ */
+esp_err_t led_strip_refresh_partial_async(led_strip_handle_t strip, uint32_t num_leds);
+
+/**
+ * @brief Wait for the transfer started by `led_strip_refresh_async` to finish
+ *
+ * @param strip: LED strip
+ * @param timeout_ms: timeout value, -1 means wait forever
+ *
+ * @return
+ *      - ESP_OK: No transfer pending, or the pending transfer finished
+ *      - ESP_ERR_TIMEOUT: The transfer didn't finish in time
+ *      - ESP_FAIL: Wait failed because some other error occurred
+ */
+esp_err_t led_strip_wait_refresh_done(led_strip_handle_t strip, int32_t timeout_ms);
+
+/**
+ * @brief Use an application buffer as the pixel memory of the strip
+ *
+ * The buffer replaces the driver's own pixel buffer: `set_pixel`, `set_pixels` and `clear` write into it,
+ * and the refresh functions transmit it directly, without copying it first. The application can also
+ * write pixels into it itself, in the strip's native color component order
+ * (`led_strip_config_t::color_component_format`, GRB by default).
+ *
+ * @param strip: LED strip
+ * @param pixels: `max_leds * num_components` bytes that stay valid until the strip is deleted or another buffer
+ *                is attached; NULL goes back to the driver's own pixel buffer
+ *
+ * @return
+ *      - ESP_OK: Buffer attached successfully
+ *      - ESP_ERR_INVALID_STATE: NULL was passed, but the strip was created without its own pixel buffer
+ *      - ESP_ERR_NOT_SUPPORTED: The backend doesn't transmit from pixel memory (e.g. SPI)
+ *      - ESP_FAIL: Attach failed because some other error occurred
+ *
+ * @note:
+ *      The buffer is the transmit source, so it must not be modified while a transfer is in progress:
+ *      call `led_strip_wait_refresh_done` before writing the next frame into it. With the RMT symbol cache
+ *      the buffer is re-encoded into the cache instead, and can be modified as soon as the refresh function returns.
+ *      The driver can't see the application's own writes, so it re-encodes every transmitted LED on each refresh,
+ *      unless the application reports what it changed with `led_strip_mark_changed`.
+ */
+esp_err_t led_strip_attach_buffer(led_strip_handle_t strip, uint8_t *pixels);
+
+/**
+ * @brief Report pixels that the application wrote directly into the attached buffer
+ *
+ * Only matters to backends that cache an encoded copy of the pixels (the RMT symbol cache): after the first call
+ * following `led_strip_attach_buffer`, a refresh only re-encodes the pixels reported here and those written through
+ * `set_pixel`, `set_pixels` or `clear`, instead of every transmitted LED. Pixels written into the buffer but not
+ * reported keep their previous colors on the strip.
+ *
+ * @param strip: LED strip
+ * @param start: index of the first changed pixel
+ * @param count: number of changed pixels
+ *
+ * @return
+ *      - ESP_OK: Pixels marked successfully, or the backend doesn't need to know
+ *      - ESP_ERR_INVALID_ARG: Mark failed because of invalid parameters
+ */
+esp_err_t led_strip_mark_changed(led_strip_handle_t strip, uint32_t start, uint32_t count);
+
+/**
+ * @brief Clear LED strip (turn off all LEDs)
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Clear LEDs successfully
+ *      - ESP_ERR_INVALID_STATE: No pixel buffer attached yet (RMT strip created with `external_buffer`)
+ *      - ESP_FAIL: Clear LEDs failed because some other error occurred
+ */
+esp_err_t led_strip_clear(led_strip_handle_t strip);
+
+/**
+ * @brief Free LED strip resources
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Free resources successfully
+ *      - ESP_FAIL: Free resources failed because error occurred
+ */
+esp_err_t led_strip_del(led_strip_handle_t strip);
+
+#ifdef __cplusplus
+}
+#endif
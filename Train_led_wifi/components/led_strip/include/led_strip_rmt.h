@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+#include "esp_idf_version.h"
+#include "driver/rmt_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief LED Strip RMT specific configuration
+ */
+typedef struct {
+    rmt_clock_source_t clk_src; /*!< RMT clock source */
+    uint32_t resolution_hz;     /*!< RMT tick resolution, if set to zero, a default resolution (10MHz) will be applied */
+    size_t mem_block_symbols;   /*!< How many RMT symbols can one RMT channel hold at one time. Set to 0 will fallback to use the default size. */
+    /*!< Extra RMT specific driver flags */
+    struct led_strip_rmt_extra_config {
+        uint32_t with_dma: 1;   /*!< Use DMA to transmit data */
+        uint32_t use_symbol_cache: 1; /*!< Keep the whole strip pre-encoded as RMT symbols and only re-encode changed pixels on refresh.
+                                           Cuts the encoding work done in the RMT ISR, at the cost of 32 bytes of RAM per color byte plus an 8KB lookup table */
+        uint32_t external_buffer: 1; /*!< Don't allocate the driver's two pixel buffers, the application provides the pixel memory
+                                          with `led_strip_attach_buffer` before setting pixels or refreshing */
+    } flags;                    /*!< Extra driver flags */
+} led_strip_rmt_config_t;
+
+/**
+ * @brief Create LED strip based on RMT TX channel
+ *
+ * @param led_config LED strip configuration
+ * @param rmt_config RMT specific configuration
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory
+ *      - ESP_FAIL: create LED strip handle failed because some other error
+ */
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip);
+
+/**
+ * @brief Create one LED strip driven by several RMT TX channels in parallel
+ *
+ * The `max_leds` LEDs of the strip are split evenly into consecutive segments, one per GPIO
+ * (the first segments take one more LED if the length is not divisible). Each segment is an RMT strip
+ * created by `led_strip_new_rmt_device`, and on targets with RMT TX synchronization the channels are
+ * added to a sync manager so that all segments start transmitting at the same time.
+ * The refresh time is then divided by the number of channels.
+ *
+ * @note `led_config->strip_gpio_num` is ignored, the GPIOs are taken from `gpio_nums`
+ * @note The number of channels is limited by the TX channels of the chip, e.g. 2 on ESP32-C3
+ *
+ * @param led_config LED strip configuration, `max_leds` is the total length
+ * @param rmt_config RMT specific configuration, applied to every channel
+ * @param gpio_nums GPIO of each segment, in strip order
+ * @param num_channels Number of segments (length of `gpio_nums`)
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory
+ *      - ESP_FAIL: create LED strip handle failed because some other error
+ */
+esp_err_t led_strip_new_rmt_multi_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                                         const int *gpio_nums, size_t num_channels, led_strip_handle_t *ret_strip);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "led_strip_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct led_strip_t led_strip_t; /*!< Type of LED strip */
+
+/**
+ * @brief LED strip interface definition
+ */
+struct led_strip_t {
+    /**
+     * @brief Set RGB for a specific pixel
+     *
+     * @param strip: LED strip
+     * @param index: index of pixel to set
+     * @param red: red part of color
+     * @param green: green part of color
+     * @param blue: blue part of color
+     *
+     * @return
+     *      - ESP_OK: Set RGB for a specific pixel successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGB for a specific pixel failed because of invalid parameters
+     *      - ESP_FAIL: Set RGB for a specific pixel failed because other error occurred
+     */
+    esp_err_t (*set_pixel)(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
+
+    /**
+     * @brief Set RGBW for a specific pixel. Similar to `set_pixel` but also set the white component
+     *
+     * @param strip: LED strip
+     * @param index: index of pixel to set
+     * @param red: red part of color
+     * @param green: green part of color
+     * @param blue: blue part of color
+     * @param white: separate white component
+     *
+     * @return
+     *      - ESP_OK: Set RGBW color for a specific pixel successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGBW color for a specific pixel failed because of an invalid argument
+     *      - ESP_FAIL: Set RGBW color for a specific pixel failed because other error occurred
+     */
+    esp_err_t (*set_pixel_rgbw)(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white);
+
+    /**
+     * @brief Set a range of pixels from a contiguous buffer
+     *
+     * @param strip: LED strip
+     * @param start: index of the first pixel to set
+     * @param pixels: packed pixel data, `count * src_format.format.num_components` bytes
+     * @param count: number of pixels to set
+     * @param src_format: color component order of `pixels`, format_id 0 means the strip's own format
+     *
+     * @return
+     *      - ESP_OK: Set pixels successfully
+     *      - ESP_ERR_INVALID_ARG: Set pixels failed because of invalid parameters
+     *      - ESP_FAIL: Set pixels failed because other error occurred
+     */
+    esp_err_t (*set_pixels)(led_strip_t *strip, uint32_t start, const uint8_t *pixels, uint32_t count, led_color_component_format_t src_format);
+
+    /**
+     * @brief Refresh memory colors to LEDs
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value for refreshing task
+     *
+     * @return
+     *      - ESP_OK: Refresh successfully
+     *      - ESP_FAIL: Refresh failed because some other error occurred
+     *
+     * @note:
+     *      After updating the LED colors in the memory, a following invocation of this API is needed to flush colors to strip.
+     */
+    esp_err_t (*refresh)(led_strip_t *strip);
+
+    /**
+     * @brief Start flushing memory colors to LEDs without waiting for the transfer to finish
+     *
+     * @param strip: LED strip
+     *
+     * @return
+     *      - ESP_OK: Refresh started successfully
+     *      - ESP_FAIL: Refresh failed because some other error occurred
+     *
+     * @note:
+     *      The pixels are snapshotted when the transfer is submitted, so the caller can keep updating pixels
+     *      for the next frame while the current one is being transmitted.
+     */
+    esp_err_t (*refresh_async)(led_strip_t *strip);
+
+    /**
+     * @brief Same as `refresh_async`, but only transmit the first `num_leds` LEDs
+     *
+     * @param strip: LED strip
+     * @param num_leds: number of LEDs to transmit, counted from the start of the strip
+     *
+     * @return
+     *      - ESP_OK: Refresh started successfully
+     *      - ESP_ERR_INVALID_ARG: Refresh failed because of invalid parameters
+     *      - ESP_FAIL: Refresh failed because some other error occurred
+     */
+    esp_err_t (*refresh_partial_async)(led_strip_t *strip, uint32_t num_leds);
+
+    /**
+     * @brief Wait for the transfer started by `refresh_async` to finish
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value, -1 means wait forever
+     *
+     * @return
+     *      - ESP_OK: No transfer pending, or the pending transfer finished
+     *      - ESP_ERR_TIMEOUT: The transfer didn't finish in time
+     *      - ESP_FAIL: Wait failed because some other error occurred
+     */
+    esp_err_t (*wait_refresh_done)(led_strip_t *strip, int32_t timeout_ms);
+
+    /**
+     * @brief Use an application buffer as pixel memory and transmit source
+     *
+     * @param strip: LED strip
+     * @param pixels: pixel buffer in the strip's native color order, NULL to use the driver's own buffer again
+     *
+     * @return
+     *      - ESP_OK: Buffer attached successfully
+     *      - ESP_ERR_INVALID_STATE: Attach failed because the strip has no own buffer to go back to
+     *      - ESP_FAIL: Attach failed because some other error occurred
+     */
+    esp_err_t (*attach_buffer)(led_strip_t *strip, uint8_t *pixels);
+
+    /**
+     * @brief Report pixels that the application changed in the attached buffer
+     *
+     * @param strip: LED strip
+     * @param start: index of the first changed pixel
+     * @param count: number of changed pixels
+     *
+     * @return
+     *      - ESP_OK: Pixels marked successfully
+     *      - ESP_ERR_INVALID_ARG: Mark failed because of invalid parameters
+     */
+    esp_err_t (*mark_changed)(led_strip_t *strip, uint32_t start, uint32_t count);
+
+    /**
+     * @brief Clear LED strip (turn off all LEDs)
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: timeout value for clearing task
+     *
+     * @return
+     *      - ESP_OK: Clear LEDs successfully
+     *      - ESP_FAIL: Clear LEDs failed because some other error occurred
+     */
+    esp_err_t (*clear)(led_strip_t *strip);
+
+    /**
+     * @brief Free LED strip resources
+     *
+     * @param strip: LED strip
+     *
+     * @return
+     *      - ESP_OK: Free resources successfully
+     *      - ESP_FAIL: Free resources failed because error occurred
+     */
+    esp_err_t (*del)(led_strip_t *strip);
+};
+
+#ifdef __cplusplus
+}
+#endif
@@ -16,6 +16,23 @@ esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t
     return strip->set_pixel(strip, index, red, green, blue);
 }
 
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, const uint8_t *pixels, uint32_t count, led_color_component_format_t src_format)
+{
+    ESP_RETURN_ON_FALSE(strip && pixels, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->set_pixels) {
+        return strip->set_pixels(strip, start, pixels, count, src_format);
+    }
+    // backend without bulk support, fall back to per-pixel update
+    ESP_RETURN_ON_FALSE(src_format.format_id, ESP_ERR_INVALID_ARG, TAG, "source format required");
+    uint8_t src_bytes = src_format.format.num_components;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *p = pixels + i * src_bytes;
+        ESP_RETURN_ON_ERROR(strip->set_pixel(strip, start + i, p[src_format.format.r_pos], p[src_format.format.g_pos], p[src_format.format.b_pos]),
+                            TAG, "set pixel failed");
+    }
+    return ESP_OK;
+}
+
 esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value)
 {
     ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
@@ -81,6 +98,50 @@ esp_err_t led_strip_refresh(led_strip_handle_t strip)
     return strip->refresh(strip);
 }
 
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (!strip->refresh_async) {
+        return strip->refresh(strip);
+    }
+    return strip->refresh_async(strip);
+}
+
+esp_err_t led_strip_refresh_partial_async(led_strip_handle_t strip, uint32_t num_leds)
+{
+    ESP_RETURN_ON_FALSE(strip && num_leds, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (!strip->refresh_partial_async) {
+        return led_strip_refresh_async(strip);
+    }
+    return strip->refresh_partial_async(strip, num_leds);
+}
+
+esp_err_t led_strip_wait_refresh_done(led_strip_handle_t strip, int32_t timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (!strip->wait_refresh_done) {
+        return ESP_OK;
+    }
+    return strip->wait_refresh_done(strip, timeout_ms);
+}
+
+esp_err_t led_strip_attach_buffer(led_strip_handle_t strip, uint8_t *pixels)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->attach_buffer, ESP_ERR_NOT_SUPPORTED, TAG, "backend can't transmit from an attached buffer");
+    return strip->attach_buffer(strip, pixels);
+}
+
+esp_err_t led_strip_mark_changed(led_strip_handle_t strip, uint32_t start, uint32_t count)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (!strip->mark_changed) {
+        // nothing cached, the next refresh reads the buffer anyway
+        return ESP_OK;
+    }
+    return strip->mark_changed(strip, start, count);
+}
+
 esp_err_t led_strip_clear(led_strip_handle_t strip)
 {
     ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
@@ -0,0 +1,418 @@
+/*
+ * SPDX-FileCopyrightText: 2022-2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "driver/rmt_tx.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_rmt_encoder.h"
+#include "led_strip_rmt_dev.h"
+
+#define LED_STRIP_RMT_DEFAULT_RESOLUTION 10000000 // 10MHz resolution
+#define LED_STRIP_RMT_DEFAULT_TRANS_QUEUE_SIZE 4
+// the memory size of each RMT channel, in words (4 bytes)
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 64
+#else
+#define LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS 48
+#endif
+
+static const char *TAG = "led_strip_rmt";
+
+typedef struct {
+    led_strip_t base;
+    rmt_channel_handle_t rmt_chan;
+    rmt_encoder_handle_t strip_encoder;
+    uint32_t strip_len;
+    uint8_t bytes_per_pixel;
+    led_color_component_format_t component_fmt;
+    bool tx_pending;   // a transaction has been submitted and not waited for yet
+    bool app_buffer;   // pixel_buf is attached by the application and transmitted in place
+    bool app_marks;    // the application reports its writes to the attached buffer with mark_changed
+    bool own_buffers;  // the two internal pixel buffers below have been allocated
+    uint8_t *pixel_buf; // buffer updated by set_pixel, NULL until attached with external_buffer
+    uint8_t *tx_buf;    // buffer owned by the RMT transaction, swapped with pixel_buf on every refresh
+    rmt_symbol_word_t *symbols; // symbol cache mode: the whole strip pre-encoded, sent by the copy encoder
+    rmt_symbol_word_t (*symbol_lut)[LED_STRIP_RMT_SYMBOLS_PER_BYTE]; // color byte -> RMT symbols
+    bool shared_lut;    // symbol_lut belongs to another strip (see led_strip_new_rmt_device_sharing_lut)
+    uint32_t *dirty;    // symbol cache mode: one bit per pixel that changed since the last encoding
+    uint8_t buffers[];
+} led_strip_rmt_obj;
+
+static inline void led_strip_rmt_mark_dirty(led_strip_rmt_obj *rmt_strip, uint32_t start, uint32_t count)
+{
+    if (!rmt_strip->dirty) {
+        return;
+    }
+    for (uint32_t index = start; index < start + count; index++) {
+        rmt_strip->dirty[index / 32] |= 1U << (index % 32);
+    }
+}
+
+// re-encode the pixels changed since the last refresh into the symbol cache
+static void led_strip_rmt_encode_dirty(led_strip_rmt_obj *rmt_strip)
+{
+    uint8_t bytes_per_pixel = rmt_strip->bytes_per_pixel;
+    size_t symbol_bytes = sizeof(rmt_symbol_word_t) * LED_STRIP_RMT_SYMBOLS_PER_BYTE;
+    for (uint32_t word = 0; word < (rmt_strip->strip_len + 31) / 32; word++) {
+        uint32_t bits = rmt_strip->dirty[word];
+        rmt_strip->dirty[word] = 0;
+        while (bits) {
+            uint32_t index = word * 32 + __builtin_ctz(bits);
+            bits &= bits - 1;
+            const uint8_t *pixel = rmt_strip->pixel_buf + index * bytes_per_pixel;
+            rmt_symbol_word_t *symbols = rmt_strip->symbols + index * bytes_per_pixel * LED_STRIP_RMT_SYMBOLS_PER_BYTE;
+            for (int i = 0; i < bytes_per_pixel; i++) {
+                memcpy(symbols, rmt_strip->symbol_lut[pixel[i]], symbol_bytes);
+                symbols += LED_STRIP_RMT_SYMBOLS_PER_BYTE;
+            }
+        }
+    }
+}
+
+static esp_err_t led_strip_rmt_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(index < rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(rmt_strip->pixel_buf, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+
+    led_color_component_format_t component_fmt = rmt_strip->component_fmt;
+    uint32_t start = index * rmt_strip->bytes_per_pixel;
+    uint8_t *pixel_buf = rmt_strip->pixel_buf;
+
+    pixel_buf[start + component_fmt.format.r_pos] = red & 0xFF;
+    pixel_buf[start + component_fmt.format.g_pos] = green & 0xFF;
+    pixel_buf[start + component_fmt.format.b_pos] = blue & 0xFF;
+    if (component_fmt.format.num_components > 3) {
+        pixel_buf[start + component_fmt.format.w_pos] = 0;
+    }
+    led_strip_rmt_mark_dirty(rmt_strip, index, 1);
+
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    led_color_component_format_t component_fmt = rmt_strip->component_fmt;
+    ESP_RETURN_ON_FALSE(index < rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(component_fmt.format.num_components == 4, ESP_ERR_INVALID_ARG, TAG, "led doesn't have 4 components");
+    ESP_RETURN_ON_FALSE(rmt_strip->pixel_buf, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+
+    uint32_t start = index * rmt_strip->bytes_per_pixel;
+    uint8_t *pixel_buf = rmt_strip->pixel_buf;
+
+    pixel_buf[start + component_fmt.format.r_pos] = red & 0xFF;
+    pixel_buf[start + component_fmt.format.g_pos] = green & 0xFF;
+    pixel_buf[start + component_fmt.format.b_pos] = blue & 0xFF;
+    pixel_buf[start + component_fmt.format.w_pos] = white & 0xFF;
+    led_strip_rmt_mark_dirty(rmt_strip, index, 1);
+
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_set_pixels(led_strip_t *strip, uint32_t start, const uint8_t *pixels, uint32_t count, led_color_component_format_t src_format)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(start <= rmt_strip->strip_len && count <= rmt_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(rmt_strip->pixel_buf, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+
+    led_color_component_format_t component_fmt = rmt_strip->component_fmt;
+    uint8_t bytes_per_pixel = rmt_strip->bytes_per_pixel;
+    uint8_t *dst = rmt_strip->pixel_buf + start * bytes_per_pixel;
+    led_strip_rmt_mark_dirty(rmt_strip, start, count);
+
+    // fast path: source is already in the native order
+    if (src_format.format_id == 0 || src_format.format_id == component_fmt.format_id) {
+        memcpy(dst, pixels, count * bytes_per_pixel);
+        return ESP_OK;
+    }
+
+    uint8_t src_bytes = src_format.format.num_components;
+    ESP_RETURN_ON_FALSE(src_bytes == 3 || src_bytes == 4, ESP_ERR_INVALID_ARG, TAG, "invalid number of source color components");
+    bool has_white = bytes_per_pixel > 3;
+    bool src_has_white = src_bytes > 3;
+    for (uint32_t i = 0; i < count; i++) {
+        dst[component_fmt.format.r_pos] = pixels[src_format.format.r_pos];
+        dst[component_fmt.format.g_pos] = pixels[src_format.format.g_pos];
+        dst[component_fmt.format.b_pos] = pixels[src_format.format.b_pos];
+        if (has_white) {
+            dst[component_fmt.format.w_pos] = src_has_white ? pixels[src_format.format.w_pos] : 0;
+        }
+        dst += bytes_per_pixel;
+        pixels += src_bytes;
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_wait_refresh_done(led_strip_t *strip, int32_t timeout_ms)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    if (!rmt_strip->tx_pending) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, timeout_ms), TAG, "flush RMT channel failed");
+    rmt_strip->tx_pending = false;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_refresh_partial_async(led_strip_t *strip, uint32_t num_leds)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(num_leds <= rmt_strip->strip_len, ESP_ERR_INVALID_ARG, TAG, "num_leds out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(rmt_strip->pixel_buf, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+    size_t buf_size = rmt_strip->strip_len * rmt_strip->bytes_per_pixel;
+    size_t tx_size = num_leds * rmt_strip->bytes_per_pixel;
+    rmt_transmit_config_t tx_conf = {
+        .loop_count = 0,
+    };
+
+    // the back buffer is still being read by the previous transaction
+    ESP_RETURN_ON_ERROR(led_strip_rmt_wait_refresh_done(strip, -1), TAG, "wait previous refresh failed");
+
+    if (rmt_strip->symbols) {
+        // the symbol cache is the transmit buffer, pixel_buf is never read by the hardware
+        if (rmt_strip->app_buffer && !rmt_strip->app_marks) {
+            // the application writes the attached buffer directly and doesn't say what it changed
+            led_strip_rmt_mark_dirty(rmt_strip, 0, num_leds);
+        }
+        led_strip_rmt_encode_dirty(rmt_strip);
+        ESP_RETURN_ON_ERROR(rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, rmt_strip->symbols,
+                                         tx_size * LED_STRIP_RMT_SYMBOLS_PER_BYTE * sizeof(rmt_symbol_word_t), &tx_conf),
+                            TAG, "transmit pixels by RMT failed");
+        rmt_strip->tx_pending = true;
+        return ESP_OK;
+    }
+
+    if (rmt_strip->app_buffer) {
+        // zero copy: the attached buffer is transmitted in place, the application waits for the transfer before reusing it
+        ESP_RETURN_ON_ERROR(rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, rmt_strip->pixel_buf,
+                                         tx_size, &tx_conf), TAG, "transmit pixels by RMT failed");
+        rmt_strip->tx_pending = true;
+        return ESP_OK;
+    }
+
+    uint8_t *frame = rmt_strip->pixel_buf;
+    rmt_strip->pixel_buf = rmt_strip->tx_buf;
+    rmt_strip->tx_buf = frame;
+    // keep the new front buffer up to date, so that partial updates to the next frame still work
+    memcpy(rmt_strip->pixel_buf, rmt_strip->tx_buf, buf_size);
+
+    ESP_RETURN_ON_ERROR(rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, rmt_strip->tx_buf,
+                                     tx_size, &tx_conf), TAG, "transmit pixels by RMT failed");
+    rmt_strip->tx_pending = true;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_refresh_async(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    return led_strip_rmt_refresh_partial_async(strip, rmt_strip->strip_len);
+}
+
+static esp_err_t led_strip_rmt_refresh(led_strip_t *strip)
+{
+    ESP_RETURN_ON_ERROR(led_strip_rmt_refresh_async(strip), TAG, "start refresh failed");
+    return led_strip_rmt_wait_refresh_done(strip, -1);
+}
+
+static esp_err_t led_strip_rmt_mark_changed(led_strip_t *strip, uint32_t start, uint32_t count)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(start <= rmt_strip->strip_len && count <= rmt_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    led_strip_rmt_mark_dirty(rmt_strip, start, count);
+    rmt_strip->app_marks = true;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_clear(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(rmt_strip->pixel_buf, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+    // Write zero to turn off all leds
+    memset(rmt_strip->pixel_buf, 0, rmt_strip->strip_len * rmt_strip->bytes_per_pixel);
+    led_strip_rmt_mark_dirty(rmt_strip, 0, rmt_strip->strip_len);
+    return led_strip_rmt_refresh(strip);
+}
+
+static esp_err_t led_strip_rmt_attach_buffer(led_strip_t *strip, uint8_t *pixels)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(pixels || rmt_strip->own_buffers, ESP_ERR_INVALID_STATE, TAG, "strip has no pixel buffer of its own");
+    // the buffer being replaced may still be read by the transaction in flight
+    ESP_RETURN_ON_ERROR(led_strip_rmt_wait_refresh_done(strip, -1), TAG, "wait refresh done failed");
+
+    size_t buf_size = rmt_strip->strip_len * rmt_strip->bytes_per_pixel;
+    if (pixels) {
+        rmt_strip->pixel_buf = pixels;
+        rmt_strip->app_buffer = true;
+    } else {
+        rmt_strip->pixel_buf = rmt_strip->buffers;
+        rmt_strip->tx_buf = rmt_strip->buffers + buf_size;
+        rmt_strip->app_buffer = false;
+    }
+    // changes to the new buffer are untracked until the application reports them again
+    rmt_strip->app_marks = false;
+    // the symbol cache doesn't match the new buffer yet
+    led_strip_rmt_mark_dirty(rmt_strip, 0, rmt_strip->strip_len);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_del(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_ERROR(led_strip_rmt_wait_refresh_done(strip, -1), TAG, "wait refresh done failed");
+    ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+    ESP_RETURN_ON_ERROR(rmt_del_channel(rmt_strip->rmt_chan), TAG, "delete RMT channel failed");
+    ESP_RETURN_ON_ERROR(rmt_del_encoder(rmt_strip->strip_encoder), TAG, "delete strip encoder failed");
+    free(rmt_strip->symbols);
+    if (!rmt_strip->shared_lut) {
+        free(rmt_strip->symbol_lut);
+    }
+    free(rmt_strip->dirty);
+    free(rmt_strip);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_rmt_get_channel(led_strip_t *strip, rmt_channel_handle_t *ret_chan)
+{
+    ESP_RETURN_ON_FALSE(strip && ret_chan, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    *ret_chan = rmt_strip->rmt_chan;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip)
+{
+    return led_strip_new_rmt_device_sharing_lut(led_config, rmt_config, NULL, ret_strip);
+}
+
+esp_err_t led_strip_new_rmt_device_sharing_lut(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                                               led_strip_t *lut_owner, led_strip_handle_t *ret_strip)
+{
+    led_strip_rmt_obj *rmt_strip = NULL;
+    led_strip_rmt_obj *owner = lut_owner ? __containerof(lut_owner, led_strip_rmt_obj, base) : NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && rmt_config && ret_strip, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(!owner || owner->symbol_lut || !rmt_config->flags.use_symbol_cache, ESP_ERR_INVALID_ARG, err, TAG, "lut_owner has no symbol table");
+    led_color_component_format_t component_fmt = led_config->color_component_format;
+    // If R/G/B order is not specified, set default GRB order as fallback
+    if (component_fmt.format_id == 0) {
+        component_fmt = LED_STRIP_COLOR_COMPONENT_FMT_GRB;
+    }
+    // check the validation of the color component format
+    uint8_t mask = 0;
+    if (component_fmt.format.num_components == 3) {
+        mask = BIT(component_fmt.format.r_pos) | BIT(component_fmt.format.g_pos) | BIT(component_fmt.format.b_pos);
+        // Check for invalid values
+        ESP_RETURN_ON_FALSE(mask == 0x07, ESP_ERR_INVALID_ARG, TAG, "invalid order argument");
+    } else if (component_fmt.format.num_components == 4) {
+        mask = BIT(component_fmt.format.r_pos) | BIT(component_fmt.format.g_pos) | BIT(component_fmt.format.b_pos) | BIT(component_fmt.format.w_pos);
+        // Check for invalid values
+        ESP_RETURN_ON_FALSE(mask == 0x0F, ESP_ERR_INVALID_ARG, TAG, "invalid order argument");
+    } else {
+        ESP_RETURN_ON_FALSE(false, ESP_ERR_INVALID_ARG, TAG, "invalid number of color components: %d", component_fmt.format.num_components);
+    }
+    // TODO: we assume each color component is 8 bits, may need to support other configurations in the future, e.g. 10bits per color component?
+    uint8_t bytes_per_pixel = component_fmt.format.num_components;
+    // two pixel buffers: one for the application to draw, one for the transmission in progress,
+    // unless the application attaches its own buffer later
+    size_t buf_size = rmt_config->flags.external_buffer ? 0 : led_config->max_leds * bytes_per_pixel;
+    rmt_strip = calloc(1, sizeof(led_strip_rmt_obj) + 2 * buf_size);
+    ESP_GOTO_ON_FALSE(rmt_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for rmt strip");
+    if (buf_size) {
+        rmt_strip->own_buffers = true;
+        rmt_strip->pixel_buf = rmt_strip->buffers;
+        rmt_strip->tx_buf = rmt_strip->buffers + buf_size;
+    }
+    uint32_t resolution = rmt_config->resolution_hz ? rmt_config->resolution_hz : LED_STRIP_RMT_DEFAULT_RESOLUTION;
+
+    // for backward compatibility, if the user does not set the clk_src, use the default value
+    rmt_clock_source_t clk_src = RMT_CLK_SRC_DEFAULT;
+    if (rmt_config->clk_src) {
+        clk_src = rmt_config->clk_src;
+    }
+    size_t mem_block_symbols = LED_STRIP_RMT_DEFAULT_MEM_BLOCK_SYMBOLS;
+    // override the default value if the user sets it
+    if (rmt_config->mem_block_symbols) {
+        mem_block_symbols = rmt_config->mem_block_symbols;
+    }
+    rmt_tx_channel_config_t rmt_chan_config = {
+        .clk_src = clk_src,
+        .gpio_num = led_config->strip_gpio_num,
+        .mem_block_symbols = mem_block_symbols,
+        .resolution_hz = resolution,
+        .trans_queue_depth = LED_STRIP_RMT_DEFAULT_TRANS_QUEUE_SIZE,
+        .flags.with_dma = rmt_config->flags.with_dma,
+        .flags.invert_out = led_config->flags.invert_out,
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_tx_channel(&rmt_chan_config, &rmt_strip->rmt_chan), err, TAG, "create RMT TX channel failed");
+
+    led_strip_encoder_config_t strip_encoder_conf = {
+        .resolution = resolution,
+        .led_model = led_config->led_model,
+        .flags.pre_encoded = rmt_config->flags.use_symbol_cache,
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_led_strip_encoder(&strip_encoder_conf, &rmt_strip->strip_encoder), err, TAG, "create LED strip encoder failed");
+
+    if (rmt_config->flags.use_symbol_cache) {
+        size_t num_symbols = led_config->max_leds * bytes_per_pixel * LED_STRIP_RMT_SYMBOLS_PER_BYTE;
+        rmt_strip->symbols = calloc(num_symbols, sizeof(rmt_symbol_word_t));
+        rmt_strip->dirty = calloc((led_config->max_leds + 31) / 32, sizeof(uint32_t));
+        if (owner) {
+            rmt_strip->symbol_lut = owner->symbol_lut;
+            rmt_strip->shared_lut = true;
+        } else {
+            rmt_strip->symbol_lut = calloc(256, sizeof(rmt_symbol_word_t) * LED_STRIP_RMT_SYMBOLS_PER_BYTE);
+        }
+        ESP_GOTO_ON_FALSE(rmt_strip->symbols && rmt_strip->symbol_lut && rmt_strip->dirty, ESP_ERR_NO_MEM, err, TAG, "no mem for symbol cache");
+        if (!owner) {
+            ESP_GOTO_ON_ERROR(rmt_led_strip_encoder_build_lut(&strip_encoder_conf, rmt_strip->symbol_lut), err, TAG, "build symbol table failed");
+        }
+        // every pixel needs encoding before the first refresh
+        led_strip_rmt_mark_dirty(rmt_strip, 0, led_config->max_leds);
+    }
+    // the channel stays enabled for the whole life of the strip, saving the enable/disable cost on every refresh
+    ESP_GOTO_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), err, TAG, "enable RMT channel failed");
+
+    rmt_strip->component_fmt = component_fmt;
+    rmt_strip->bytes_per_pixel = bytes_per_pixel;
+    rmt_strip->strip_len = led_config->max_leds;
+    rmt_strip->base.set_pixel = led_strip_rmt_set_pixel;
+    rmt_strip->base.set_pixel_rgbw = led_strip_rmt_set_pixel_rgbw;
+    rmt_strip->base.set_pixels = led_strip_rmt_set_pixels;
+    rmt_strip->base.refresh = led_strip_rmt_refresh;
+    rmt_strip->base.refresh_async = led_strip_rmt_refresh_async;
+    rmt_strip->base.refresh_partial_async = led_strip_rmt_refresh_partial_async;
+    rmt_strip->base.wait_refresh_done = led_strip_rmt_wait_refresh_done;
+    rmt_strip->base.attach_buffer = led_strip_rmt_attach_buffer;
+    rmt_strip->base.mark_changed = led_strip_rmt_mark_changed;
+    rmt_strip->base.clear = led_strip_rmt_clear;
+    rmt_strip->base.del = led_strip_rmt_del;
+
+    *ret_strip = &rmt_strip->base;
+    return ESP_OK;
+err:
+    if (rmt_strip) {
+        if (rmt_strip->rmt_chan) {
+            rmt_del_channel(rmt_strip->rmt_chan);
+        }
+        if (rmt_strip->strip_encoder) {
+            rmt_del_encoder(rmt_strip->strip_encoder);
+        }
+        free(rmt_strip->symbols);
+        if (!rmt_strip->shared_lut) {
+            free(rmt_strip->symbol_lut);
+        }
+        free(rmt_strip->dirty);
+        free(rmt_strip);
+    }
+    return ret;
+}
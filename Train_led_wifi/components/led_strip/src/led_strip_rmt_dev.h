@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "esp_err.h"
+#include "driver/rmt_types.h"
+#include "led_strip_rmt.h"
+#include "led_strip_interface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the RMT TX channel behind a strip created by `led_strip_new_rmt_device`
+ *
+ * @param strip LED strip, must be an RMT strip
+ * @param ret_chan Returned RMT channel handle
+ * @return
+ *      - ESP_OK: Get the channel successfully
+ *      - ESP_ERR_INVALID_ARG: Get the channel failed because of invalid argument
+ */
+esp_err_t led_strip_rmt_get_channel(led_strip_t *strip, rmt_channel_handle_t *ret_chan);
+
+/**
+ * @brief Create an RMT strip like `led_strip_new_rmt_device`, reusing the symbol table of another symbol cache strip
+ *
+ * @note The table is 8 KB; strips with the same LED model and RMT resolution can share one.
+ *       `lut_owner` must be deleted after every strip that shares its table.
+ *
+ * @param led_config LED strip configuration
+ * @param rmt_config RMT specific configuration
+ * @param lut_owner Strip whose symbol table is reused, NULL to build a new one
+ * @param ret_strip Returned LED strip handle
+ * @return
+ *      - ESP_OK: create LED strip handle successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip handle failed because of invalid argument, or `lut_owner` has no symbol table
+ *      - ESP_ERR_NO_MEM: create LED strip handle failed because of out of memory
+ *      - ESP_FAIL: create LED strip handle failed because some other error
+ */
+esp_err_t led_strip_new_rmt_device_sharing_lut(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                                               led_strip_t *lut_owner, led_strip_handle_t *ret_strip);
+
+#ifdef __cplusplus
+}
+#endif
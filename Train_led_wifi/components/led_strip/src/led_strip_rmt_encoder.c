@@ -14,6 +14,7 @@ typedef struct {
     rmt_encoder_t *bytes_encoder;
     rmt_encoder_t *copy_encoder;
     int state;
+    bool pre_encoded; // primary data is pre-encoded symbols, send it by the copy encoder
     rmt_symbol_word_t reset_code;
 } rmt_led_strip_encoder_t;
 
@@ -27,7 +28,11 @@ static size_t rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t
     size_t encoded_symbols = 0;
     switch (led_encoder->state) {
     case 0: // send RGB data
-        encoded_symbols += bytes_encoder->encode(bytes_encoder, channel, primary_data, data_size, &session_state);
+        if (led_encoder->pre_encoded) {
+            encoded_symbols += copy_encoder->encode(copy_encoder, channel, primary_data, data_size, &session_state);
+        } else {
+            encoded_symbols += bytes_encoder->encode(bytes_encoder, channel, primary_data, data_size, &session_state);
+        }
         if (session_state & RMT_ENCODING_COMPLETE) {
             led_encoder->state = 1; // switch to next state when current encoding session finished
         }
@@ -56,7 +61,9 @@ out:
 static esp_err_t rmt_del_led_strip_encoder(rmt_encoder_t *encoder)
 {
     rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
-    rmt_del_encoder(led_encoder->bytes_encoder);
+    if (led_encoder->bytes_encoder) {
+        rmt_del_encoder(led_encoder->bytes_encoder);
+    }
     rmt_del_encoder(led_encoder->copy_encoder);
     free(led_encoder);
     return ESP_OK;
@@ -65,27 +72,19 @@ static esp_err_t rmt_del_led_strip_encoder(rmt_encoder_t *encoder)
 static esp_err_t rmt_led_strip_encoder_reset(rmt_encoder_t *encoder)
 {
     rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
-    rmt_encoder_reset(led_encoder->bytes_encoder);
+    if (led_encoder->bytes_encoder) {
+        rmt_encoder_reset(led_encoder->bytes_encoder);
+    }
     rmt_encoder_reset(led_encoder->copy_encoder);
     led_encoder->state = 0;
     return ESP_OK;
 }
 
-esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+static esp_err_t led_strip_encoder_get_timing(const led_strip_encoder_config_t *config, rmt_bytes_encoder_config_t *bytes_encoder_config, uint32_t *ret_reset_ticks)
 {
-    esp_err_t ret = ESP_OK;
-    rmt_led_strip_encoder_t *led_encoder = NULL;
-    ESP_GOTO_ON_FALSE(config && ret_encoder, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
-    ESP_GOTO_ON_FALSE(config->led_model < LED_MODEL_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led model");
-    led_encoder = calloc(1, sizeof(rmt_led_strip_encoder_t));
-    ESP_GOTO_ON_FALSE(led_encoder, ESP_ERR_NO_MEM, err, TAG, "no mem for led strip encoder");
-    led_encoder->base.encode = rmt_encode_led_strip;
-    led_encoder->base.del = rmt_del_led_strip_encoder;
-    led_encoder->base.reset = rmt_led_strip_encoder_reset;
-    rmt_bytes_encoder_config_t bytes_encoder_config;
     uint32_t reset_ticks = config->resolution / 1000000 * 280 / 2; // reset code duration defaults to 280us to accommodate WS2812B-V5
     if (config->led_model == LED_MODEL_SK6812) {
-        bytes_encoder_config = (rmt_bytes_encoder_config_t) {
+        *bytes_encoder_config = (rmt_bytes_encoder_config_t) {
             .bit0 = {
                 .level0 = 1,
                 .duration0 = 0.3 * config->resolution / 1000000, // T0H=0.3us
@@ -102,7 +101,7 @@ esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rm
         };
     } else if (config->led_model == LED_MODEL_WS2812) {
         // different led strip might have its own timing requirements, following parameter is for WS2812
-        bytes_encoder_config = (rmt_bytes_encoder_config_t) {
+        *bytes_encoder_config = (rmt_bytes_encoder_config_t) {
             .bit0 = {
                 .level0 = 1,
                 .duration0 = 0.3 * config->resolution / 1000000, // T0H=0.3us
@@ -119,7 +118,7 @@ esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rm
         };
     } else if (config->led_model == LED_MODEL_WS2811) {
         // different led strip might have its own timing requirements, following parameter is for WS2811
-        bytes_encoder_config = (rmt_bytes_encoder_config_t) {
+        *bytes_encoder_config = (rmt_bytes_encoder_config_t) {
             .bit0 = {
                 .level0 = 1,
                 .duration0 = 0.5 * config->resolution / 1000000., // T0H=0.5us
@@ -136,9 +135,46 @@ esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rm
         };
         reset_ticks = config->resolution / 1000000 * 50 / 2; // divide by 2... signal is sent twice
     } else {
-        assert(false);
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ret_reset_ticks = reset_ticks;
+    return ESP_OK;
+}
+
+esp_err_t rmt_led_strip_encoder_build_lut(const led_strip_encoder_config_t *config, rmt_symbol_word_t lut[256][LED_STRIP_RMT_SYMBOLS_PER_BYTE])
+{
+    ESP_RETURN_ON_FALSE(config && lut, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    rmt_bytes_encoder_config_t bytes_encoder_config;
+    uint32_t reset_ticks = 0;
+    ESP_RETURN_ON_ERROR(led_strip_encoder_get_timing(config, &bytes_encoder_config, &reset_ticks), TAG, "unsupported led model");
+    for (int value = 0; value < 256; value++) {
+        // all supported LED models transfer MSB first
+        for (int bit = 0; bit < LED_STRIP_RMT_SYMBOLS_PER_BYTE; bit++) {
+            lut[value][bit] = (value & BIT(7 - bit)) ? bytes_encoder_config.bit1 : bytes_encoder_config.bit0;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    esp_err_t ret = ESP_OK;
+    rmt_led_strip_encoder_t *led_encoder = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_encoder, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->led_model < LED_MODEL_INVALID, ESP_ERR_INVALID_ARG, err, TAG, "invalid led model");
+    led_encoder = calloc(1, sizeof(rmt_led_strip_encoder_t));
+    ESP_GOTO_ON_FALSE(led_encoder, ESP_ERR_NO_MEM, err, TAG, "no mem for led strip encoder");
+    led_encoder->base.encode = rmt_encode_led_strip;
+    led_encoder->base.del = rmt_del_led_strip_encoder;
+    led_encoder->base.reset = rmt_led_strip_encoder_reset;
+    bool pre_encoded = config->flags.pre_encoded;
+    led_encoder->pre_encoded = pre_encoded;
+    rmt_bytes_encoder_config_t bytes_encoder_config;
+    uint32_t reset_ticks = 0;
+    ESP_GOTO_ON_ERROR(led_strip_encoder_get_timing(config, &bytes_encoder_config, &reset_ticks), err, TAG, "unsupported led model");
+    if (!pre_encoded) {
+        ESP_GOTO_ON_ERROR(rmt_new_bytes_encoder(&bytes_encoder_config, &led_encoder->bytes_encoder), err, TAG, "create bytes encoder failed");
     }
-    ESP_GOTO_ON_ERROR(rmt_new_bytes_encoder(&bytes_encoder_config, &led_encoder->bytes_encoder), err, TAG, "create bytes encoder failed");
     rmt_copy_encoder_config_t copy_encoder_config = {};
     ESP_GOTO_ON_ERROR(rmt_new_copy_encoder(&copy_encoder_config, &led_encoder->copy_encoder), err, TAG, "create copy encoder failed");
 
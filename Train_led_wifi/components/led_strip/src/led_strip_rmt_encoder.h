@@ -19,8 +19,16 @@ extern "C" {
 typedef struct {
     uint32_t resolution;   /*!< Encoder resolution, in Hz */
     led_model_t led_model; /*!< LED model */
+    struct {
+        uint32_t pre_encoded: 1; /*!< The primary data is already RMT symbols (see `rmt_led_strip_encoder_build_lut`), copy them as is */
+    } flags;               /*!< Encoder flags */
 } led_strip_encoder_config_t;
 
+/**
+ * @brief Number of RMT symbols used to encode one color byte
+ */
+#define LED_STRIP_RMT_SYMBOLS_PER_BYTE 8
+
 /**
  * @brief Create RMT encoder for encoding LED strip pixels into RMT symbols
  *
@@ -33,6 +41,17 @@ typedef struct {
  */
 esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder);
 
+/**
+ * @brief Build the lookup table that converts a color byte into RMT symbols, using the bit timing of the LED model
+ *
+ * @param[in] config Encoder configuration
+ * @param[out] lut Table of 256 entries, each holding the symbols of one byte value, MSB first
+ * @return
+ *      - ESP_ERR_INVALID_ARG for any invalid arguments
+ *      - ESP_OK if the table is built successfully
+ */
+esp_err_t rmt_led_strip_encoder_build_lut(const led_strip_encoder_config_t *config, rmt_symbol_word_t lut[256][LED_STRIP_RMT_SYMBOLS_PER_BYTE]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,270 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "soc/soc_caps.h"
+#include "driver/rmt_tx.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "led_strip_rmt_dev.h"
+
+#define LED_STRIP_RMT_MULTI_CLEAR_CHUNK 16 // pixels written per call when clearing
+
+static const char *TAG = "led_strip_rmt_multi";
+
+typedef struct {
+    led_strip_handle_t strip;
+    uint32_t start;     // index of the first LED of this segment in the whole strip
+    uint32_t len;
+} led_strip_rmt_segment_t;
+
+typedef struct {
+    led_strip_t base;
+    uint32_t strip_len;
+    uint8_t bytes_per_pixel;
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    rmt_sync_manager_handle_t synchro; // starts all the channels at the same time
+#endif
+    size_t num_segments;
+    led_strip_rmt_segment_t segments[];
+} led_strip_rmt_multi_obj;
+
+// segments are contiguous and in order, a linear search is enough for the few channels a chip has
+static led_strip_rmt_segment_t *led_strip_rmt_multi_find(led_strip_rmt_multi_obj *multi, uint32_t index)
+{
+    for (size_t i = 0; i < multi->num_segments; i++) {
+        if (index < multi->segments[i].start + multi->segments[i].len) {
+            return &multi->segments[i];
+        }
+    }
+    return NULL;
+}
+
+static esp_err_t led_strip_rmt_multi_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    ESP_RETURN_ON_FALSE(index < multi->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    led_strip_rmt_segment_t *seg = led_strip_rmt_multi_find(multi, index);
+    return led_strip_set_pixel(seg->strip, index - seg->start, red, green, blue);
+}
+
+static esp_err_t led_strip_rmt_multi_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    ESP_RETURN_ON_FALSE(index < multi->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    led_strip_rmt_segment_t *seg = led_strip_rmt_multi_find(multi, index);
+    return led_strip_set_pixel_rgbw(seg->strip, index - seg->start, red, green, blue, white);
+}
+
+static esp_err_t led_strip_rmt_multi_set_pixels(led_strip_t *strip, uint32_t start, const uint8_t *pixels, uint32_t count, led_color_component_format_t src_format)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    ESP_RETURN_ON_FALSE(count <= multi->strip_len && start <= multi->strip_len - count, ESP_ERR_INVALID_ARG, TAG, "pixels out of maximum number of LEDs");
+    uint8_t src_bytes = src_format.format_id ? src_format.format.num_components : multi->bytes_per_pixel;
+
+    // split the range at the segment boundaries
+    while (count) {
+        led_strip_rmt_segment_t *seg = led_strip_rmt_multi_find(multi, start);
+        uint32_t n = seg->start + seg->len - start;
+        if (n > count) {
+            n = count;
+        }
+        ESP_RETURN_ON_ERROR(led_strip_set_pixels(seg->strip, start - seg->start, pixels, n, src_format), TAG, "set segment pixels failed");
+        pixels += n * src_bytes;
+        start += n;
+        count -= n;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_multi_wait_refresh_done(led_strip_t *strip, int32_t timeout_ms)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    for (size_t i = 0; i < multi->num_segments; i++) {
+        ESP_RETURN_ON_ERROR(led_strip_wait_refresh_done(multi->segments[i].strip, timeout_ms), TAG, "wait segment %d failed", (int)i);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_multi_refresh_partial_async(led_strip_t *strip, uint32_t num_leds)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    ESP_RETURN_ON_FALSE(num_leds <= multi->strip_len, ESP_ERR_INVALID_ARG, TAG, "num_leds out of maximum number of LEDs");
+    bool synchronized = false;
+    // every channel must be idle before the sync manager is re-armed
+    ESP_RETURN_ON_ERROR(led_strip_rmt_multi_wait_refresh_done(strip, -1), TAG, "wait previous refresh failed");
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    if (multi->synchro) {
+        ESP_RETURN_ON_ERROR(rmt_sync_reset(multi->synchro), TAG, "reset sync manager failed");
+        synchronized = true;
+    }
+#endif
+    // each segment sends its share of the front of the strip; with the sync manager, the transfers start together
+    // once the last channel is loaded, so a segment past num_leds still sends its first LED (unchanged by contract)
+    for (size_t i = 0; i < multi->num_segments; i++) {
+        led_strip_rmt_segment_t *seg = &multi->segments[i];
+        uint32_t n = num_leds > seg->start ? num_leds - seg->start : 0;
+        if (n > seg->len) {
+            n = seg->len;
+        }
+        if (n == 0 && synchronized) {
+            n = 1;
+        }
+        if (n) {
+            ESP_RETURN_ON_ERROR(led_strip_refresh_partial_async(seg->strip, n), TAG, "refresh segment %d failed", (int)i);
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_multi_refresh_async(led_strip_t *strip)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    return led_strip_rmt_multi_refresh_partial_async(strip, multi->strip_len);
+}
+
+static esp_err_t led_strip_rmt_multi_refresh(led_strip_t *strip)
+{
+    ESP_RETURN_ON_ERROR(led_strip_rmt_multi_refresh_async(strip), TAG, "start refresh failed");
+    return led_strip_rmt_multi_wait_refresh_done(strip, -1);
+}
+
+static esp_err_t led_strip_rmt_multi_clear(led_strip_t *strip)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    static const uint8_t zeros[LED_STRIP_RMT_MULTI_CLEAR_CHUNK * 4] = {0};
+    // the segments can't be cleared one by one: a single synchronized channel never starts on its own
+    for (uint32_t start = 0; start < multi->strip_len; start += LED_STRIP_RMT_MULTI_CLEAR_CHUNK) {
+        uint32_t n = multi->strip_len - start;
+        if (n > LED_STRIP_RMT_MULTI_CLEAR_CHUNK) {
+            n = LED_STRIP_RMT_MULTI_CLEAR_CHUNK;
+        }
+        // format_id 0: the data is already in the strip's own format
+        led_color_component_format_t native_fmt = {0};
+        ESP_RETURN_ON_ERROR(led_strip_rmt_multi_set_pixels(strip, start, zeros, n, native_fmt), TAG, "clear pixels failed");
+    }
+    return led_strip_rmt_multi_refresh(strip);
+}
+
+static esp_err_t led_strip_rmt_multi_attach_buffer(led_strip_t *strip, uint8_t *pixels)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    // each segment transmits its own slice of the buffer
+    for (size_t i = 0; i < multi->num_segments; i++) {
+        uint8_t *seg_pixels = pixels ? pixels + multi->segments[i].start * multi->bytes_per_pixel : NULL;
+        ESP_RETURN_ON_ERROR(led_strip_attach_buffer(multi->segments[i].strip, seg_pixels), TAG, "attach segment %d failed", (int)i);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_multi_mark_changed(led_strip_t *strip, uint32_t start, uint32_t count)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    ESP_RETURN_ON_FALSE(start <= multi->strip_len && count <= multi->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixels out of maximum number of LEDs");
+    // every segment switches to reported changes, also the ones without changes this time
+    for (size_t i = 0; i < multi->num_segments; i++) {
+        led_strip_rmt_segment_t *seg = &multi->segments[i];
+        uint32_t lo = start > seg->start ? start : seg->start;
+        uint32_t hi = start + count < seg->start + seg->len ? start + count : seg->start + seg->len;
+        uint32_t n = hi > lo ? hi - lo : 0;
+        ESP_RETURN_ON_ERROR(led_strip_mark_changed(seg->strip, n ? lo - seg->start : 0, n), TAG, "mark segment %d failed", (int)i);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_multi_del(led_strip_t *strip)
+{
+    led_strip_rmt_multi_obj *multi = __containerof(strip, led_strip_rmt_multi_obj, base);
+    ESP_RETURN_ON_ERROR(led_strip_rmt_multi_wait_refresh_done(strip, -1), TAG, "wait refresh done failed");
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    if (multi->synchro) {
+        ESP_RETURN_ON_ERROR(rmt_del_sync_manager(multi->synchro), TAG, "delete sync manager failed");
+    }
+#endif
+    // the first segment owns the symbol table shared by the others, delete it last
+    for (size_t i = multi->num_segments; i-- > 0;) {
+        ESP_RETURN_ON_ERROR(led_strip_del(multi->segments[i].strip), TAG, "delete segment %d failed", (int)i);
+    }
+    free(multi);
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_multi_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                                         const int *gpio_nums, size_t num_channels, led_strip_handle_t *ret_strip)
+{
+    led_strip_rmt_multi_obj *multi = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(led_config && rmt_config && gpio_nums && ret_strip && num_channels, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(num_channels <= SOC_RMT_TX_CANDIDATES_PER_GROUP, ESP_ERR_INVALID_ARG, err, TAG, "too many channels");
+    ESP_GOTO_ON_FALSE(led_config->max_leds >= num_channels, ESP_ERR_INVALID_ARG, err, TAG, "fewer LEDs than channels");
+    multi = calloc(1, sizeof(led_strip_rmt_multi_obj) + num_channels * sizeof(led_strip_rmt_segment_t));
+    ESP_GOTO_ON_FALSE(multi, ESP_ERR_NO_MEM, err, TAG, "no mem for multi-channel strip");
+
+    led_color_component_format_t component_fmt = led_config->color_component_format;
+    if (component_fmt.format_id == 0) {
+        component_fmt = LED_STRIP_COLOR_COMPONENT_FMT_GRB;
+    }
+    multi->bytes_per_pixel = component_fmt.format.num_components;
+    multi->strip_len = led_config->max_leds;
+
+    // split the LEDs evenly, the first segments take one more LED if the length is not divisible
+    rmt_channel_handle_t channels[SOC_RMT_TX_CANDIDATES_PER_GROUP];
+    uint32_t start = 0;
+    for (size_t i = 0; i < num_channels; i++) {
+        led_strip_rmt_segment_t *seg = &multi->segments[i];
+        led_strip_config_t seg_config = *led_config;
+        seg->start = start;
+        seg->len = led_config->max_leds / num_channels + (i < led_config->max_leds % num_channels ? 1 : 0);
+        seg_config.strip_gpio_num = gpio_nums[i];
+        seg_config.max_leds = seg->len;
+        // all segments have the same LED model and resolution, the first one's symbol table serves them all
+        led_strip_t *lut_owner = i ? multi->segments[0].strip : NULL;
+        ESP_GOTO_ON_ERROR(led_strip_new_rmt_device_sharing_lut(&seg_config, rmt_config, lut_owner, &seg->strip), err, TAG, "create segment %d failed", (int)i);
+        multi->num_segments++;
+        ESP_GOTO_ON_ERROR(led_strip_rmt_get_channel(seg->strip, &channels[i]), err, TAG, "get segment channel failed");
+        start += seg->len;
+    }
+
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    if (num_channels > 1) {
+        rmt_sync_manager_config_t synchro_config = {
+            .tx_channel_array = channels,
+            .array_size = num_channels,
+        };
+        ESP_GOTO_ON_ERROR(rmt_new_sync_manager(&synchro_config, &multi->synchro), err, TAG, "create sync manager failed");
+    }
+#else
+    if (num_channels > 1) {
+        ESP_LOGW(TAG, "RMT TX sync is not supported, channels start one after another");
+    }
+#endif
+
+    multi->base.set_pixel = led_strip_rmt_multi_set_pixel;
+    multi->base.set_pixel_rgbw = led_strip_rmt_multi_set_pixel_rgbw;
+    multi->base.set_pixels = led_strip_rmt_multi_set_pixels;
+    multi->base.refresh = led_strip_rmt_multi_refresh;
+    multi->base.refresh_async = led_strip_rmt_multi_refresh_async;
+    multi->base.refresh_partial_async = led_strip_rmt_multi_refresh_partial_async;
+    multi->base.wait_refresh_done = led_strip_rmt_multi_wait_refresh_done;
+    multi->base.attach_buffer = led_strip_rmt_multi_attach_buffer;
+    multi->base.mark_changed = led_strip_rmt_multi_mark_changed;
+    multi->base.clear = led_strip_rmt_multi_clear;
+    multi->base.del = led_strip_rmt_multi_del;
+
+    *ret_strip = &multi->base;
+    return ESP_OK;
+err:
+    if (multi) {
+        for (size_t i = multi->num_segments; i-- > 0;) {
+            led_strip_del(multi->segments[i].strip);
+        }
+        free(multi);
+    }
+    return ret;
+}
@@ -8,6 +8,7 @@
 #include <sys/cdefs.h>
 #include "esp_log.h"
 #include "esp_check.h"
+#include "freertos/FreeRTOS.h"
 #include "esp_rom_gpio.h"
 #include "soc/spi_periph.h"
 #include "led_strip.h"
@@ -29,23 +30,44 @@ typedef struct {
     uint32_t strip_len;
     uint8_t bytes_per_pixel;
     led_color_component_format_t component_fmt;
-    uint8_t pixel_buf[];
+    bool tx_pending;     // a transaction has been queued and its result not fetched yet
+    spi_transaction_t tx_trans;
+    uint8_t *pixel_buf;  // buffer updated by set_pixel
+    uint8_t *tx_buf;     // buffer owned by the SPI transaction, swapped with pixel_buf on every refresh
+    uint8_t buffers[];
 } led_strip_spi_obj;
 
-// please make sure to zero-initialize the buf before calling this function
-static void __led_strip_spi_bit(uint8_t data, uint8_t *buf)
+// Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110
+// So a color byte occupies 3 bytes (24 bits) of SPI: the fixed pattern 0x924924 with bit n of the color at bit 3n+1
+#define SPI_ENCODE_BYTE(d) (0x924924 | (((d) & BIT(0)) << 1) | (((d) & BIT(1)) << 3) | (((d) & BIT(2)) << 5) | (((d) & BIT(3)) << 7) | \
+                            (((d) & BIT(4)) << 9) | (((d) & BIT(5)) << 11) | (((d) & BIT(6)) << 13) | (((d) & BIT(7)) << 15))
+#define SPI_ENCODE_4(n)   SPI_ENCODE_BYTE(n), SPI_ENCODE_BYTE(n + 1), SPI_ENCODE_BYTE(n + 2), SPI_ENCODE_BYTE(n + 3)
+#define SPI_ENCODE_16(n)  SPI_ENCODE_4(n), SPI_ENCODE_4(n + 4), SPI_ENCODE_4(n + 8), SPI_ENCODE_4(n + 12)
+#define SPI_ENCODE_64(n)  SPI_ENCODE_16(n), SPI_ENCODE_16(n + 16), SPI_ENCODE_16(n + 32), SPI_ENCODE_16(n + 48)
+
+// SPI bit pattern of every color byte, computed at compile time
+static const uint32_t s_spi_encode_lut[256] = {
+    SPI_ENCODE_64(0), SPI_ENCODE_64(64), SPI_ENCODE_64(128), SPI_ENCODE_64(192),
+};
+
+static inline void __led_strip_spi_bit(uint8_t data, uint8_t *buf)
 {
-    // Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110
-    // So a color byte occupies 3 bytes of SPI.
-    *(buf + 2) |= data & BIT(0) ? BIT(2) | BIT(1) : BIT(2);
-    *(buf + 2) |= data & BIT(1) ? BIT(5) | BIT(4) : BIT(5);
-    *(buf + 2) |= data & BIT(2) ? BIT(7) : 0x00;
-    *(buf + 1) |= BIT(0);
-    *(buf + 1) |= data & BIT(3) ? BIT(3) | BIT(2) : BIT(3);
-    *(buf + 1) |= data & BIT(4) ? BIT(6) | BIT(5) : BIT(6);
-    *(buf + 0) |= data & BIT(5) ? BIT(1) | BIT(0) : BIT(1);
-    *(buf + 0) |= data & BIT(6) ? BIT(4) | BIT(3) : BIT(4);
-    *(buf + 0) |= data & BIT(7) ? BIT(7) | BIT(6) : BIT(7);
+    uint32_t pattern = s_spi_encode_lut[data];
+    buf[0] = pattern >> 16;
+    buf[1] = pattern >> 8;
+    buf[2] = pattern;
+}
+
+// encode a buffer of color bytes that are already in the strip's order
+static void __led_strip_spi_encode(const uint8_t *data, size_t len, uint8_t *buf)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint32_t pattern = s_spi_encode_lut[data[i]];
+        buf[0] = pattern >> 16;
+        buf[1] = pattern >> 8;
+        buf[2] = pattern;
+        buf += SPI_BYTES_PER_COLOR_BYTE;
+    }
 }
 
 static esp_err_t led_strip_spi_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
@@ -56,7 +78,6 @@ static esp_err_t led_strip_spi_set_pixel(led_strip_t *strip, uint32_t index, uin
     uint32_t start = index * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
     uint8_t *pixel_buf = spi_strip->pixel_buf;
     led_color_component_format_t component_fmt = spi_strip->component_fmt;
-    memset(pixel_buf + start, 0, spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE);
 
     __led_strip_spi_bit(red, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.r_pos]);
     __led_strip_spi_bit(green, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.g_pos]);
@@ -78,7 +99,6 @@ static esp_err_t led_strip_spi_set_pixel_rgbw(led_strip_t *strip, uint32_t index
     // LED_PIXEL_FORMAT_GRBW takes 96bits(12bytes)
     uint32_t start = index * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
     uint8_t *pixel_buf = spi_strip->pixel_buf;
-    memset(pixel_buf + start, 0, spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE);
 
     __led_strip_spi_bit(red, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.r_pos]);
     __led_strip_spi_bit(green, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.g_pos]);
@@ -88,28 +108,93 @@ static esp_err_t led_strip_spi_set_pixel_rgbw(led_strip_t *strip, uint32_t index
     return ESP_OK;
 }
 
-static esp_err_t led_strip_spi_refresh(led_strip_t *strip)
+static esp_err_t led_strip_spi_set_pixels(led_strip_t *strip, uint32_t start, const uint8_t *pixels, uint32_t count, led_color_component_format_t src_format)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(start <= spi_strip->strip_len && count <= spi_strip->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+
+    led_color_component_format_t component_fmt = spi_strip->component_fmt;
+    uint8_t bytes_per_pixel = spi_strip->bytes_per_pixel;
+    uint32_t spi_bytes_per_pixel = bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    uint8_t *dst = spi_strip->pixel_buf + start * spi_bytes_per_pixel;
+
+    // fast path: source is already in the native order, encode it as a flat byte stream
+    if (src_format.format_id == 0 || src_format.format_id == component_fmt.format_id) {
+        __led_strip_spi_encode(pixels, count * bytes_per_pixel, dst);
+        return ESP_OK;
+    }
+
+    uint8_t src_bytes = src_format.format.num_components;
+    ESP_RETURN_ON_FALSE(src_bytes == 3 || src_bytes == 4, ESP_ERR_INVALID_ARG, TAG, "invalid number of source color components");
+
+    bool has_white = bytes_per_pixel > 3;
+    bool src_has_white = src_bytes > 3;
+    for (uint32_t i = 0; i < count; i++) {
+        __led_strip_spi_bit(pixels[src_format.format.r_pos], &dst[SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.r_pos]);
+        __led_strip_spi_bit(pixels[src_format.format.g_pos], &dst[SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.g_pos]);
+        __led_strip_spi_bit(pixels[src_format.format.b_pos], &dst[SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.b_pos]);
+        if (has_white) {
+            __led_strip_spi_bit(src_has_white ? pixels[src_format.format.w_pos] : 0, &dst[SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.w_pos]);
+        }
+        dst += spi_bytes_per_pixel;
+        pixels += src_bytes;
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_wait_refresh_done(led_strip_t *strip, int32_t timeout_ms)
 {
     led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
-    spi_transaction_t tx_conf;
-    memset(&tx_conf, 0, sizeof(tx_conf));
+    if (!spi_strip->tx_pending) {
+        return ESP_OK;
+    }
+    spi_transaction_t *done_trans = NULL;
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    ESP_RETURN_ON_ERROR(spi_device_get_trans_result(spi_strip->spi_device, &done_trans, ticks), TAG, "wait SPI transaction failed");
+    spi_strip->tx_pending = false;
+    return ESP_OK;
+}
 
-    tx_conf.length = spi_strip->strip_len * spi_strip->bytes_per_pixel * SPI_BITS_PER_COLOR_BYTE;
-    tx_conf.tx_buffer = spi_strip->pixel_buf;
-    tx_conf.rx_buffer = NULL;
-    ESP_RETURN_ON_ERROR(spi_device_transmit(spi_strip->spi_device, &tx_conf), TAG, "transmit pixels by SPI failed");
+static esp_err_t led_strip_spi_refresh_async(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    size_t buf_size = spi_strip->strip_len * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+
+    // the back buffer is still being read by the previous transaction
+    ESP_RETURN_ON_ERROR(led_strip_spi_wait_refresh_done(strip, -1), TAG, "wait previous refresh failed");
+
+    uint8_t *frame = spi_strip->pixel_buf;
+    spi_strip->pixel_buf = spi_strip->tx_buf;
+    spi_strip->tx_buf = frame;
+    // keep the new front buffer up to date, so that partial updates to the next frame still work
+    memcpy(spi_strip->pixel_buf, spi_strip->tx_buf, buf_size);
+
+    memset(&spi_strip->tx_trans, 0, sizeof(spi_strip->tx_trans));
+    spi_strip->tx_trans.length = buf_size * 8;
+    spi_strip->tx_trans.tx_buffer = spi_strip->tx_buf;
+    spi_strip->tx_trans.rx_buffer = NULL;
+    ESP_RETURN_ON_ERROR(spi_device_queue_trans(spi_strip->spi_device, &spi_strip->tx_trans, portMAX_DELAY), TAG, "transmit pixels by SPI failed");
+    spi_strip->tx_pending = true;
 
     return ESP_OK;
 }
 
+static esp_err_t led_strip_spi_refresh(led_strip_t *strip)
+{
+    ESP_RETURN_ON_ERROR(led_strip_spi_refresh_async(strip), TAG, "start refresh failed");
+    return led_strip_spi_wait_refresh_done(strip, -1);
+}
+
 static esp_err_t led_strip_spi_clear(led_strip_t *strip)
 {
     led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
-    //Write zero to turn off all leds
-    memset(spi_strip->pixel_buf, 0, spi_strip->strip_len * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE);
+    //Write zero to turn off all leds, every color byte encodes to the same 3 bytes
+    uint8_t zero[SPI_BYTES_PER_COLOR_BYTE];
+    __led_strip_spi_bit(0, zero);
     uint8_t *buf = spi_strip->pixel_buf;
     for (int index = 0; index < spi_strip->strip_len * spi_strip->bytes_per_pixel; index++) {
-        __led_strip_spi_bit(0, buf);
+        memcpy(buf, zero, SPI_BYTES_PER_COLOR_BYTE);
         buf += SPI_BYTES_PER_COLOR_BYTE;
     }
 
@@ -120,6 +205,7 @@ static esp_err_t led_strip_spi_del(led_strip_t *strip)
 {
     led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
 
+    ESP_RETURN_ON_ERROR(led_strip_spi_wait_refresh_done(strip, -1), TAG, "wait refresh done failed");
     ESP_RETURN_ON_ERROR(spi_bus_remove_device(spi_strip->spi_device), TAG, "delete spi device failed");
     ESP_RETURN_ON_ERROR(spi_bus_free(spi_strip->spi_host), TAG, "free spi bus failed");
 
@@ -157,9 +243,12 @@ esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const l
         // DMA buffer must be placed in internal SRAM
         mem_caps |= MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
     }
-    spi_strip = heap_caps_calloc(1, sizeof(led_strip_spi_obj) + led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE, mem_caps);
+    // two pixel buffers: one for the application to draw, one for the transmission in progress
+    spi_strip = heap_caps_calloc(1, sizeof(led_strip_spi_obj) + 2 * led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE, mem_caps);
 
     ESP_GOTO_ON_FALSE(spi_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for spi strip");
+    spi_strip->pixel_buf = spi_strip->buffers;
+    spi_strip->tx_buf = spi_strip->buffers + led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
 
     spi_strip->spi_host = spi_config->spi_bus;
     // for backward compatibility, if the user does not set the clk_src, use the default value
@@ -215,7 +304,10 @@ esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const l
     spi_strip->strip_len = led_config->max_leds;
     spi_strip->base.set_pixel = led_strip_spi_set_pixel;
     spi_strip->base.set_pixel_rgbw = led_strip_spi_set_pixel_rgbw;
+    spi_strip->base.set_pixels = led_strip_spi_set_pixels;
     spi_strip->base.refresh = led_strip_spi_refresh;
+    spi_strip->base.refresh_async = led_strip_spi_refresh_async;
+    spi_strip->base.wait_refresh_done = led_strip_spi_wait_refresh_done;
     spi_strip->base.clear = led_strip_spi_clear;
     spi_strip->base.del = led_strip_spi_del;
 
@@ -0,0 +1,111 @@
+/* 动画文件格式测试：用 main/anim_format.c 解析 tools/anim_pack.py testimage 生成的文件
+ *
+ * 文件内容由 anim_pack.py 的 test_pattern 按位置公式生成，这里用同一公式逐字节核对：
+ *   - 文件头 (尺寸、帧数、播放遍数) 和 anim_image_size 算出的大小与文件长度一致；
+ *   - 每帧的显示时长和像素数据；
+ *   - 截断一个字节、改坏魔数或版本号、只有文件头时都被拒绝。
+ * Python 端和固件端对格式 (小端、时长表补齐到 4 字节) 的理解有分歧时在这里暴露。
+ *
+ *   ./host_sim/build/anim_format_test FILE WIDTH HEIGHT FRAMES LOOPS
+ * 退出码：0 通过，1 发现错误
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "anim_format.h"
+
+static int s_failures;
+
+static void expect(bool ok, const char *what)
+{
+    printf("  %-60s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) s_failures++;
+}
+
+// 与 anim_pack.py 的 test_pattern 相同
+static void pattern_pixel(uint32_t frame, uint32_t p, uint8_t rgb[3])
+{
+    rgb[0] = (frame * 7 + p) & 0xFF;
+    rgb[1] = (255 - p - frame) & 0xFF;
+    rgb[2] = (p * 3 + frame * 11) & 0xFF;
+}
+
+static uint16_t pattern_duration(uint32_t frame)
+{
+    return frame == 0 ? 0 : frame == 1 ? 0xFFFF : frame * 33;
+}
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc(size > 0 ? size : 1);
+    if (buf && fread(buf, 1, size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = size;
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 6) {
+        fprintf(stderr, "usage: %s FILE WIDTH HEIGHT FRAMES LOOPS\n", argv[0]);
+        return 1;
+    }
+    size_t len = 0;
+    uint8_t *buf = read_file(argv[1], &len);
+    if (!buf) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    uint16_t width = atoi(argv[2]), height = atoi(argv[3]), frames = atoi(argv[4]), loops = atoi(argv[5]);
+    printf("%s: %u bytes, expect %ux%u, %u frames, loops %u\n", argv[1], (unsigned)len, width, height, frames, loops);
+
+    anim_info_t info;
+    bool parsed = anim_parse(buf, len, &info);
+    expect(parsed, "image accepted");
+    expect(anim_image_size(buf, ANIM_HEADER_LEN) == len, "size from the header equals the file size");
+    if (parsed) {
+        expect(info.width == width && info.height == height, "canvas size");
+        expect(info.frame_count == frames && info.loop_count == loops, "frame count and loops");
+        expect(info.frame_size == (uint32_t)width * height * 3, "frame size");
+        expect((info.frames - buf) % 4 == 0, "frame data 4-byte aligned");
+
+        bool durations_ok = true;
+        bool pixels_ok = true;
+        for (uint16_t i = 0; i < info.frame_count && i < frames; i++) {
+            durations_ok &= anim_frame_duration(&info, i) == pattern_duration(i);
+            const uint8_t *px = anim_frame_data(&info, i);
+            for (uint32_t p = 0; p < (uint32_t)width * height; p++) {
+                uint8_t rgb[3];
+                pattern_pixel(i, p, rgb);
+                if (memcmp(px + p * 3, rgb, 3) != 0) {
+                    if (pixels_ok) printf("  first mismatch: frame %u pixel %u\n", i, (unsigned)p);
+                    pixels_ok = false;
+                }
+            }
+        }
+        expect(durations_ok, "frame durations");
+        expect(pixels_ok, "pixel data of every frame");
+    }
+
+    anim_info_t bad;
+    expect(!anim_parse(buf, len - 1, &bad), "truncated image rejected");
+    expect(!anim_parse(buf, ANIM_HEADER_LEN, &bad), "header only rejected");
+    buf[0] ^= 0xFF;
+    expect(!anim_parse(buf, len, &bad), "bad magic rejected");
+    buf[0] ^= 0xFF;
+    buf[4]++;
+    expect(!anim_parse(buf, len, &bad), "bad version rejected");
+    buf[4]--;
+
+    free(buf);
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,248 @@
+/* 主机模拟：替代 RMT 后端的灯带，刷新时记录下灯带上的颜色和时间戳
+ *
+ * 与真实灯带一样，部分刷新只改变链前段的灯珠，后段保持上次的颜色。
+ * 待发送的像素按灯带原生的颜色顺序存放，也可以由应用用 led_strip_attach_buffer 换成自己的缓冲区。
+ * 多通道设备按 led_strip_rmt_multi_dev.c 的方式分段，发送时间取最长的一段，其余行为与单通道相同。
+ * use_symbol_cache 时与 RMT 后端一样发送一份缓存的副本，只有标记过变化的灯珠 (set_pixel、clear 或
+ * led_strip_mark_changed 报告的) 在刷新时从缓冲区更新，应用漏报的变化在灯带上看得出来。
+ */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/cdefs.h>
+#include <sys/param.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "led_strip.h"
+#include "led_strip_interface.h"
+#include "sim.h"
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+#endif
+
+#define WS2812_BIT_NS       1250
+#define WS2812_RESET_US     280
+
+static const char *TAG = "fake_strip";
+
+void (*sim_on_frame)(const sim_frame_t *frame);
+
+typedef struct {
+    led_strip_t base;
+    uint32_t strip_len;
+    uint8_t bytes_per_pixel;
+    led_color_component_format_t format;
+    size_t num_channels;
+    uint8_t *pending;                   // 待发送的颜色，原生顺序；挂了应用缓冲区时指向它
+    uint8_t *own_pending;               // 自己分配的缓冲区 (external_buffer 时为 NULL)
+    uint8_t *shown;                     // 灯带上当前的颜色，R,G,B
+    uint8_t *cache;                     // use_symbol_cache：代替符号缓存的副本，原生顺序，刷新时发送它
+    uint8_t *dirty;                     // 每颗灯珠一个字节：自上次刷新后有变化
+    bool app_marks;                     // 应用用 led_strip_mark_changed 报告挂上的缓冲区中的变化
+    uint64_t last_cpu_ns;
+} fake_strip_t;
+
+static void fake_mark(fake_strip_t *fake, uint32_t start, uint32_t count)
+{
+    if (fake->dirty) memset(fake->dirty + start, 1, count);
+}
+
+static esp_err_t fake_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    ESP_RETURN_ON_FALSE(index < fake->strip_len, ESP_ERR_INVALID_ARG, TAG, "index out of maximum number of LEDs");
+    ESP_RETURN_ON_FALSE(fake->pending, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+    uint8_t *p = fake->pending + index * fake->bytes_per_pixel;
+    p[fake->format.format.r_pos] = red;
+    p[fake->format.format.g_pos] = green;
+    p[fake->format.format.b_pos] = blue;
+    fake_mark(fake, index, 1);
+    return ESP_OK;
+}
+
+static esp_err_t fake_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
+{
+    ESP_LOGE(TAG, "fake strip has no white component");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t fake_set_pixels(led_strip_t *strip, uint32_t start, const uint8_t *pixels, uint32_t count, led_color_component_format_t src_format)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    ESP_RETURN_ON_FALSE(count <= fake->strip_len && start <= fake->strip_len - count, ESP_ERR_INVALID_ARG, TAG, "pixels out of maximum number of LEDs");
+    if (src_format.format_id == 0) {
+        src_format = fake->format;
+    }
+    uint8_t src_bytes = src_format.format.num_components;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t *p = pixels + i * src_bytes;
+        fake_set_pixel(strip, start + i, p[src_format.format.r_pos], p[src_format.format.g_pos], p[src_format.format.b_pos]);
+    }
+    return ESP_OK;
+}
+
+// 与 led_strip_rmt_multi_dev.c 相同：灯带平分给各通道，除不尽时前面的段各多一颗；各段同时发送自己在
+// 链前 num_leds 颗中的部分，同步启动时没有变化的段也要发一颗。返回最长一段的灯珠数，只用来估算发送时间。
+// 真实驱动的分段和部分刷新由 components/led_strip/bench/led_strip_multi_test 检查
+static uint32_t fake_segment_leds(const fake_strip_t *fake, uint32_t num_leds)
+{
+    uint32_t longest = 0;
+    uint32_t start = 0;
+    for (size_t i = 0; i < fake->num_channels; i++) {
+        uint32_t len = fake->strip_len / fake->num_channels + (i < fake->strip_len % fake->num_channels ? 1 : 0);
+        uint32_t n = num_leds > start ? MIN(num_leds - start, len) : 0;
+        if (fake->num_channels > 1) n = MAX(n, 1);
+        longest = MAX(longest, n);
+        start += len;
+    }
+    return longest;
+}
+
+static esp_err_t fake_refresh_partial_async(led_strip_t *strip, uint32_t num_leds)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    ESP_RETURN_ON_FALSE(num_leds && num_leds <= fake->strip_len, ESP_ERR_INVALID_ARG, TAG, "invalid number of LEDs");
+    ESP_RETURN_ON_FALSE(fake->pending, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+    const uint8_t *src = fake->pending;
+    if (fake->cache) {
+        if (fake->pending != fake->own_pending && !fake->app_marks) fake_mark(fake, 0, num_leds);
+        size_t bpp = fake->bytes_per_pixel;
+        for (uint32_t i = 0; i < fake->strip_len; i++) {
+            if (fake->dirty[i]) memcpy(fake->cache + i * bpp, fake->pending + i * bpp, bpp);
+        }
+        memset(fake->dirty, 0, fake->strip_len);
+        src = fake->cache;
+    }
+    for (uint32_t i = 0; i < num_leds; i++) {
+        const uint8_t *p = src + i * fake->bytes_per_pixel;
+        fake->shown[i * 3 + 0] = p[fake->format.format.r_pos];
+        fake->shown[i * 3 + 1] = p[fake->format.format.g_pos];
+        fake->shown[i * 3 + 2] = p[fake->format.format.b_pos];
+    }
+
+    uint64_t cpu = sim_cpu_ns();
+    uint32_t segment_leds = fake_segment_leds(fake, num_leds);
+    sim_frame_t frame = {
+        .time_us = sim_now_us(),
+        .num_leds = num_leds,
+        .wire_us = (uint32_t)((uint64_t)segment_leds * fake->bytes_per_pixel * 8 * WS2812_BIT_NS / 1000) + WS2812_RESET_US,
+        .cpu_ns = cpu - fake->last_cpu_ns,
+        .rgb = fake->shown,
+        .strip_len = fake->strip_len,
+    };
+    if (sim_on_frame) {
+        sim_on_frame(&frame);
+        sim_cpu_exclude(sim_cpu_ns() - cpu);
+    }
+    fake->last_cpu_ns = cpu;
+    return ESP_OK;
+}
+
+static esp_err_t fake_refresh_async(led_strip_t *strip)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    return fake_refresh_partial_async(strip, fake->strip_len);
+}
+
+// 发送不占用虚拟时间，提交即完成
+static esp_err_t fake_wait_refresh_done(led_strip_t *strip, int32_t timeout_ms)
+{
+    return ESP_OK;
+}
+
+static esp_err_t fake_attach_buffer(led_strip_t *strip, uint8_t *pixels)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    fake->pending = pixels ? pixels : fake->own_pending;
+    fake->app_marks = false;
+    fake_mark(fake, 0, fake->strip_len);
+    return ESP_OK;
+}
+
+static esp_err_t fake_mark_changed(led_strip_t *strip, uint32_t start, uint32_t count)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    ESP_RETURN_ON_FALSE(start <= fake->strip_len && count <= fake->strip_len - start, ESP_ERR_INVALID_ARG, TAG, "pixels out of maximum number of LEDs");
+    fake_mark(fake, start, count);
+    fake->app_marks = true;
+    return ESP_OK;
+}
+
+static esp_err_t fake_clear(led_strip_t *strip)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    ESP_RETURN_ON_FALSE(fake->pending, ESP_ERR_INVALID_STATE, TAG, "no pixel buffer attached");
+    memset(fake->pending, 0, fake->strip_len * fake->bytes_per_pixel);
+    fake_mark(fake, 0, fake->strip_len);
+    return fake_refresh_async(strip);
+}
+
+static esp_err_t fake_del(led_strip_t *strip)
+{
+    fake_strip_t *fake = __containerof(strip, fake_strip_t, base);
+    free(fake->own_pending);
+    free(fake->shown);
+    free(fake->cache);
+    free(fake->dirty);
+    free(fake);
+    return ESP_OK;
+}
+
+static esp_err_t fake_new(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                          size_t num_channels, led_strip_handle_t *ret_strip)
+{
+    ESP_RETURN_ON_FALSE(led_config && rmt_config && ret_strip && led_config->max_leds && num_channels, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    fake_strip_t *fake = calloc(1, sizeof(fake_strip_t));
+    ESP_RETURN_ON_FALSE(fake, ESP_ERR_NO_MEM, TAG, "no mem for fake strip");
+    fake->format = led_config->color_component_format;
+    if (fake->format.format_id == 0) {
+        fake->format = LED_STRIP_COLOR_COMPONENT_FMT_GRB;
+    }
+    fake->bytes_per_pixel = fake->format.format.num_components;
+
+    if (!rmt_config->flags.external_buffer) {
+        fake->own_pending = calloc(led_config->max_leds, fake->bytes_per_pixel);
+    }
+    fake->pending = fake->own_pending;
+    fake->shown = calloc(led_config->max_leds, 3);
+    if (rmt_config->flags.use_symbol_cache) {
+        fake->cache = calloc(led_config->max_leds, fake->bytes_per_pixel);
+        fake->dirty = calloc(led_config->max_leds, 1);
+    }
+    if ((!fake->own_pending && !rmt_config->flags.external_buffer) || !fake->shown ||
+        (rmt_config->flags.use_symbol_cache && (!fake->cache || !fake->dirty))) {
+        fake_del(&fake->base);
+        return ESP_ERR_NO_MEM;
+    }
+
+    fake->strip_len = led_config->max_leds;
+    fake->num_channels = num_channels;
+    fake->last_cpu_ns = sim_cpu_ns();
+
+    fake->base.set_pixel = fake_set_pixel;
+    fake->base.set_pixel_rgbw = fake_set_pixel_rgbw;
+    fake->base.set_pixels = fake_set_pixels;
+    fake->base.refresh = fake_refresh_async;
+    fake->base.refresh_async = fake_refresh_async;
+    fake->base.refresh_partial_async = fake_refresh_partial_async;
+    fake->base.wait_refresh_done = fake_wait_refresh_done;
+    fake->base.attach_buffer = fake_attach_buffer;
+    fake->base.mark_changed = fake_mark_changed;
+    fake->base.clear = fake_clear;
+    fake->base.del = fake_del;
+
+    *ret_strip = &fake->base;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip)
+{
+    return fake_new(led_config, rmt_config, 1, ret_strip);
+}
+
+esp_err_t led_strip_new_rmt_multi_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config,
+                                         const int *gpio_nums, size_t num_channels, led_strip_handle_t *ret_strip)
+{
+    return fake_new(led_config, rmt_config, num_channels, ret_strip);
+}
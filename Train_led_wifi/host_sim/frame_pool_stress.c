@@ -0,0 +1,172 @@
+/* 帧池压力测试：多个写入线程和读取线程真正并发地运行 frame_pool (不经过协作式的模拟调度器)
+ *
+ * 写入线程按固件的方式工作：取空闲槽 -> 拷贝最新帧作底稿 -> 逐字写入自己的标记 (中途随机让出 CPU)
+ * -> 发布。读取线程反复取最新帧 (检查过程中同样随机让出 CPU)，检查：
+ *   - 整帧所有字相同 (没有读到写了一半的帧，也没有读到被回收后正在改写的帧)
+ *   - 同一个写入线程的帧序号不倒退 (发布顺序被保持)
+ * 结束时所有引用都应已释放，只剩最新帧的一个。
+ *
+ *   ./host_sim/build/frame_pool_stress [-w 写线程数] [-r 读线程数] [-n 每个写线程的帧数] [-s 每帧字数]
+ * 退出码：0 通过，1 发现错误
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "frame_pool.h"
+
+#define STRESS_MAX_THREADS  8
+
+static frame_pool_t s_pool;
+static uint32_t *s_frames[FRAME_POOL_MAX_SLOTS];
+static int s_words = 256;
+static int s_frames_per_writer = 20000;
+static atomic_int s_writers_running;
+
+static atomic_ulong s_torn;
+static atomic_ulong s_reordered;
+static atomic_ulong s_reads;
+static atomic_ulong s_acquire_retries;
+
+// 帧标记：高 8 位为写入线程号，低 24 位为该线程的帧序号
+#define STAMP(writer, n)    (((uint32_t)(writer) << 24) | ((n) & 0xFFFFFF))
+
+static uint32_t xorshift(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static void *writer_thread(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    uint32_t rng = 0x9E3779B9u * (id + 1);
+    for (int n = 1; n <= s_frames_per_writer; n++) {
+        int slot;
+        while ((slot = frame_pool_acquire(&s_pool)) < 0) {
+            atomic_fetch_add(&s_acquire_retries, 1);
+            sched_yield();
+        }
+        uint32_t *fb = s_frames[slot];
+
+        int base = frame_pool_get_latest(&s_pool);
+        if (base >= 0) {
+            memcpy(fb, s_frames[base], s_words * sizeof(uint32_t));
+            frame_pool_release(&s_pool, base);
+        }
+        uint32_t stamp = STAMP(id, n);
+        for (int i = 0; i < s_words; i++) {
+            fb[i] = stamp;
+            if ((xorshift(&rng) & 0xFF) == 0) sched_yield();
+        }
+        frame_pool_publish(&s_pool, slot);
+    }
+    atomic_fetch_sub(&s_writers_running, 1);
+    return NULL;
+}
+
+static void *reader_thread(void *arg)
+{
+    uint32_t last_seen[STRESS_MAX_THREADS] = { 0 };
+    uint32_t rng = 0x85EBCA6Bu;
+    while (atomic_load(&s_writers_running) > 0) {
+        int slot = frame_pool_get_latest(&s_pool);
+        if (slot < 0) {
+            sched_yield();
+            continue;
+        }
+        const uint32_t *fb = s_frames[slot];
+        uint32_t stamp = fb[0];
+        for (int i = 1; i < s_words; i++) {
+            if (fb[i] != stamp) {
+                atomic_fetch_add(&s_torn, 1);
+                break;
+            }
+            // 持有引用期间让写入线程运行：被引用的槽不能被重新分配
+            if ((xorshift(&rng) & 0xFF) == 0) sched_yield();
+        }
+        int writer = stamp >> 24;
+        uint32_t n = stamp & 0xFFFFFF;
+        if (writer < STRESS_MAX_THREADS) {
+            if (n < last_seen[writer]) atomic_fetch_add(&s_reordered, 1);
+            last_seen[writer] = n;
+        }
+        frame_pool_release(&s_pool, slot);
+        atomic_fetch_add(&s_reads, 1);
+        // 单核机器上不让出的话写入线程几乎得不到运行
+        sched_yield();
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    int writers = 4;
+    int readers = 2;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:r:n:s:")) != -1) {
+        switch (opt) {
+        case 'w': writers = atoi(optarg); break;
+        case 'r': readers = atoi(optarg); break;
+        case 'n': s_frames_per_writer = atoi(optarg); break;
+        case 's': s_words = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-w writers] [-r readers] [-n frames per writer] [-s words per frame]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (writers < 1 || writers > STRESS_MAX_THREADS || readers < 1 || readers > STRESS_MAX_THREADS ||
+            s_words < 1 || s_frames_per_writer < 1 || s_frames_per_writer > 0xFFFFFF) {
+        fprintf(stderr, "stress: bad arguments\n");
+        return 1;
+    }
+
+    // 与固件相同的槽数规则：每个写入方一个 + 每个读取方一个 + 最新帧
+    int slots = writers + readers + 1;
+    if (slots > FRAME_POOL_MAX_SLOTS) {
+        fprintf(stderr, "stress: %d slots exceed FRAME_POOL_MAX_SLOTS\n", slots);
+        return 1;
+    }
+    frame_pool_init(&s_pool, slots);
+    for (int i = 0; i < slots; i++) {
+        s_frames[i] = calloc(s_words, sizeof(uint32_t));
+        if (!s_frames[i]) return 1;
+    }
+
+    pthread_t threads[2 * STRESS_MAX_THREADS];
+    atomic_store(&s_writers_running, writers);
+    for (int i = 0; i < readers; i++) {
+        pthread_create(&threads[i], NULL, reader_thread, NULL);
+    }
+    for (int i = 0; i < writers; i++) {
+        pthread_create(&threads[readers + i], NULL, writer_thread, (void *)(intptr_t)i);
+    }
+    for (int i = 0; i < readers + writers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    int leaked = 0;
+    int latest = atomic_load(&s_pool.latest);
+    for (int i = 0; i < slots; i++) {
+        int expect = i == latest ? 1 : 0;
+        if (atomic_load(&s_pool.refs[i]) != expect) leaked++;
+    }
+    unsigned long published = frame_pool_seq(&s_pool);
+
+    printf("writers %d, readers %d, slots %d, %d words/frame\n", writers, readers, slots, s_words);
+    printf("published %lu, reads %lu, acquire retries %lu\n", published,
+           atomic_load(&s_reads), atomic_load(&s_acquire_retries));
+    printf("torn %lu, reordered %lu, leaked slots %d\n",
+           atomic_load(&s_torn), atomic_load(&s_reordered), leaked);
+
+    bool ok = atomic_load(&s_torn) == 0 && atomic_load(&s_reordered) == 0 && leaked == 0 &&
+              published == (unsigned long)writers * s_frames_per_writer;
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
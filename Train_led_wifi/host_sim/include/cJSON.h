@@ -0,0 +1,38 @@
+#pragma once
+/* 主机模拟：cJSON 中固件用到的解析与读取接口，实现见 sim_cjson.c (解析按上游移植) */
+#include <stdbool.h>
+
+#define cJSON_Invalid   0
+#define cJSON_False     (1 << 0)
+#define cJSON_True      (1 << 1)
+#define cJSON_NULL      (1 << 2)
+#define cJSON_Number    (1 << 3)
+#define cJSON_String    (1 << 4)
+#define cJSON_Array     (1 << 5)
+#define cJSON_Object    (1 << 6)
+
+typedef struct cJSON {
+    struct cJSON *next;
+    struct cJSON *prev;
+    struct cJSON *child;
+    int type;
+    char *valuestring;
+    int valueint;
+    double valuedouble;
+    char *string;
+} cJSON;
+
+cJSON *cJSON_Parse(const char *value);
+void cJSON_Delete(cJSON *item);
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string);
+int cJSON_GetArraySize(const cJSON *array);
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index);
+bool cJSON_IsBool(const cJSON *item);
+bool cJSON_IsTrue(const cJSON *item);
+bool cJSON_IsNumber(const cJSON *item);
+bool cJSON_IsString(const cJSON *item);
+bool cJSON_IsArray(const cJSON *item);
+bool cJSON_IsObject(const cJSON *item);
+
+#define cJSON_ArrayForEach(element, array) \
+    for (element = (array != NULL) ? (array)->child : NULL; element != NULL; element = element->next)
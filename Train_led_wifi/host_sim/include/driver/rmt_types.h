@@ -0,0 +1,6 @@
+#pragma once
+#include "esp_err.h"
+
+typedef struct rmt_channel_t *rmt_channel_handle_t;
+typedef int rmt_clock_source_t;
+#define RMT_CLK_SRC_DEFAULT 0
@@ -0,0 +1,5 @@
+#pragma once
+#include "esp_err.h"
+
+typedef int spi_host_device_t;
+typedef int spi_clock_source_t;
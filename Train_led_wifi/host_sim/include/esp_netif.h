@@ -0,0 +1,17 @@
+#pragma once
+#include "esp_err.h"
+
+typedef struct { uint32_t addr; } esp_ip4_addr_t;
+typedef struct { esp_ip4_addr_t ip, netmask, gw; } esp_netif_ip_info_t;
+typedef struct { void *esp_netif; esp_netif_ip_info_t ip_info; bool ip_changed; } ip_event_got_ip_t;
+enum { IP_EVENT_STA_GOT_IP };
+
+#define IPSTR           "%d.%d.%d.%d"
+#define esp_ip4_addr1_16(a) ((uint16_t)(((a)->addr >> 0) & 0xff))
+#define esp_ip4_addr2_16(a) ((uint16_t)(((a)->addr >> 8) & 0xff))
+#define esp_ip4_addr3_16(a) ((uint16_t)(((a)->addr >> 16) & 0xff))
+#define esp_ip4_addr4_16(a) ((uint16_t)(((a)->addr >> 24) & 0xff))
+#define IP2STR(ipaddr)  esp_ip4_addr1_16(ipaddr), esp_ip4_addr2_16(ipaddr), esp_ip4_addr3_16(ipaddr), esp_ip4_addr4_16(ipaddr)
+
+esp_err_t esp_netif_init(void);
+void *esp_netif_create_default_wifi_sta(void);
@@ -0,0 +1,9 @@
+#pragma once
+#include "esp_err.h"
+
+// 模拟中重启即结束运行
+void esp_restart(void) __attribute__((noreturn));
+
+// 模拟中没有真实的堆，返回固定值
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
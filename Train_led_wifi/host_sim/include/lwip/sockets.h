@@ -0,0 +1,14 @@
+#pragma once
+/* 使用系统的套接字类型和常量，但不真正收发：socket() 返回 -1，
+ * select() 在没有可用描述符时让任务永久阻塞 (不消耗虚拟时间) */
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+
+int sim_socket(int domain, int type, int protocol);
+int sim_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout);
+#define socket  sim_socket
+#define select  sim_select
@@ -0,0 +1,24 @@
+#pragma once
+#include "esp_err.h"
+
+// 数据保存在内存中 (sim_nvs.c)，可用命令行参数从文件加载、结束时写回
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *name_space, nvs_open_mode_t open_mode, nvs_handle_t *out_handle);
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length);
+
+// 条目数按 ESP-IDF 的存储格式估算，分区大小与 partitions.csv 相同
+typedef struct {
+    size_t used_entries;
+    size_t free_entries;
+    size_t available_entries;           // free_entries 减去留作垃圾回收的一页
+    size_t total_entries;
+    size_t namespace_count;
+} nvs_stats_t;
+
+esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats);
+esp_err_t nvs_get_used_entry_count(nvs_handle_t handle, size_t *used_entries);
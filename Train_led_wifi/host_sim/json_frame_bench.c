@@ -0,0 +1,162 @@
+/* JSON 帧解析速度对比：流式解析 (json_frame.c) 与原来的 cJSON 路径
+ *
+ * 按画布像素数生成 Web 画板格式的帧 ({"brightness":20,"data":[...]}，随机颜色)，每种写法重复解析，
+ * 输出每帧耗时和吞吐量。cJSON 路径包括把整个 Body 拷进 malloc 的缓冲区 (与原来的处理函数相同)；
+ * 流式解析按 TCP 段长度分块喂入。
+ *   - cjson indexed：原来的处理函数，cJSON_GetArrayItem 每次从头遍历，像素多时为平方复杂度
+ *   - cjson foreach：同样建树，但顺序遍历数组，只比较建树本身的开销
+ *   - stream：流式解析，不分配内存
+ * 主机上的 cJSON 与模糊测试相同 (上游源码或 sim_cjson.c，见 CMakeLists.txt)，只用于比较相对快慢；
+ * 设备上的绝对耗时见 /api/stats 的 json_parse。
+ *
+ *   ./host_sim/build/json_frame_bench [-r 重复次数] [像素数...]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cJSON.h"
+#include "json_frame.h"
+#include "json_frame_ref.h"
+
+#define BENCH_CHUNK     1436    // 与模拟器的 TCP 段长度相同
+#define BENCH_MIN_NS    200000000LL
+
+static volatile int s_sink;
+
+static int64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static char *make_frame(uint32_t pixels, size_t *len)
+{
+    char *buf = malloc(pixels * 10 + 64);
+    if (!buf) abort();
+    uint32_t rng = 0x9E3779B9u;
+    size_t n = sprintf(buf, "{\"brightness\":20,\"data\":[");
+    for (uint32_t i = 0; i < pixels; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        // Web 画板的画面大部分是黑色
+        uint32_t color = (rng & 3) ? 0 : rng & 0xFFFFFF;
+        n += sprintf(buf + n, "%s%u", i ? "," : "", (unsigned)color);
+    }
+    n += sprintf(buf + n, "]}");
+    *len = n;
+    return buf;
+}
+
+static void bench_pixel_cb(uint32_t index, int value, void *ctx)
+{
+    ((int *)ctx)[index] = value;
+}
+
+static void run_stream(const char *body, size_t len, uint32_t pixels, int *values)
+{
+    json_frame_parser_t p;
+    json_frame_init(&p, pixels, 20, bench_pixel_cb, values);
+    for (size_t pos = 0; pos < len; pos += BENCH_CHUNK) {
+        size_t n = len - pos < BENCH_CHUNK ? len - pos : BENCH_CHUNK;
+        if (json_frame_feed(&p, body + pos, n) != JSON_FRAME_MORE) break;
+    }
+    s_sink += p.pixels;
+}
+
+static void run_cjson_indexed(const char *body, size_t len, uint32_t pixels, int *values)
+{
+    char *content = malloc(len + 1);
+    memcpy(content, body, len);
+    content[len] = '\0';
+    json_frame_ref_t ref;
+    if (json_frame_ref_parse(content, pixels, 20, values, &ref)) s_sink += ref.pixels;
+    free(content);
+}
+
+static void run_cjson_foreach(const char *body, size_t len, uint32_t pixels, int *values)
+{
+    char *content = malloc(len + 1);
+    memcpy(content, body, len);
+    content[len] = '\0';
+    cJSON *root = cJSON_Parse(content);
+    free(content);
+    if (!root) return;
+    cJSON *data = cJSON_GetObjectItem(root, "data");
+    uint32_t i = 0;
+    cJSON *item;
+    cJSON_ArrayForEach(item, data) {
+        if (i < pixels) values[i] = item->valueint;
+        i++;
+    }
+    s_sink += i;
+    cJSON_Delete(root);
+}
+
+typedef void (*bench_fn_t)(const char *body, size_t len, uint32_t pixels, int *values);
+
+// 至少重复 reps 次且至少运行 BENCH_MIN_NS，返回每帧纳秒数
+static double bench(bench_fn_t fn, const char *body, size_t len, uint32_t pixels, int *values, int reps)
+{
+    fn(body, len, pixels, values);
+    int64_t start = now_ns();
+    int64_t elapsed;
+    long n = 0;
+    do {
+        for (int i = 0; i < reps; i++) fn(body, len, pixels, values);
+        n += reps;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+    return (double)elapsed / n;
+}
+
+int main(int argc, char **argv)
+{
+    int reps = 10;
+    int opt;
+    while ((opt = getopt(argc, argv, "r:")) != -1) {
+        switch (opt) {
+        case 'r': reps = atoi(optarg); break;
+        default:
+            fprintf(stderr, "usage: %s [-r repetitions] [pixels...]\n", argv[0]);
+            return 1;
+        }
+    }
+    static const uint32_t default_sizes[] = { 64, 256, 1024, 4096 };
+    int count = argc - optind;
+    if (count == 0) count = sizeof(default_sizes) / sizeof(default_sizes[0]);
+    if (reps < 1) reps = 1;
+
+    printf("%8s %9s %14s %14s %14s %9s\n", "pixels", "bytes", "cjson indexed", "cjson foreach", "stream", "stream MB/s");
+    for (int k = 0; k < count; k++) {
+        uint32_t pixels = optind < argc ? strtoul(argv[optind + k], NULL, 0) : default_sizes[k];
+        if (pixels < 1) continue;
+        size_t len;
+        char *body = make_frame(pixels, &len);
+        int *expect = calloc(pixels, sizeof(int));
+        int *values = calloc(pixels, sizeof(int));
+
+        // 先确认三种写法结果相同
+        run_cjson_indexed(body, len, pixels, expect);
+        run_stream(body, len, pixels, values);
+        if (memcmp(expect, values, pixels * sizeof(int)) != 0) {
+            fprintf(stderr, "bench: stream result differs from cJSON at %u pixels\n", (unsigned)pixels);
+            return 1;
+        }
+
+        double indexed = bench(run_cjson_indexed, body, len, pixels, values, reps);
+        double foreach = bench(run_cjson_foreach, body, len, pixels, values, reps);
+        double stream = bench(run_stream, body, len, pixels, values, reps);
+        printf("%8u %9zu %11.1f us %11.1f us %11.1f us %9.1f\n", (unsigned)pixels, len,
+               indexed / 1e3, foreach / 1e3, stream / 1e3, len / stream * 1e3);
+        free(body);
+        free(expect);
+        free(values);
+    }
+    printf("cJSON allocates one node per array element (plus the body buffer); stream allocates nothing, parser state %zu bytes\n",
+           sizeof(json_frame_parser_t));
+    return 0;
+}
@@ -0,0 +1,565 @@
+/* JSON 帧流式解析的模糊测试
+ *
+ *   - 随机生成合法的帧 (随机空白、BOM、字段顺序、大小写、转义的键名、重复和多余的字段、各种数字写法、
+ *     非数字元素、任意嵌套、根值之后的多余内容)，结果必须与 cJSON 路径 (json_frame_ref.c) 完全一致；
+ *   - 再对其随机变异 (改字节、插入字节或片段、删除、截断、复制片段)，两边必须同时接受或同时拒绝，
+ *     都接受时结果必须一致；
+ *   - 一组固定的边界输入 (嵌套深度上限、BOM、不完整的代理对、非十六进制的 \u、超长数字等)，
+ *     结果与 cJSON 一致，并且接受与否与写明的期望相同；
+ *   - 每个输入按整块、逐字节和随机分块三种方式喂入，结果必须相同；
+ *   - 回调的像素序号必须从 0 连续递增且小于像素上限。
+ * cJSON 路径在找得到 IDF 的 cJSON.c 时用上游源码编译，否则用按上游移植的 sim_cjson.c (见 CMakeLists.txt)。
+ * 用 AddressSanitizer/UBSan 编译，越界访问直接报错退出。
+ *
+ *   ./host_sim/build/json_frame_fuzz [-n 次数] [-s 种子] [-p 像素上限]
+ * 退出码：0 通过，1 发现错误
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "json_frame.h"
+#include "json_frame_ref.h"
+
+#define FUZZ_DEFAULT_BRIGHTNESS 20
+#define FUZZ_MAX_DEPTH          6
+
+static uint32_t s_rng;
+static uint32_t s_max_pixels = 64;
+
+static uint32_t xorshift(void)
+{
+    uint32_t x = s_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return s_rng = x;
+}
+
+static uint32_t rnd(uint32_t n)
+{
+    return n ? xorshift() % n : 0;
+}
+
+/* ================== 生成合法的帧 ================== */
+
+typedef struct {
+    char *buf;
+    size_t len;
+    size_t size;
+} sbuf_t;
+
+static void sb_putn(sbuf_t *sb, const char *s, size_t n)
+{
+    if (sb->len + n + 1 > sb->size) {
+        sb->size = (sb->len + n + 1) * 2;
+        sb->buf = realloc(sb->buf, sb->size);
+        if (!sb->buf) abort();
+    }
+    memcpy(sb->buf + sb->len, s, n);
+    sb->len += n;
+    sb->buf[sb->len] = '\0';
+}
+
+static void sb_puts(sbuf_t *sb, const char *s)
+{
+    sb_putn(sb, s, strlen(s));
+}
+
+static void gen_ws(sbuf_t *sb)
+{
+    static const char ws[] = " \t\n\r";
+    int n = rnd(4) == 0 ? rnd(3) + 1 : 0;
+    for (int i = 0; i < n; i++) sb_putn(sb, &ws[rnd(4)], 1);
+}
+
+static void gen_number(sbuf_t *sb)
+{
+    static const char *forms[] = {
+        "0", "-0", "1", "255", "16777215", "-1", "-16777216", "2147483647", "-2147483648",
+        "99999999999", "-99999999999", "123.75", "-0.5", "1.5e3", "2E-2", "1e300", "-1e300",
+        "0.0001", "65280.9", "1E6", "4294967295", "007",
+    };
+    char num[32];
+    switch (rnd(4)) {
+    case 0:
+        sb_puts(sb, forms[rnd(sizeof(forms) / sizeof(forms[0]))]);
+        return;
+    case 1:
+        snprintf(num, sizeof(num), "%d", (int)rnd(101));
+        break;
+    default:
+        snprintf(num, sizeof(num), "%u", rnd(0x1000000));
+        break;
+    }
+    sb_puts(sb, num);
+}
+
+static void gen_string(sbuf_t *sb)
+{
+    static const char *pieces[] = {
+        "a", "Z", "0", " ", "data", "brightness", "\\\"", "\\\\", "\\/", "\\n", "\\t", "\\b", "\\f", "\\r",
+        "\\u0041", "\\u00e9", "\\uD83D\\uDE00", "\xc3\xa9", "{", "]", ",", ":", "\\uG000", "\x01",
+    };
+    sb_puts(sb, "\"");
+    int n = rnd(6);
+    for (int i = 0; i < n; i++) sb_puts(sb, pieces[rnd(sizeof(pieces) / sizeof(pieces[0]))]);
+    sb_puts(sb, "\"");
+}
+
+static void gen_value(sbuf_t *sb, int depth);
+
+static void gen_container(sbuf_t *sb, int depth, bool object)
+{
+    sb_puts(sb, object ? "{" : "[");
+    gen_ws(sb);
+    int n = rnd(4);
+    for (int i = 0; i < n; i++) {
+        if (i) {
+            sb_puts(sb, ",");
+            gen_ws(sb);
+        }
+        if (object) {
+            gen_string(sb);
+            gen_ws(sb);
+            sb_puts(sb, ":");
+            gen_ws(sb);
+        }
+        gen_value(sb, depth + 1);
+        gen_ws(sb);
+    }
+    sb_puts(sb, object ? "}" : "]");
+}
+
+static void gen_value(sbuf_t *sb, int depth)
+{
+    int kind = rnd(depth < FUZZ_MAX_DEPTH ? 8 : 6);
+    switch (kind) {
+    case 0:
+    case 1:
+    case 2: gen_number(sb); break;
+    case 3: gen_string(sb); break;
+    case 4: sb_puts(sb, rnd(3) == 0 ? "true" : rnd(2) ? "false" : "null"); break;
+    case 5: gen_number(sb); break;
+    case 6: gen_container(sb, depth, false); break;
+    default: gen_container(sb, depth, true); break;
+    }
+}
+
+static void gen_data_array(sbuf_t *sb)
+{
+    sb_puts(sb, "[");
+    gen_ws(sb);
+    // 元素个数：空、少于、等于和超过像素上限
+    uint32_t n = rnd(4) == 0 ? s_max_pixels + rnd(s_max_pixels / 2 + 2) : rnd(s_max_pixels + 1);
+    for (uint32_t i = 0; i < n; i++) {
+        if (i) {
+            sb_puts(sb, ",");
+            gen_ws(sb);
+        }
+        if (rnd(10) == 0) {
+            gen_value(sb, 2);
+        } else {
+            gen_number(sb);
+        }
+        gen_ws(sb);
+    }
+    sb_puts(sb, "]");
+}
+
+static void gen_key(sbuf_t *sb, int field)
+{
+    static const char *brightness_keys[] = { "brightness", "Brightness", "BRIGHTNESS", "bright\\u006eess", "brightness\\u0000x" };
+    static const char *data_keys[] = { "data", "Data", "DATA", "d\\u0061ta", "data\\u0000", "data\\u00zzx" };
+    static const char *other_keys[] = { "dat", "datas", "brightness2", "ip", "", "\\u00e9", "data " };
+    const char *key;
+    if (field == 0) {
+        key = rnd(3) ? brightness_keys[0] : brightness_keys[rnd(5)];
+    } else if (field == 1) {
+        key = rnd(3) ? data_keys[0] : data_keys[rnd(6)];
+    } else {
+        key = other_keys[rnd(7)];
+    }
+    sb_puts(sb, "\"");
+    sb_puts(sb, key);
+    sb_puts(sb, "\"");
+}
+
+// 根对象：brightness/data 各 0-2 次、0-3 个其它字段，顺序随机
+static void gen_frame(sbuf_t *sb)
+{
+    if (rnd(20) == 0) sb_puts(sb, "\xEF\xBB\xBF");
+    gen_ws(sb);
+    if (rnd(30) == 0) {
+        // 偶尔不是对象
+        gen_value(sb, 0);
+    } else {
+        int fields[8];
+        int n = 0;
+        int bri = rnd(5) == 0 ? (int)rnd(3) : 1;
+        int data = rnd(5) == 0 ? (int)rnd(3) : 1;
+        int other = rnd(4);
+        for (int i = 0; i < bri; i++) fields[n++] = 0;
+        for (int i = 0; i < data; i++) fields[n++] = 1;
+        for (int i = 0; i < other; i++) fields[n++] = 2;
+        for (int i = n - 1; i > 0; i--) {
+            int j = rnd(i + 1);
+            int t = fields[i];
+            fields[i] = fields[j];
+            fields[j] = t;
+        }
+
+        sb_puts(sb, "{");
+        gen_ws(sb);
+        for (int i = 0; i < n; i++) {
+            if (i) {
+                sb_puts(sb, ",");
+                gen_ws(sb);
+            }
+            gen_key(sb, fields[i]);
+            gen_ws(sb);
+            sb_puts(sb, ":");
+            gen_ws(sb);
+            if (fields[i] == 0) {
+                if (rnd(8) == 0) gen_value(sb, 1); else gen_number(sb);
+            } else if (fields[i] == 1) {
+                if (rnd(8) == 0) gen_value(sb, 1); else gen_data_array(sb);
+            } else {
+                gen_value(sb, 1);
+            }
+            gen_ws(sb);
+        }
+        sb_puts(sb, "}");
+    }
+    gen_ws(sb);
+    // 根值之后的内容两边都忽略 (根值是数字时，紧跟的数字字符也算尾部内容)
+    static const char *trailing[] = { "garbage", "{\"data\":[1]}", "-1", "e5.", "\"" };
+    if (rnd(10) == 0) sb_puts(sb, trailing[rnd(5)]);
+}
+
+/* ================== 变异 ================== */
+
+static void mutate(sbuf_t *sb)
+{
+    static const char interesting[] = "{}[]\",:0123456789-+.eE \t\\untrlfas\x01\x7f\xc3";
+    static const char *tokens[] = { "\\uD83D", "\\uDC00", "\\u", "\\\"", "\\\\", "\xEF\xBB\xBF", "1e", "-", "[[[[", "0000000000" };
+    int ops = rnd(4) + 1;
+    for (int k = 0; k < ops && sb->len > 0; k++) {
+        size_t pos = rnd(sb->len);
+        char c = rnd(4) ? interesting[rnd(sizeof(interesting) - 1)] : (char)rnd(256);
+        switch (rnd(6)) {
+        case 0:
+            sb->buf[pos] = c;
+            break;
+        case 1:
+            sb_putn(sb, " ", 1);
+            memmove(sb->buf + pos + 1, sb->buf + pos, sb->len - pos - 1);
+            sb->buf[pos] = c;
+            break;
+        case 2:
+            memmove(sb->buf + pos, sb->buf + pos + 1, sb->len - pos);
+            sb->len--;
+            break;
+        case 3:
+            sb->len = pos;
+            sb->buf[pos] = '\0';
+            break;
+        case 4: {
+            const char *t = tokens[rnd(sizeof(tokens) / sizeof(tokens[0]))];
+            size_t n = strlen(t);
+            size_t old_len = sb->len;
+            sb_putn(sb, t, n);
+            memmove(sb->buf + pos + n, sb->buf + pos, old_len - pos);
+            memcpy(sb->buf + pos, t, n);
+            break;
+        }
+        default: {
+            size_t avail = sb->len - pos;
+            size_t n = rnd(avail < 16 ? avail : 16) + 1;
+            char tmp[16];
+            memcpy(tmp, sb->buf + pos, n);
+            size_t at = rnd(sb->len + 1);
+            size_t old_len = sb->len;
+            sb_putn(sb, tmp, n);
+            memmove(sb->buf + at + n, sb->buf + at, old_len - at);
+            memcpy(sb->buf + at, tmp, n);
+            break;
+        }
+        }
+    }
+}
+
+/* ================== 解析与比较 ================== */
+
+typedef struct {
+    json_frame_status_t status;
+    bool has_data;
+    bool brightness_after_data;
+    int brightness;
+    uint32_t pixels;
+    uint32_t calls;
+    bool bad_index;
+    int *values;
+} stream_result_t;
+
+static void fuzz_pixel_cb(uint32_t index, int value, void *ctx)
+{
+    stream_result_t *r = ctx;
+    if (index != r->calls || index >= s_max_pixels) {
+        r->bad_index = true;
+        return;
+    }
+    r->values[index] = value;
+    r->calls++;
+}
+
+// chunk 为 0 时每块长度随机
+static void stream_parse(const char *buf, size_t len, size_t chunk, stream_result_t *r)
+{
+    json_frame_parser_t p;
+    memset(r->values, 0, s_max_pixels * sizeof(int));
+    r->calls = 0;
+    r->bad_index = false;
+    json_frame_init(&p, s_max_pixels, FUZZ_DEFAULT_BRIGHTNESS, fuzz_pixel_cb, r);
+
+    json_frame_status_t status = JSON_FRAME_MORE;
+    size_t pos = 0;
+    while (pos < len && status == JSON_FRAME_MORE) {
+        size_t n = chunk ? chunk : rnd(64) + 1;
+        if (n > len - pos) n = len - pos;
+        status = json_frame_feed(&p, buf + pos, n);
+        pos += n;
+    }
+    if (status == JSON_FRAME_MORE) status = json_frame_finish(&p);
+
+    r->status = status;
+    r->has_data = p.has_data;
+    r->brightness_after_data = p.brightness_after_data;
+    r->brightness = p.brightness;
+    r->pixels = p.pixels;
+}
+
+static bool stream_equal(const stream_result_t *a, const stream_result_t *b)
+{
+    if (a->status != b->status) return false;
+    if (a->status != JSON_FRAME_DONE) return true;
+    return a->has_data == b->has_data && a->brightness == b->brightness && a->pixels == b->pixels &&
+           a->brightness_after_data == b->brightness_after_data && a->calls == b->calls &&
+           memcmp(a->values, b->values, a->calls * sizeof(int)) == 0;
+}
+
+static bool ref_equal(const stream_result_t *s, const json_frame_ref_t *ref, const int *ref_values)
+{
+    if (s->has_data != ref->has_data || s->brightness != ref->brightness) return false;
+    if (!ref->has_data) return true;
+    uint32_t n = ref->pixels < s_max_pixels ? ref->pixels : s_max_pixels;
+    return s->pixels == ref->pixels && s->calls == n && memcmp(s->values, ref_values, n * sizeof(int)) == 0;
+}
+
+static void dump_input(const char *what, const sbuf_t *sb)
+{
+    fprintf(stderr, "%s (%zu bytes): ", what, sb->len);
+    for (size_t i = 0; i < sb->len && i < 400; i++) {
+        unsigned char c = sb->buf[i];
+        if (c >= 0x20 && c < 0x7F) fputc(c, stderr); else fprintf(stderr, "\\x%02x", c);
+    }
+    fputc('\n', stderr);
+}
+
+enum { OUTCOME_ACCEPT, OUTCOME_REJECT, OUTCOME_FAIL };
+
+static int *s_ref_values;
+static stream_result_t s_whole, s_bytes, s_chunks;
+
+// 按三种分块方式流式解析，再走 cJSON 路径 (与原来的处理函数一样把 Body 当作 C 字符串)，比较结果
+static int check_input(const sbuf_t *sb)
+{
+    stream_parse(sb->buf, sb->len, sb->len ? sb->len : 1, &s_whole);
+    stream_parse(sb->buf, sb->len, 1, &s_bytes);
+    stream_parse(sb->buf, sb->len, 0, &s_chunks);
+    if (s_whole.bad_index || s_bytes.bad_index || s_chunks.bad_index) {
+        dump_input("pixel index out of order or range", sb);
+        return OUTCOME_FAIL;
+    }
+    if (!stream_equal(&s_whole, &s_bytes) || !stream_equal(&s_whole, &s_chunks)) {
+        dump_input("result depends on chunking", sb);
+        return OUTCOME_FAIL;
+    }
+
+    json_frame_ref_t ref;
+    bool ref_ok = json_frame_ref_parse(sb->buf, s_max_pixels, FUZZ_DEFAULT_BRIGHTNESS, s_ref_values, &ref);
+    bool stream_ok = s_whole.status == JSON_FRAME_DONE;
+    if (ref_ok != stream_ok) {
+        dump_input(ref_ok ? "only cJSON accepts" : "only stream accepts", sb);
+        return OUTCOME_FAIL;
+    }
+    if (!ref_ok) return OUTCOME_REJECT;
+    if (!ref_equal(&s_whole, &ref, s_ref_values)) {
+        dump_input("result differs from cJSON", sb);
+        fprintf(stderr, "  cJSON: data %d, %u pixels, brightness %d; stream: data %d, %u pixels, brightness %d\n",
+                ref.has_data, (unsigned)ref.pixels, ref.brightness,
+                s_whole.has_data, (unsigned)s_whole.pixels, s_whole.brightness);
+        return OUTCOME_FAIL;
+    }
+    return OUTCOME_ACCEPT;
+}
+
+/* ================== 固定的边界输入 ================== */
+
+typedef struct {
+    const char *input;
+    size_t len;             // 0 表示按 C 字符串
+    bool accept;
+} fixed_case_t;
+
+#define FIXED_BIN(s)    s, sizeof(s) - 1     // 含 '\0' 的输入
+
+static const fixed_case_t s_fixed_cases[] = {
+    // 空白为 0x01-0x20，开头的 BOM 跳过，但 BOM 必须在最前面且完整
+    { "\x01{\x1f\"data\"\x02:[1]}", 0, true },
+    { "\xEF\xBB\xBF{\"data\":[1]}", 0, true },
+    { " \xEF\xBB\xBF{\"data\":[1]}", 0, false },
+    { "\xEF\xBB{\"data\":[1]}", 0, false },
+    // 字符串中的控制字符原样接受，'\0' 结束输入
+    { "{\"a\":\"\x01\x1f\",\"data\":[2]}", 0, true },
+    { FIXED_BIN("{\"data\":[1]}\0garbage"), true },
+    { FIXED_BIN("{\"data\":[1\0]}"), false },
+    { FIXED_BIN("{\"a\":\"x\0\",\"data\":[1]}"), false },
+    // 代理对必须完整
+    { "{\"a\":\"\\uD83D\\uDE00\",\"data\":[3]}", 0, true },
+    { "{\"a\":\"\\uD83D\",\"data\":[3]}", 0, false },
+    { "{\"a\":\"\\uDE00\",\"data\":[3]}", 0, false },
+    { "{\"a\":\"\\uD83D\\u0041\",\"data\":[3]}", 0, false },
+    { "{\"a\":\"\\uD83Dx12345\",\"data\":[3]}", 0, false },
+    // 非十六进制字符使码元为 0：键名截断成 data
+    { "{\"data\\uZZZZ!\":[4]}", 0, true },
+    { "{\"a\":\"\\u12\"}", 0, false },
+    // \u 固定占 6 个字节，跨过 \" 或 \\ 转义对
+    { "{\"a\":\"\\u12\\\"x\",\"data\":[5]}", 0, true },
+    { "{\"a\":\"\\u123\\\\\",\"data\":[5]}", 0, true },
+    // 根值的数字只需开头可以转换，容器中必须整个可以转换
+    { "12-3", 0, true },
+    { "1e", 0, true },
+    { "-.5", 0, true },
+    { "-", 0, false },
+    { "-x", 0, false },
+    { "{\"data\":[1e]}", 0, false },
+    { "{\"data\":[-.5,1.,00]}", 0, true },
+    { "{\"data\":[1-2]}", 0, false },
+    // 数字最长 63 个字符
+    { "{\"data\":[100000000000000000000000000000000000000000000000000000000000000]}", 0, true },
+    { "{\"data\":[1000000000000000000000000000000000000000000000000000000000000000]}", 0, false },
+    { "1000000000000000000000000000000000000000000000000000000000000000", 0, true },
+};
+
+// 嵌套 depth 层数组，最里层放一个数字；object 为 true 时最外层是带 data 字段的对象
+static void gen_nested(sbuf_t *sb, int depth, bool object)
+{
+    if (object) {
+        sb_puts(sb, "{\"data\":[1],\"x\":");
+        depth--;
+    }
+    for (int i = 0; i < depth; i++) sb_puts(sb, "[");
+    sb_puts(sb, "1");
+    for (int i = 0; i < depth; i++) sb_puts(sb, "]");
+    if (object) sb_puts(sb, "}");
+}
+
+static unsigned long check_fixed(sbuf_t *sb)
+{
+    unsigned long failures = 0;
+    for (size_t i = 0; i < sizeof(s_fixed_cases) / sizeof(s_fixed_cases[0]); i++) {
+        const fixed_case_t *c = &s_fixed_cases[i];
+        sb->len = 0;
+        sb_putn(sb, c->input, c->len ? c->len : strlen(c->input));
+        int outcome = check_input(sb);
+        if (outcome == OUTCOME_FAIL) {
+            failures++;
+        } else if ((outcome == OUTCOME_ACCEPT) != c->accept) {
+            dump_input(c->accept ? "fixed case rejected" : "fixed case accepted", sb);
+            failures++;
+        }
+    }
+
+    // 嵌套深度上限与 cJSON 相同
+    for (int object = 0; object < 2; object++) {
+        for (int depth = JSON_FRAME_MAX_DEPTH; depth <= JSON_FRAME_MAX_DEPTH + 1; depth++) {
+            sb->len = 0;
+            gen_nested(sb, depth, object);
+            int outcome = check_input(sb);
+            bool accept = depth <= JSON_FRAME_MAX_DEPTH;
+            if (outcome == OUTCOME_FAIL || (outcome == OUTCOME_ACCEPT) != accept) {
+                if (outcome != OUTCOME_FAIL) dump_input(accept ? "nesting limit too low" : "nesting limit too high", sb);
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long iterations = 20000;
+    uint32_t seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:p:")) != -1) {
+        switch (opt) {
+        case 'n': iterations = strtoul(optarg, NULL, 0); break;
+        case 's': seed = strtoul(optarg, NULL, 0); break;
+        case 'p': s_max_pixels = strtoul(optarg, NULL, 0); break;
+        default:
+            fprintf(stderr, "usage: %s [-n iterations] [-s seed] [-p max pixels]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (s_max_pixels < 1 || seed == 0) {
+        fprintf(stderr, "fuzz: bad arguments\n");
+        return 1;
+    }
+    s_rng = seed;
+
+    s_ref_values = calloc(s_max_pixels, sizeof(int));
+    s_whole.values = calloc(s_max_pixels, sizeof(int));
+    s_bytes.values = calloc(s_max_pixels, sizeof(int));
+    s_chunks.values = calloc(s_max_pixels, sizeof(int));
+    sbuf_t sb = { 0 };
+    unsigned long valid_ok = 0, both_accept = 0, both_reject = 0;
+    unsigned long failures = check_fixed(&sb);
+    unsigned long fixed_failures = failures;
+
+    for (unsigned long it = 0; it < iterations && failures < 5; it++) {
+        sb.len = 0;
+        gen_frame(&sb);
+        // 一半的输入保持合法，一半变异
+        bool mutated = it & 1;
+        if (mutated) mutate(&sb);
+
+        int outcome = check_input(&sb);
+        if (outcome == OUTCOME_FAIL) {
+            failures++;
+        } else if (!mutated && outcome != OUTCOME_ACCEPT) {
+            dump_input("generator produced a frame cJSON rejects", &sb);
+            failures++;
+        } else if (!mutated) {
+            valid_ok++;
+        } else if (outcome == OUTCOME_ACCEPT) {
+            both_accept++;
+        } else {
+            both_reject++;
+        }
+    }
+
+    printf("seed %u, %lu inputs, max %u pixels\n", seed, iterations, (unsigned)s_max_pixels);
+    printf("fixed cases: %zu, %lu failed\n", sizeof(s_fixed_cases) / sizeof(s_fixed_cases[0]) + 4, fixed_failures);
+    printf("valid frames matching cJSON %lu\n", valid_ok);
+    printf("mutated: both accept (matching) %lu, both reject %lu\n", both_accept, both_reject);
+    printf("%s\n", failures ? "FAIL" : "PASS");
+
+    free(sb.buf);
+    free(s_ref_values);
+    free(s_whole.values);
+    free(s_bytes.values);
+    free(s_chunks.values);
+    return failures ? 1 : 0;
+}
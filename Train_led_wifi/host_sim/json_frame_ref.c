@@ -0,0 +1,28 @@
+/* 对照实现，说明见 json_frame_ref.h */
+#include "cJSON.h"
+#include "json_frame_ref.h"
+
+bool json_frame_ref_parse(const char *body, uint32_t max_pixels, int default_brightness,
+                          int *values, json_frame_ref_t *out)
+{
+    cJSON *root = cJSON_Parse(body);
+    if (!root) return false;
+
+    *out = (json_frame_ref_t) { .brightness = default_brightness };
+    cJSON *bri_item = cJSON_GetObjectItem(root, "brightness");
+    if (bri_item) out->brightness = bri_item->valueint;
+
+    cJSON *data_array = cJSON_GetObjectItem(root, "data");
+    if (cJSON_IsArray(data_array)) {
+        // 与原来的处理函数相同，逐个 cJSON_GetArrayItem (每次从头遍历链表)
+        out->has_data = true;
+        int array_size = cJSON_GetArraySize(data_array);
+        for (int i = 0; i < array_size && i < (int)max_pixels; i++) {
+            cJSON *item = cJSON_GetArrayItem(data_array, i);
+            if (item) values[i] = item->valueint;
+        }
+        out->pixels = array_size;
+    }
+    cJSON_Delete(root);
+    return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+/* 对照实现：原来 POST /api/matrix 的 cJSON 写法 (整个 Body 建树后取字段)，供模糊测试和基准比较 */
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    bool has_data;          // data 字段是数组
+    int brightness;
+    uint32_t pixels;        // data 数组的元素个数
+} json_frame_ref_t;
+
+// body 以 '\0' 结尾；values 至少 max_pixels 个，写入 data 的前 max_pixels 个元素；cJSON 解析失败返回 false
+bool json_frame_ref_parse(const char *body, uint32_t max_pixels, int default_brightness,
+                          int *values, json_frame_ref_t *out);
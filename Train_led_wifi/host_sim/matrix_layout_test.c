@@ -0,0 +1,212 @@
+/* 走线映射测试：matrix_layout.c 生成的查找表与按物理走线推出的灯带索引对比
+ *
+ * 对每种组合 (4 个起点角 x 蛇形/同向 x 4 个旋转角度 x 镜像，面板 5x3 和 4x4，单块及 2x2 拼接、
+ * 拼接蛇形/同向) 检查：
+ *   - 查找表是 0..N-1 的一个排列 (每颗灯珠正好对应一个像素)；
+ *   - 每块面板四个角的灯带索引：起点角为面板的第 0 颗，同一行的另一端为 width-1，
+ *     最后一行两端取决于行数奇偶和是否蛇形；画面的角经镜像、顺时针旋转后落在面板的哪个角；
+ *   - 拼接时相邻面板在接缝两侧的像素分别属于各自面板，面板序号按串联顺序 (蛇形时奇数行反向)。
+ * 角上的期望值不经过 matrix_layout.c 的坐标变换，按物理走线单独推出。
+ *
+ *   ./host_sim/build/matrix_layout_test
+ * 退出码：0 通过，1 发现错误
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "matrix_layout.h"
+
+// 面板的物理角 (从正面看)，按顺时针排列，画面顺时针旋转 90 度时每个角移到下一个
+enum { CORNER_TL, CORNER_TR, CORNER_BR, CORNER_BL };
+
+static const char *const s_origin_names[] = { "top-left", "top-right", "bottom-left", "bottom-right" };
+static int s_failures;
+static int s_checks;
+
+static void expect(bool ok, const char *variant, const char *what)
+{
+    s_checks++;
+    if (!ok) {
+        printf("  %-64s %s FAIL\n", variant, what);
+        s_failures++;
+    }
+}
+
+static int origin_corner(layout_origin_t origin)
+{
+    switch (origin) {
+    case LAYOUT_ORIGIN_TOP_RIGHT: return CORNER_TR;
+    case LAYOUT_ORIGIN_BOTTOM_LEFT: return CORNER_BL;
+    case LAYOUT_ORIGIN_BOTTOM_RIGHT: return CORNER_BR;
+    default: return CORNER_TL;
+    }
+}
+
+static bool corner_is_left(int corner)
+{
+    return corner == CORNER_TL || corner == CORNER_BL;
+}
+
+static bool corner_is_top(int corner)
+{
+    return corner == CORNER_TL || corner == CORNER_TR;
+}
+
+// 面板物理角上的灯珠在面板内的灯带索引
+static uint32_t corner_index(const matrix_layout_t *layout, int corner)
+{
+    int origin = origin_corner(layout->origin);
+    uint32_t w = layout->width, h = layout->height;
+    bool same_row = corner_is_top(corner) == corner_is_top(origin);
+    bool same_column = corner_is_left(corner) == corner_is_left(origin);
+    if (same_row) return same_column ? 0 : w - 1;
+    // 最后一行：同向走线或从起点一侧开始 (蛇形且最后一行为偶数行) 时，起点一侧是该行第一颗
+    bool last_row_from_origin_side = !layout->serpentine || ((h - 1) & 1) == 0;
+    uint32_t row = (h - 1) * w;
+    return same_column == last_row_from_origin_side ? row : row + w - 1;
+}
+
+// 画面的角 (逻辑坐标) 显示在面板的哪个物理角：先左右镜像，再顺时针旋转
+static int logical_to_physical_corner(const matrix_layout_t *layout, int corner)
+{
+    if (layout->mirror) {
+        static const int mirrored[] = { [CORNER_TL] = CORNER_TR, [CORNER_TR] = CORNER_TL,
+                                        [CORNER_BR] = CORNER_BL, [CORNER_BL] = CORNER_BR };
+        corner = mirrored[corner];
+    }
+    return (corner + layout->rotation / 90) % 4;
+}
+
+static void check_variant(const matrix_layout_t *layout, const matrix_tiling_t *tiling)
+{
+    char variant[128];
+    snprintf(variant, sizeof(variant), "%ux%u %-12s %-10s rot %3u%s, tiles %ux%u%s",
+             layout->width, layout->height, s_origin_names[layout->origin],
+             layout->serpentine ? "serpentine" : "progressive", layout->rotation, layout->mirror ? " mirror" : "",
+             tiling->tiles_x, tiling->tiles_y, tiling->serpentine ? " serpentine" : "");
+
+    uint32_t panel = (uint32_t)layout->width * layout->height;
+    uint32_t total = panel * tiling->tiles_x * tiling->tiles_y;
+    uint16_t *lut = malloc(total * sizeof(uint16_t));
+    if (!matrix_layout_build_tiled(layout, tiling, lut, total)) {
+        expect(false, variant, "build");
+        free(lut);
+        return;
+    }
+
+    // 排列
+    uint8_t *seen = calloc(total, 1);
+    bool permutation = true;
+    for (uint32_t i = 0; i < total; i++) {
+        if (lut[i] >= total || seen[lut[i]]++) permutation = false;
+    }
+    expect(permutation, variant, "permutation");
+    free(seen);
+
+    uint32_t lw = matrix_layout_logical_width(layout);
+    uint32_t lh = matrix_layout_logical_height(layout);
+    uint32_t canvas_w = lw * tiling->tiles_x;
+    expect(lw * lh == panel && (layout->rotation % 180 ? lw == layout->height : lw == layout->width),
+           variant, "logical size");
+
+    // 每块面板的四个角；相邻面板的角在接缝两侧相邻，一并覆盖了接缝
+    for (uint32_t ty = 0; ty < tiling->tiles_y; ty++) {
+        for (uint32_t tx = 0; tx < tiling->tiles_x; tx++) {
+            uint32_t chain = (tiling->serpentine && (ty & 1)) ? tiling->tiles_x - 1 - tx : tx;
+            uint32_t base = (ty * tiling->tiles_x + chain) * panel;
+            for (int corner = CORNER_TL; corner <= CORNER_BL; corner++) {
+                uint32_t x = tx * lw + (corner_is_left(corner) ? 0 : lw - 1);
+                uint32_t y = ty * lh + (corner_is_top(corner) ? 0 : lh - 1);
+                uint32_t want = base + corner_index(layout, logical_to_physical_corner(layout, corner));
+                char what[64];
+                snprintf(what, sizeof(what), "tile %u,%u corner (%u,%u): %u, want %u", tx, ty, x, y,
+                         lut[y * canvas_w + x], want);
+                expect(lut[y * canvas_w + x] == want, variant, what);
+            }
+        }
+    }
+    free(lut);
+}
+
+// 常见的几种面板，逐个写出的期望值
+static void check_known(void)
+{
+    uint16_t lut[64];
+    // 8x8 蛇形、左上角起点：第二行从右往左
+    matrix_layout_t layout = { .width = 8, .height = 8, .origin = LAYOUT_ORIGIN_TOP_LEFT, .serpentine = true };
+    matrix_layout_build(&layout, lut, 64);
+    expect(lut[0] == 0 && lut[7] == 7 && lut[8] == 15 && lut[15] == 8 && lut[56] == 63 && lut[63] == 56,
+           "8x8 top-left serpentine", "known indices");
+    // 同上，顺时针旋转 90 度：画面左上角在面板右上角
+    layout.rotation = 90;
+    matrix_layout_build(&layout, lut, 64);
+    expect(lut[0] == 7 && lut[1] == 8 && lut[7] == 56 && lut[56] == 0 && lut[63] == 63, "8x8 top-left serpentine rot 90",
+           "known indices");
+    // 4x2 同向、右下角起点，两块左右拼接：右边的面板接在左边之后
+    layout = (matrix_layout_t) { .width = 4, .height = 2, .origin = LAYOUT_ORIGIN_BOTTOM_RIGHT };
+    matrix_tiling_t tiling = { .tiles_x = 2, .tiles_y = 1 };
+    matrix_layout_build_tiled(&layout, &tiling, lut, 16);
+    static const uint16_t want[16] = { 7, 6, 5, 4, 15, 14, 13, 12, 3, 2, 1, 0, 11, 10, 9, 8 };
+    expect(memcmp(lut, want, sizeof(want)) == 0, "4x2 bottom-right progressive, tiles 2x1", "known indices");
+}
+
+static void check_invalid(void)
+{
+    uint16_t lut[64];
+    matrix_layout_t layout = { .width = 8, .height = 8 };
+    matrix_tiling_t tiling = { .tiles_x = 1, .tiles_y = 1 };
+    expect(!matrix_layout_build(&layout, lut, 63), "8x8", "rejects short lut");
+    layout.rotation = 45;
+    expect(!matrix_layout_build(&layout, lut, 64), "8x8 rot 45", "rejects rotation");
+    layout.rotation = 360;
+    expect(!matrix_layout_build(&layout, lut, 64), "8x8 rot 360", "rejects rotation");
+    layout = (matrix_layout_t) { .width = 0, .height = 8 };
+    expect(!matrix_layout_build(&layout, lut, 64), "0x8", "rejects empty panel");
+    layout.width = 8;
+    tiling.tiles_x = 0;
+    expect(!matrix_layout_build_tiled(&layout, &tiling, lut, 64), "8x8 tiles 0x1", "rejects empty tiling");
+    // 超过 16 位索引
+    layout = (matrix_layout_t) { .width = 256, .height = 256 };
+    tiling = (matrix_tiling_t) { .tiles_x = 2, .tiles_y = 1 };
+    expect(!matrix_layout_build_tiled(&layout, &tiling, lut, SIZE_MAX), "256x256 tiles 2x1", "rejects > 65536 LEDs");
+}
+
+int main(void)
+{
+    static const uint16_t sizes[][2] = { { 5, 3 }, { 4, 4 } };
+    static const matrix_tiling_t tilings[] = {
+        { .tiles_x = 1, .tiles_y = 1 },
+        { .tiles_x = 2, .tiles_y = 2, .serpentine = false },
+        { .tiles_x = 2, .tiles_y = 2, .serpentine = true },
+        { .tiles_x = 3, .tiles_y = 3, .serpentine = true },
+    };
+    int variants = 0;
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (int origin = LAYOUT_ORIGIN_TOP_LEFT; origin <= LAYOUT_ORIGIN_BOTTOM_RIGHT; origin++) {
+            for (int serpentine = 0; serpentine < 2; serpentine++) {
+                for (uint16_t rotation = 0; rotation < 360; rotation += 90) {
+                    for (int mirror = 0; mirror < 2; mirror++) {
+                        for (size_t t = 0; t < sizeof(tilings) / sizeof(tilings[0]); t++) {
+                            matrix_layout_t layout = {
+                                .width = sizes[s][0],
+                                .height = sizes[s][1],
+                                .origin = origin,
+                                .serpentine = serpentine,
+                                .rotation = rotation,
+                                .mirror = mirror,
+                            };
+                            check_variant(&layout, &tilings[t]);
+                            variants++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    check_known();
+    check_invalid();
+
+    printf("%d layouts, %d checks, %d failed\n", variants, s_checks, s_failures);
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,217 @@
+/* 状态保存测试：persist.c 运行在内存中的 NVS (sim_nvs.c) 和虚拟时钟上，模拟客户端推流，统计写 flash 的次数
+ *
+ * 按固件的方式驱动：修改方调用 persist_mark_dirty (返回 true 时唤醒保存任务)，
+ * 保存任务在 persist_poll 返回的时间后再次调用。检查：
+ *   - 持续推流时写入次数受 max_delay 限制，间歇推流时受 min_interval 限制；
+ *   - 推流停止后最后一帧在 quiet + min_interval 之内写入；
+ *   - 内容没变的条目不写入；
+ *   - "重启" 后 (新的 persist_t，同一个 NVS) 能读回最后一帧，重复的内容不再写入；
+ *   - 启动时的空间检查：8x8 画面放得下 24 KB 的 nvs 分区，64x64 的放不下。
+ *
+ *   ./host_sim/build/persist_test
+ * 退出码：0 通过，1 发现错误
+ */
+#include <stdio.h>
+#include <string.h>
+#include "persist.h"
+#include "sim.h"
+
+// 与固件相同的参数
+#define QUIET_MS            2000
+#define MIN_INTERVAL_MS     10000
+#define MAX_DELAY_MS        (5 * 60 * 1000)
+#define FRAME_BYTES         (8 * 8 * 3)         // 只保存 8 位整数部分
+
+static uint8_t s_frame[FRAME_BYTES];
+static uint8_t s_level = 100;
+static bool s_frame_valid = true;
+static int s_failures;
+
+static bool snapshot_frame(void *buf, void *ctx)
+{
+    if (s_frame_valid) memcpy(buf, s_frame, FRAME_BYTES);
+    return s_frame_valid;
+}
+
+static bool snapshot_level(void *buf, void *ctx)
+{
+    *(uint8_t *)buf = s_level;
+    return true;
+}
+
+static persist_entry_t s_entries[2];
+static persist_t s_persist;
+
+static void persist_setup(void)
+{
+    s_entries[0] = (persist_entry_t) { .key = "frame", .size = FRAME_BYTES, .snapshot = snapshot_frame };
+    s_entries[1] = (persist_entry_t) { .key = "level", .size = 1, .snapshot = snapshot_level };
+    s_persist = (persist_t) {
+        .name_space = "matrix",
+        .entries = s_entries,
+        .count = 2,
+        .quiet_ms = QUIET_MS,
+        .min_interval_ms = MIN_INTERVAL_MS,
+        .max_delay_ms = MAX_DELAY_MS,
+    };
+    if (persist_init(&s_persist) != ESP_OK) {
+        printf("persist_init failed\n");
+        s_failures++;
+    }
+}
+
+/* ---- 虚拟时钟上的保存任务 ---- */
+
+static uint32_t s_now;
+static uint32_t s_next_poll = UINT32_MAX;      // 保存任务下一次醒来的时间
+static bool s_unsaved;                         // 有还没写入 flash 的画面
+static uint32_t s_unsaved_since;
+static uint32_t s_max_save_delay;              // 画面修改到写入 flash 的最长时间
+
+static void poll_until(uint32_t t)
+{
+    while (s_next_poll <= t) {
+        s_now = s_next_poll;
+        uint32_t writes = s_persist.writes;
+        uint32_t wait = persist_poll(&s_persist, s_now);
+        if (s_persist.writes != writes && s_unsaved) {
+            s_max_save_delay = MAX(s_max_save_delay, s_now - s_unsaved_since);
+            s_unsaved = false;
+        }
+        s_next_poll = wait == PERSIST_IDLE ? UINT32_MAX : s_now + wait;
+    }
+    s_now = t;
+}
+
+static void mark(void)
+{
+    if (persist_mark_dirty(&s_persist, s_now) && s_next_poll > s_now) {
+        s_next_poll = s_now;
+    }
+}
+
+static void push_frame(uint32_t n)
+{
+    memset(s_frame, 0, sizeof(s_frame));
+    memcpy(s_frame, &n, sizeof(n));
+    if (!s_unsaved) {
+        s_unsaved = true;
+        s_unsaved_since = s_now;
+    }
+    mark();
+}
+
+// period_ms 间隔推 count 帧，每帧内容不同
+static void stream(uint32_t count, uint32_t period_ms, uint32_t *n)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        poll_until(s_now + period_ms);
+        push_frame((*n)++);
+    }
+}
+
+/* ---- 检查 ---- */
+
+static void expect(bool ok, const char *what)
+{
+    printf("  %-60s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) s_failures++;
+}
+
+static bool stored_frame_is_current(void)
+{
+    uint8_t buf[FRAME_BYTES];
+    size_t len = sizeof(buf);
+    return nvs_get_blob(s_persist.nvs, "frame", buf, &len) == ESP_OK && len == FRAME_BYTES &&
+           memcmp(buf, s_frame, FRAME_BYTES) == 0;
+}
+
+int main(void)
+{
+    persist_setup();
+    uint32_t n = 1;
+
+    // 1. 持续推流 (每 16 ms 一帧) 108000 帧
+    uint32_t start = s_now;
+    uint32_t writes = s_persist.writes;
+    stream(30 * 60 * 60, 1000 / 60, &n);
+    uint32_t duration = s_now - start;
+    uint32_t stream_writes = s_persist.writes - writes;
+    printf("continuous stream: %u frames in %u s, %u NVS writes, longest change-to-flash delay %u ms\n",
+           (unsigned)(n - 1), (unsigned)(duration / 1000), (unsigned)stream_writes, (unsigned)s_max_save_delay);
+    expect(stream_writes <= duration / MAX_DELAY_MS + 1, "writes bounded by max_delay");
+    expect(stream_writes >= duration / MAX_DELAY_MS - 1, "still saves while streaming");
+    expect(s_max_save_delay <= MAX_DELAY_MS, "every change written within max_delay");
+    poll_until(s_now + QUIET_MS + MIN_INTERVAL_MS);
+    expect(stored_frame_is_current(), "last frame stored after the stream stops");
+
+    // 2. 间歇推流：每 3 秒推 0.5 秒，共 10 分钟
+    start = s_now;
+    s_max_save_delay = 0;
+    writes = s_persist.writes;
+    for (int burst = 0; burst < 200; burst++) {
+        stream(15, 1000 / 30, &n);
+        poll_until(s_now + 2500);
+    }
+    duration = s_now - start;
+    stream_writes = s_persist.writes - writes;
+    printf("bursty stream: %u s, %u NVS writes, longest change-to-flash delay %u ms\n",
+           (unsigned)(duration / 1000), (unsigned)stream_writes, (unsigned)s_max_save_delay);
+    expect(stream_writes <= duration / MIN_INTERVAL_MS + 1, "writes bounded by min_interval");
+    poll_until(s_now + QUIET_MS + MIN_INTERVAL_MS);
+    expect(stored_frame_is_current(), "last frame stored after the bursts stop");
+    expect(s_max_save_delay <= QUIET_MS + MIN_INTERVAL_MS, "every change written within quiet + min_interval");
+
+    // 3. 重复发送同一帧
+    writes = s_persist.writes;
+    uint32_t skipped = s_persist.skipped;
+    for (int i = 0; i < 100; i++) {
+        poll_until(s_now + 5000);
+        mark();
+    }
+    poll_until(s_now + QUIET_MS + MIN_INTERVAL_MS);
+    printf("unchanged content: %u NVS writes, %u entries skipped\n", (unsigned)(s_persist.writes - writes),
+           (unsigned)(s_persist.skipped - skipped));
+    expect(s_persist.writes == writes, "unchanged entries not written");
+
+    // 4. 只改亮度：只写亮度条目；画面暂时没有可保存内容时保留原来的
+    writes = s_persist.writes;
+    s_level = 50;
+    s_frame_valid = false;
+    mark();
+    poll_until(s_now + QUIET_MS + MIN_INTERVAL_MS);
+    s_frame_valid = true;
+    expect(s_persist.writes == writes + 1, "only the changed entry written");
+    expect(stored_frame_is_current(), "frame kept when no snapshot is available");
+
+    // 5. 重启：新的 persist_t 读回保存的内容，内容相同时不再写入
+    sim_nvs_stats_t before = sim_nvs_stats();
+    uint8_t restored[FRAME_BYTES];
+    uint8_t level = 0;
+    persist_setup();
+    s_next_poll = UINT32_MAX;
+    bool ok = persist_restore(&s_persist, 0, restored) == ESP_OK && persist_restore(&s_persist, 1, &level) == ESP_OK;
+    expect(ok && memcmp(restored, s_frame, FRAME_BYTES) == 0 && level == 50, "state restored after reboot");
+    mark();
+    poll_until(s_now + QUIET_MS + MIN_INTERVAL_MS);
+    expect(sim_nvs_stats().writes == before.writes, "restored content not written again");
+
+    // 6. 空间检查：每个条目要能同时放下新旧两份
+    size_t need, have;
+    expect(persist_check_space(&s_persist, &need, &have) == ESP_OK, "8x8 frame fits the nvs partition");
+    printf("8x8: %u NVS entries needed, %u available\n", (unsigned)need, (unsigned)have);
+    persist_entry_t big_entries[] = {
+        { .key = "frame", .size = 64 * 64 * 3, .snapshot = snapshot_frame },
+    };
+    persist_t big = { .name_space = "big", .entries = big_entries, .count = 1 };
+    bool too_big = persist_init(&big) == ESP_OK &&
+                   persist_check_space(&big, &need, &have) == ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    printf("64x64: %u NVS entries needed, %u available\n", (unsigned)need, (unsigned)have);
+    expect(too_big, "64x64 frame reported as too big");
+
+    sim_nvs_stats_t stats = sim_nvs_stats();
+    printf("total: %u NVS writes (%u bytes), %u commits\n", (unsigned)stats.writes, (unsigned)stats.bytes,
+           (unsigned)stats.commits);
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,354 @@
+/* UDP 像素协议测试：构造 DDP / E1.31 数据包，经本机回环 (127.0.0.1) 的 UDP 套接字收发后交给 pixel_proto.c 解析
+ *
+ * 检查 (AddressSanitizer/UBSan 编译)：
+ *   - 合法的 DDP 包 (带/不带时间码、PUSH、序号) 和 E1.31 数据包、同步包，解析出的字段与发送的一致；
+ *   - 每个合法包截断到任意长度：要么被拒绝，要么解析出的数据完全落在收到的数据报之内；
+ *   - 数据长度超过包尾的 DDP 包、属性个数超过包尾的 E1.31 包被拒绝；偏移超过灯带的 DDP 包照常解析，
+ *     由写显存的一方裁剪 (matrix_write_strip_bytes)；
+ *   - 不接受的包类型 (query/reply/storage、其它目标 ID、预览以外的错误向量等)；
+ *   - 序号比较的回绕。
+ * 也可以当作发送端，向设备发一帧渐变测试图案：
+ *   ./host_sim/build/pixel_proto_test                    # 测试
+ *   ./host_sim/build/pixel_proto_test -s IP [-n 像素数] [-e]   # 向 IP 发送 DDP (-e 用 E1.31)
+ * 退出码：0 通过，1 发现错误
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "pixel_proto.h"
+
+#define MAX_PACKET      1500
+
+static int s_failures;
+static int s_checks;
+
+static void expect(bool ok, const char *what)
+{
+    s_checks++;
+    if (!ok) {
+        printf("  %-70s FAIL\n", what);
+        s_failures++;
+    }
+}
+
+/* ---- 发送端：构造数据包 ---- */
+
+static void wr_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static void wr_be32(uint8_t *p, uint32_t v)
+{
+    wr_be16(p, v >> 16);
+    wr_be16(p + 2, v & 0xFFFF);
+}
+
+// DDP 像素数据包，返回包长
+static size_t ddp_build(uint8_t *buf, uint32_t offset, const uint8_t *data, uint16_t len, uint8_t seq,
+                        bool push, bool timecode)
+{
+    size_t hdr = timecode ? DDP_HEADER_LEN_TIMECODE : DDP_HEADER_LEN;
+    memset(buf, 0, hdr);
+    buf[0] = 0x40 | (timecode ? 0x10 : 0) | (push ? 0x01 : 0);
+    buf[1] = seq & 0x0F;
+    buf[2] = 0x0B;                      // RGB, 每通道 8 位
+    buf[3] = 1;                         // 显示设备
+    wr_be32(&buf[4], offset);
+    wr_be16(&buf[8], len);
+    memcpy(buf + hdr, data, len);
+    return hdr + len;
+}
+
+// E1.31 根层 (38 字节)，PDU 长度在各层末尾统一填写
+static void e131_root(uint8_t *buf, size_t len, uint32_t vector)
+{
+    static const uint8_t acn_id[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+    memset(buf, 0, len);
+    wr_be16(&buf[0], 0x0010);
+    memcpy(&buf[4], acn_id, sizeof(acn_id));
+    wr_be16(&buf[16], 0x7000 | (len - 16));
+    wr_be32(&buf[18], vector);
+    memset(&buf[22], 0xAB, 16);         // CID
+    wr_be16(&buf[38], 0x7000 | (len - 38));
+}
+
+static size_t e131_build_data(uint8_t *buf, uint16_t universe, const uint8_t *data, uint16_t len, uint8_t seq,
+                              uint16_t sync_addr, uint8_t options)
+{
+    size_t total = 126 + len;
+    e131_root(buf, total, 0x00000004);
+    wr_be32(&buf[40], 0x00000002);
+    snprintf((char *)&buf[44], 64, "pixel_proto_test");
+    buf[108] = 100;                     // 优先级
+    wr_be16(&buf[109], sync_addr);
+    buf[111] = seq;
+    buf[112] = options;
+    wr_be16(&buf[113], universe);
+    wr_be16(&buf[115], 0x7000 | (total - 115));
+    buf[117] = 0x02;
+    buf[118] = 0xA1;
+    wr_be16(&buf[119], 0);
+    wr_be16(&buf[121], 1);
+    wr_be16(&buf[123], len + 1);
+    buf[125] = 0x00;                    // DMX 起始码
+    memcpy(buf + 126, data, len);
+    return total;
+}
+
+static size_t e131_build_sync(uint8_t *buf, uint16_t sync_addr, uint8_t seq)
+{
+    e131_root(buf, 49, 0x00000008);
+    wr_be32(&buf[40], 0x00000001);
+    buf[44] = seq;
+    wr_be16(&buf[45], sync_addr);
+    return 49;
+}
+
+/* ---- 本机回环 ---- */
+
+static int s_tx = -1;
+static int s_rx = -1;
+static struct sockaddr_in s_rx_addr;
+
+static bool loopback_open(void)
+{
+    s_tx = socket(AF_INET, SOCK_DGRAM, 0);
+    s_rx = socket(AF_INET, SOCK_DGRAM, 0);
+    s_rx_addr = (struct sockaddr_in) { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t alen = sizeof(s_rx_addr);
+    struct timeval tv = { .tv_sec = 1 };
+    return s_tx >= 0 && s_rx >= 0 && bind(s_rx, (struct sockaddr *)&s_rx_addr, sizeof(s_rx_addr)) == 0 &&
+           getsockname(s_rx, (struct sockaddr *)&s_rx_addr, &alen) == 0 &&
+           setsockopt(s_rx, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == 0;
+}
+
+// 经回环发送并收回，返回收到的长度 (-1 表示失败)；没有回环时直接拷贝
+static ssize_t loopback(const uint8_t *pkt, size_t len, uint8_t *rx)
+{
+    if (s_rx < 0) {
+        memcpy(rx, pkt, len);
+        return len;
+    }
+    if (sendto(s_tx, pkt, len, 0, (struct sockaddr *)&s_rx_addr, sizeof(s_rx_addr)) != (ssize_t)len) return -1;
+    return recv(s_rx, rx, MAX_PACKET, 0);
+}
+
+/* ---- 测试 ---- */
+
+static bool within(const uint8_t *buf, size_t len, const uint8_t *data, size_t data_len)
+{
+    return data >= buf && data <= buf + len && data_len <= (size_t)(buf + len - data);
+}
+
+// 合法包截断到 0..len-1 字节：拒绝，或者解析出的数据在截断后的缓冲区之内
+static void check_truncations(const uint8_t *pkt, size_t len, bool ddp, const char *what)
+{
+    bool ok = true;
+    for (size_t n = 0; n < len; n++) {
+        // 每次放进刚好 n 字节的堆缓冲区，越界读会被 ASan 发现
+        uint8_t *buf = malloc(n ? n : 1);
+        memcpy(buf, pkt, n);
+        if (ddp) {
+            ddp_packet_t out;
+            if (ddp_parse(buf, n, &out)) ok &= within(buf, n, out.data, out.len);
+        } else {
+            e131_packet_t out;
+            if (e131_parse(buf, n, &out) == E131_PKT_DATA) ok &= within(buf, n, out.data, out.len);
+        }
+        free(buf);
+    }
+    expect(ok, what);
+}
+
+static void test_ddp(void)
+{
+    uint8_t data[300], pkt[MAX_PACKET], rx[MAX_PACKET];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = i * 7;
+
+    for (int timecode = 0; timecode < 2; timecode++) {
+        size_t len = ddp_build(pkt, 192, data, sizeof(data), 5, true, timecode);
+        ssize_t n = loopback(pkt, len, rx);
+        ddp_packet_t out;
+        bool ok = n == (ssize_t)len && ddp_parse(rx, n, &out);
+        expect(ok && out.offset == 192 && out.len == sizeof(data) && out.seq == 5 && out.push &&
+               memcmp(out.data, data, sizeof(data)) == 0,
+               timecode ? "ddp: valid packet with timecode" : "ddp: valid packet");
+        check_truncations(pkt, len, true, timecode ? "ddp: truncated packets with timecode" : "ddp: truncated packets");
+    }
+
+    ddp_packet_t out;
+    size_t len = ddp_build(pkt, 0, data, 30, 0, false, false);
+    expect(ddp_parse(pkt, len, &out) && !out.push && out.seq == 0, "ddp: no push, no sequence number");
+
+    // 数据长度字段超过包尾
+    wr_be16(&pkt[8], 31);
+    expect(!ddp_parse(pkt, len, &out), "ddp: length past the end of the packet");
+    wr_be16(&pkt[8], 0xFFFF);
+    expect(!ddp_parse(pkt, len, &out), "ddp: length 65535");
+
+    // 偏移超出灯带：解析器不知道灯带长度，原样交给调用方裁剪
+    len = ddp_build(pkt, 0xFFFFFFF0u, data, 30, 1, true, false);
+    expect(ddp_parse(pkt, len, &out) && out.offset == 0xFFFFFFF0u && out.len == 30, "ddp: offset past the strip passed through");
+
+    // 数据之后的多余字节忽略
+    len = ddp_build(pkt, 0, data, 30, 1, true, false);
+    expect(ddp_parse(pkt, len + 10, &out) && out.len == 30, "ddp: trailing bytes ignored");
+
+    // 不接受的包
+    static const struct {
+        int byte;
+        uint8_t value;
+        const char *what;
+    } rejects[] = {
+        { 0, 0x81, "ddp: version 2" },
+        { 0, 0x00, "ddp: version 0" },
+        { 0, 0x43, "ddp: query" },
+        { 0, 0x45, "ddp: reply" },
+        { 0, 0x49, "ddp: storage" },
+        { 3, 2, "ddp: other destination id" },
+    };
+    for (size_t i = 0; i < sizeof(rejects) / sizeof(rejects[0]); i++) {
+        len = ddp_build(pkt, 0, data, 30, 1, true, false);
+        pkt[rejects[i].byte] = rejects[i].value;
+        expect(!ddp_parse(pkt, len, &out), rejects[i].what);
+    }
+    len = ddp_build(pkt, 0, data, 30, 1, true, false);
+    pkt[3] = 255;
+    expect(ddp_parse(pkt, len, &out), "ddp: broadcast destination id");
+}
+
+static void test_e131(void)
+{
+    uint8_t data[E131_CHANNELS_PER_UNIVERSE], pkt[MAX_PACKET], rx[MAX_PACKET];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = i * 3;
+
+    size_t len = e131_build_data(pkt, 2, data, sizeof(data), 200, 7, 0);
+    ssize_t n = loopback(pkt, len, rx);
+    e131_packet_t out;
+    bool ok = n == (ssize_t)len && e131_parse(rx, n, &out) == E131_PKT_DATA;
+    expect(ok && out.universe == 2 && out.sync_addr == 7 && out.seq == 200 && out.priority == 100 &&
+           !out.preview && !out.terminated && out.len == sizeof(data) && memcmp(out.data, data, sizeof(data)) == 0,
+           "e131: valid data packet");
+    check_truncations(pkt, len, false, "e131: truncated data packets");
+
+    len = e131_build_sync(pkt, 7, 201);
+    n = loopback(pkt, len, rx);
+    expect(n == (ssize_t)len && e131_parse(rx, n, &out) == E131_PKT_SYNC && out.universe == 7 && out.seq == 201,
+           "e131: sync packet");
+    expect(e131_parse(pkt, len - 1, &out) == E131_PKT_INVALID, "e131: truncated sync packet");
+
+    len = e131_build_data(pkt, 1, data, 0, 1, 0, 0x80 | 0x40);
+    expect(e131_parse(pkt, len, &out) == E131_PKT_DATA && out.len == 0 && out.preview && out.terminated,
+           "e131: empty packet, preview and terminated flags");
+
+    // 属性个数超过包尾
+    len = e131_build_data(pkt, 1, data, 100, 1, 0, 0);
+    wr_be16(&pkt[123], 102);
+    expect(e131_parse(pkt, len, &out) == E131_PKT_INVALID, "e131: property count past the end of the packet");
+    wr_be16(&pkt[123], 0);
+    expect(e131_parse(pkt, len, &out) == E131_PKT_INVALID, "e131: property count 0");
+    // 超过一个宇宙的通道数照常解析，由调用方截到 510
+    len = e131_build_data(pkt, 1, data, sizeof(data), 1, 0, 0);
+    memset(pkt + len, 0x55, 2);
+    wr_be16(&pkt[123], sizeof(data) + 3);
+    expect(e131_parse(pkt, len + 2, &out) == E131_PKT_DATA && out.len == sizeof(data) + 2,
+           "e131: more than 510 channels passed through");
+
+    static const struct {
+        int byte;
+        uint8_t value;
+        const char *what;
+    } rejects[] = {
+        { 1, 0x11, "e131: preamble size" },
+        { 4, 'B', "e131: ACN packet identifier" },
+        { 21, 0x05, "e131: root vector" },
+        { 43, 0x03, "e131: framing vector" },
+        { 117, 0x03, "e131: DMP vector" },
+        { 118, 0xA2, "e131: address type" },
+        { 122, 2, "e131: address increment" },
+        { 125, 0xDD, "e131: non-zero start code" },
+    };
+    for (size_t i = 0; i < sizeof(rejects) / sizeof(rejects[0]); i++) {
+        len = e131_build_data(pkt, 1, data, 30, 1, 0, 0);
+        pkt[rejects[i].byte] = rejects[i].value;
+        expect(e131_parse(pkt, len, &out) == E131_PKT_INVALID, rejects[i].what);
+    }
+    len = e131_build_sync(pkt, 7, 1);
+    pkt[43] = 0x02;
+    expect(e131_parse(pkt, len, &out) == E131_PKT_INVALID, "e131: extended packet that is not a sync");
+}
+
+static void test_seq(void)
+{
+    expect(ddp_seq_is_newer(1, 2) && ddp_seq_is_newer(15, 1) && ddp_seq_is_newer(10, 2), "ddp seq: newer, wraps 15 -> 1");
+    expect(!ddp_seq_is_newer(5, 5) && !ddp_seq_is_newer(5, 4) && !ddp_seq_is_newer(2, 10), "ddp seq: repeated and stale");
+    expect(e131_seq_is_newer(1, 2) && e131_seq_is_newer(255, 0) && e131_seq_is_newer(100, 60),
+           "e131 seq: newer, wraps 255 -> 0, large jump back resyncs");
+    expect(!e131_seq_is_newer(5, 5) && !e131_seq_is_newer(5, 4) && !e131_seq_is_newer(0, 237),
+           "e131 seq: repeated and stale within 20");
+}
+
+// 发送一帧渐变测试图案：DDP 一个包 (超过 480 像素时分包)，E1.31 每个宇宙一个包，无同步
+static int send_pattern(const char *host, uint32_t pixels, bool e131)
+{
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(e131 ? E131_PORT : DDP_PORT) };
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        fprintf(stderr, "bad address %s\n", host);
+        return 1;
+    }
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    uint8_t *frame = malloc(pixels * 3);
+    for (uint32_t i = 0; i < pixels; i++) {
+        frame[i * 3] = i * 255 / pixels;
+        frame[i * 3 + 1] = 255 - i * 255 / pixels;
+        frame[i * 3 + 2] = 32;
+    }
+    uint8_t pkt[MAX_PACKET];
+    uint32_t chunk = e131 ? E131_CHANNELS_PER_UNIVERSE : 480 * 3;
+    for (uint32_t pos = 0, seq = 1; pos < pixels * 3; pos += chunk, seq++) {
+        uint16_t n = pixels * 3 - pos < chunk ? pixels * 3 - pos : chunk;
+        size_t len = e131 ? e131_build_data(pkt, 1 + pos / chunk, frame + pos, n, seq, 0, 0)
+                          : ddp_build(pkt, pos, frame + pos, n, seq % 15 + 1, pos + n == pixels * 3, false);
+        sendto(sock, pkt, len, 0, (struct sockaddr *)&addr, sizeof(addr));
+    }
+    printf("sent %u pixels to %s:%d (%s)\n", (unsigned)pixels, host, ntohs(addr.sin_port), e131 ? "E1.31" : "DDP");
+    free(frame);
+    close(sock);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *host = NULL;
+    uint32_t pixels = 64;
+    bool e131 = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:n:e")) != -1) {
+        switch (opt) {
+        case 's': host = optarg; break;
+        case 'n': pixels = strtoul(optarg, NULL, 0); break;
+        case 'e': e131 = true; break;
+        default:
+            fprintf(stderr, "usage: %s [-s IP [-n pixels] [-e]]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (host) return send_pattern(host, pixels ? pixels : 1, e131);
+
+    if (!loopback_open()) {
+        printf("no loopback UDP socket, parsing the packets without sending them\n");
+        s_rx = -1;
+    }
+    test_ddp();
+    test_e131();
+    test_seq();
+    printf("%d checks, %d failed\n", s_checks, s_failures);
+    printf("%s\n", s_failures ? "FAIL" : "PASS");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,71 @@
+/* 主机模拟器内部接口 */
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "led_strip.h"
+
+/* ---- 调度器 (sim_rtos.c) ---- */
+
+// 运行到条件满足或超时 (timeout_us 为 UINT64_MAX 表示一直等)，返回条件是否满足
+bool sim_block(bool (*ready)(void *arg), void *arg, uint64_t timeout_us);
+uint64_t sim_now_us(void);
+// 固件代码 (任务 + 定时器回调) 累计占用的 CPU 时间，不含调度器本身
+uint64_t sim_cpu_ns(void);
+// 把模拟器自己的开销 (写帧文件等) 从当前时间片中扣除
+void sim_cpu_exclude(uint64_t ns);
+
+// 启动调度器，在 main_task 中运行 fn；模拟在以下情况结束：
+// 虚拟时间到达 end_us、fn 返回后再过 grace_us、或所有任务都在无限期等待
+void sim_run(void (*fn)(void *arg), void *arg, uint64_t end_us, uint64_t grace_us);
+// 立即结束模拟 (esp_restart 等)，reason 交给 sim_on_exit
+void sim_stop(const char *reason) __attribute__((noreturn));
+// 模拟结束时调用，打印报告并返回进程退出码
+extern int (*sim_on_exit)(const char *reason);
+// 各任务和定时器回调的 CPU 时间
+void sim_report_tasks(FILE *out);
+
+/* ---- 平台 (sim_platform.c) ---- */
+
+extern int sim_log_level;              // 1 只显示错误，2 加上警告，3 加上 INFO
+extern bool sim_wifi_fail;             // 模拟 WiFi 连不上
+extern uint64_t sim_wifi_delay_us;     // 连接成功所需的虚拟时间
+extern bool sim_http_quiet;            // 不打印请求和响应 (基准测试)
+extern size_t sim_http_body_cut;       // 非 0 时 Body 只送出这么多字节就断开 (Content-Length 不变，模拟上传中断)
+
+// 构造一个 HTTP 请求并调用已注册的处理函数，返回 HTTP 状态码 (没有匹配的处理函数返回 404)
+int sim_http_request(const char *method, const char *uri, const char *content_type,
+                     const uint8_t *body, size_t len);
+bool sim_httpd_running(void);
+// 从文件加载 anim 分区的内容
+bool sim_partition_load(const char *label, const char *path);
+// 改变输入脚电平，中断打开时调用注册的处理函数
+void sim_gpio_set_level(int gpio_num, int level);
+
+/* ---- NVS (sim_nvs.c) ---- */
+
+typedef struct {
+    uint32_t writes;                    // nvs_set_blob 次数
+    uint32_t bytes;                     // 写入的数据字节数
+    uint32_t commits;
+} sim_nvs_stats_t;
+
+sim_nvs_stats_t sim_nvs_stats(void);
+// 从文件加载 / 写回全部内容 (模拟断电重启)，文件不存在时 load 返回 false
+bool sim_nvs_load(const char *path);
+bool sim_nvs_save(const char *path);
+
+/* ---- 灯带 (fake_led_strip.c) ---- */
+
+typedef struct {
+    uint64_t time_us;                   // 提交时的虚拟时间
+    uint32_t num_leds;                  // 本次发送的灯珠数 (部分刷新时小于灯带长度)
+    uint32_t wire_us;                   // 按 WS2812 时序 (每位 1.25us + 复位 280us) 估算的发送时间
+    uint64_t cpu_ns;                    // 距离上一次提交，固件消耗的 CPU 时间
+    const uint8_t *rgb;                 // 提交后灯带上的颜色，按灯带索引排列，每颗 3 字节 R,G,B
+    uint32_t strip_len;
+} sim_frame_t;
+
+// 每次 refresh 时调用
+extern void (*sim_on_frame)(const sim_frame_t *frame);
@@ -0,0 +1,442 @@
+/* 主机模拟：cJSON 的解析和读取接口
+ *
+ * 解析部分按 IDF json 组件中的 cJSON 1.7 逐函数移植 (函数名与上游相同)，接受/拒绝的输入和得到的值
+ * 与设备上一致，包括上游的几处非标准行为：
+ *   - 0x01-0x20 都当作空白，开头的 UTF-8 BOM 跳过，根值之后的内容忽略 (cJSON_Parse 不要求结尾)
+ *   - 数字从 '-' 或数字开始，取最长 63 个 0-9 + - e E . 字符交给 strtod，strtod 没用完的字符留给后面解析
+ *   - \uXXXX 中的非十六进制字符使整个码元为 0 (字符串在此截断)，代理对不完整时解析失败
+ *   - 容器嵌套超过 CJSON_NESTING_LIMIT (1000) 层时解析失败
+ * 模糊测试和基准测试在找得到 IDF 的 cJSON.c 时直接用上游源码 (见 CMakeLists.txt 中的 CJSON_DIR)。
+ */
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+
+#define CJSON_NESTING_LIMIT 1000
+
+typedef struct {
+    const unsigned char *content;
+    size_t length;                  // 含结尾的 '\0'
+    size_t offset;
+    size_t depth;
+} parse_buffer;
+
+#define can_read(buffer, size)              ((buffer)->offset + (size) <= (buffer)->length)
+#define can_access_at_index(buffer, index)  ((buffer)->offset + (index) < (buffer)->length)
+#define buffer_at_offset(buffer)            ((buffer)->content + (buffer)->offset)
+
+static cJSON *cJSON_New_Item(void)
+{
+    return calloc(1, sizeof(cJSON));
+}
+
+static parse_buffer *buffer_skip_whitespace(parse_buffer *buffer)
+{
+    while (can_access_at_index(buffer, 0) && buffer_at_offset(buffer)[0] <= 32) buffer->offset++;
+    if (buffer->offset == buffer->length) buffer->offset--;
+    return buffer;
+}
+
+static parse_buffer *skip_utf8_bom(parse_buffer *buffer)
+{
+    if (buffer->offset == 0 && can_access_at_index(buffer, 4) &&
+        strncmp((const char *)buffer_at_offset(buffer), "\xEF\xBB\xBF", 3) == 0) {
+        buffer->offset += 3;
+    }
+    return buffer;
+}
+
+static bool parse_number(cJSON *item, parse_buffer *buffer)
+{
+    unsigned char number_c_string[64];
+    size_t i;
+    for (i = 0; i < sizeof(number_c_string) - 1 && can_access_at_index(buffer, i); i++) {
+        unsigned char c = buffer_at_offset(buffer)[i];
+        if (!((c >= '0' && c <= '9') || c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.')) break;
+        number_c_string[i] = c;
+    }
+    number_c_string[i] = '\0';
+
+    char *after_end;
+    double number = strtod((const char *)number_c_string, &after_end);
+    if ((unsigned char *)after_end == number_c_string) return false;
+
+    item->valuedouble = number;
+    // 超出 int 范围时取边界值
+    if (number >= INT_MAX) {
+        item->valueint = INT_MAX;
+    } else if (number <= (double)INT_MIN) {
+        item->valueint = INT_MIN;
+    } else {
+        item->valueint = (int)number;
+    }
+    item->type = cJSON_Number;
+    buffer->offset += (size_t)((unsigned char *)after_end - number_c_string);
+    return true;
+}
+
+// 非十六进制字符使结果为 0
+static unsigned parse_hex4(const unsigned char *input)
+{
+    unsigned h = 0;
+    for (size_t i = 0; i < 4; i++) {
+        if (input[i] >= '0' && input[i] <= '9') {
+            h += input[i] - '0';
+        } else if (input[i] >= 'A' && input[i] <= 'F') {
+            h += 10 + input[i] - 'A';
+        } else if (input[i] >= 'a' && input[i] <= 'f') {
+            h += 10 + input[i] - 'a';
+        } else {
+            return 0;
+        }
+        if (i < 3) h <<= 4;
+    }
+    return h;
+}
+
+// 把 \uXXXX (或代理对 \uXXXX\uXXXX) 转成 UTF-8，返回消耗的输入长度，0 表示出错
+static unsigned char utf16_literal_to_utf8(const unsigned char *input_pointer, const unsigned char *input_end,
+                                           unsigned char **output_pointer)
+{
+    const unsigned char *first_sequence = input_pointer;
+    unsigned long codepoint;
+    unsigned char sequence_length;
+
+    if (input_end - first_sequence < 6) return 0;
+    unsigned first_code = parse_hex4(first_sequence + 2);
+    if (first_code >= 0xDC00 && first_code <= 0xDFFF) return 0;
+
+    if (first_code >= 0xD800 && first_code <= 0xDBFF) {
+        const unsigned char *second_sequence = first_sequence + 6;
+        sequence_length = 12;
+        if (input_end - second_sequence < 6) return 0;
+        if (second_sequence[0] != '\\' || second_sequence[1] != 'u') return 0;
+        unsigned second_code = parse_hex4(second_sequence + 2);
+        if (second_code < 0xDC00 || second_code > 0xDFFF) return 0;
+        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
+    } else {
+        sequence_length = 6;
+        codepoint = first_code;
+    }
+
+    unsigned char utf8_length;
+    unsigned char first_byte_mark;
+    if (codepoint < 0x80) {
+        utf8_length = 1;
+        first_byte_mark = 0;
+    } else if (codepoint < 0x800) {
+        utf8_length = 2;
+        first_byte_mark = 0xC0;
+    } else if (codepoint < 0x10000) {
+        utf8_length = 3;
+        first_byte_mark = 0xE0;
+    } else {
+        utf8_length = 4;
+        first_byte_mark = 0xF0;
+    }
+    for (unsigned char pos = utf8_length - 1; pos > 0; pos--) {
+        (*output_pointer)[pos] = (unsigned char)((codepoint | 0x80) & 0xBF);
+        codepoint >>= 6;
+    }
+    (*output_pointer)[0] = utf8_length > 1 ? (unsigned char)((codepoint | first_byte_mark) & 0xFF)
+                                           : (unsigned char)(codepoint & 0x7F);
+    *output_pointer += utf8_length;
+    return sequence_length;
+}
+
+// 先按 "反斜杠跳过下一个字节" 找到结尾的引号，再在这个范围内转换转义；结果存入 item->valuestring
+static bool parse_string(cJSON *item, parse_buffer *buffer)
+{
+    const unsigned char *input_pointer = buffer_at_offset(buffer) + 1;
+    const unsigned char *input_end = buffer_at_offset(buffer) + 1;
+    size_t skipped_bytes = 0;
+
+    if (buffer_at_offset(buffer)[0] != '\"') return false;
+
+    while ((size_t)(input_end - buffer->content) < buffer->length && *input_end != '\"') {
+        if (input_end[0] == '\\') {
+            if ((size_t)(input_end + 1 - buffer->content) >= buffer->length) return false;
+            skipped_bytes++;
+            input_end++;
+        }
+        input_end++;
+    }
+    if ((size_t)(input_end - buffer->content) >= buffer->length || *input_end != '\"') return false;
+
+    size_t allocation_length = (size_t)(input_end - buffer_at_offset(buffer)) - skipped_bytes;
+    unsigned char *output = malloc(allocation_length + sizeof(""));
+    if (!output) return false;
+    unsigned char *output_pointer = output;
+
+    while (input_pointer < input_end) {
+        if (*input_pointer != '\\') {
+            *output_pointer++ = *input_pointer++;
+            continue;
+        }
+        unsigned char sequence_length = 2;
+        if (input_end - input_pointer < 1) goto fail;
+        switch (input_pointer[1]) {
+        case 'b': *output_pointer++ = '\b'; break;
+        case 'f': *output_pointer++ = '\f'; break;
+        case 'n': *output_pointer++ = '\n'; break;
+        case 'r': *output_pointer++ = '\r'; break;
+        case 't': *output_pointer++ = '\t'; break;
+        case '\"':
+        case '\\':
+        case '/': *output_pointer++ = input_pointer[1]; break;
+        case 'u':
+            sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &output_pointer);
+            if (sequence_length == 0) goto fail;
+            break;
+        default:
+            goto fail;
+        }
+        input_pointer += sequence_length;
+    }
+    *output_pointer = '\0';
+
+    item->type = cJSON_String;
+    item->valuestring = (char *)output;
+    buffer->offset = (size_t)(input_end - buffer->content) + 1;
+    return true;
+
+fail:
+    free(output);
+    return false;
+}
+
+static bool parse_value(cJSON *item, parse_buffer *buffer);
+
+static bool parse_array(cJSON *item, parse_buffer *buffer)
+{
+    cJSON *head = NULL;
+    cJSON *current_item = NULL;
+
+    if (buffer->depth >= CJSON_NESTING_LIMIT) return false;
+    buffer->depth++;
+
+    if (buffer_at_offset(buffer)[0] != '[') goto fail;
+    buffer->offset++;
+    buffer_skip_whitespace(buffer);
+    if (can_access_at_index(buffer, 0) && buffer_at_offset(buffer)[0] == ']') goto success;
+    if (!can_access_at_index(buffer, 0)) {
+        buffer->offset--;
+        goto fail;
+    }
+
+    buffer->offset--;
+    do {
+        cJSON *new_item = cJSON_New_Item();
+        if (!new_item) goto fail;
+        if (!head) {
+            head = current_item = new_item;
+        } else {
+            current_item->next = new_item;
+            new_item->prev = current_item;
+            current_item = new_item;
+        }
+        buffer->offset++;
+        buffer_skip_whitespace(buffer);
+        if (!parse_value(current_item, buffer)) goto fail;
+        buffer_skip_whitespace(buffer);
+    } while (can_access_at_index(buffer, 0) && buffer_at_offset(buffer)[0] == ',');
+
+    if (!can_access_at_index(buffer, 0) || buffer_at_offset(buffer)[0] != ']') goto fail;
+
+success:
+    buffer->depth--;
+    item->type = cJSON_Array;
+    item->child = head;
+    buffer->offset++;
+    return true;
+
+fail:
+    cJSON_Delete(head);
+    return false;
+}
+
+static bool parse_object(cJSON *item, parse_buffer *buffer)
+{
+    cJSON *head = NULL;
+    cJSON *current_item = NULL;
+
+    if (buffer->depth >= CJSON_NESTING_LIMIT) return false;
+    buffer->depth++;
+
+    if (!can_access_at_index(buffer, 0) || buffer_at_offset(buffer)[0] != '{') goto fail;
+    buffer->offset++;
+    buffer_skip_whitespace(buffer);
+    if (can_access_at_index(buffer, 0) && buffer_at_offset(buffer)[0] == '}') goto success;
+    if (!can_access_at_index(buffer, 0)) {
+        buffer->offset--;
+        goto fail;
+    }
+
+    buffer->offset--;
+    do {
+        cJSON *new_item = cJSON_New_Item();
+        if (!new_item) goto fail;
+        if (!head) {
+            head = current_item = new_item;
+        } else {
+            current_item->next = new_item;
+            new_item->prev = current_item;
+            current_item = new_item;
+        }
+        if (!can_access_at_index(buffer, 1)) goto fail;
+        buffer->offset++;
+        buffer_skip_whitespace(buffer);
+        if (!parse_string(current_item, buffer)) goto fail;
+        buffer_skip_whitespace(buffer);
+
+        current_item->string = current_item->valuestring;
+        current_item->valuestring = NULL;
+
+        if (!can_access_at_index(buffer, 0) || buffer_at_offset(buffer)[0] != ':') goto fail;
+        buffer->offset++;
+        buffer_skip_whitespace(buffer);
+        if (!parse_value(current_item, buffer)) goto fail;
+        buffer_skip_whitespace(buffer);
+    } while (can_access_at_index(buffer, 0) && buffer_at_offset(buffer)[0] == ',');
+
+    if (!can_access_at_index(buffer, 0) || buffer_at_offset(buffer)[0] != '}') goto fail;
+
+success:
+    buffer->depth--;
+    item->type = cJSON_Object;
+    item->child = head;
+    buffer->offset++;
+    return true;
+
+fail:
+    cJSON_Delete(head);
+    return false;
+}
+
+static bool parse_value(cJSON *item, parse_buffer *buffer)
+{
+    const char *p = (const char *)buffer_at_offset(buffer);
+    if (can_read(buffer, 4) && strncmp(p, "null", 4) == 0) {
+        item->type = cJSON_NULL;
+        buffer->offset += 4;
+        return true;
+    }
+    if (can_read(buffer, 5) && strncmp(p, "false", 5) == 0) {
+        item->type = cJSON_False;
+        buffer->offset += 5;
+        return true;
+    }
+    if (can_read(buffer, 4) && strncmp(p, "true", 4) == 0) {
+        item->type = cJSON_True;
+        item->valueint = 1;
+        buffer->offset += 4;
+        return true;
+    }
+    if (!can_access_at_index(buffer, 0)) return false;
+    if (*p == '\"') return parse_string(item, buffer);
+    if (*p == '-' || (*p >= '0' && *p <= '9')) return parse_number(item, buffer);
+    if (*p == '[') return parse_array(item, buffer);
+    if (*p == '{') return parse_object(item, buffer);
+    return false;
+}
+
+cJSON *cJSON_Parse(const char *value)
+{
+    if (!value) return NULL;
+    parse_buffer buffer = {
+        .content = (const unsigned char *)value,
+        .length = strlen(value) + sizeof(""),
+    };
+    cJSON *item = cJSON_New_Item();
+    if (!item) return NULL;
+    if (!parse_value(item, buffer_skip_whitespace(skip_utf8_bom(&buffer)))) {
+        cJSON_Delete(item);
+        return NULL;
+    }
+    return item;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+    while (item) {
+        cJSON *next = item->next;
+        cJSON_Delete(item->child);
+        free(item->valuestring);
+        free(item->string);
+        free(item);
+        item = next;
+    }
+}
+
+static int case_insensitive_strcmp(const unsigned char *string1, const unsigned char *string2)
+{
+    if (!string1 || !string2) return 1;
+    if (string1 == string2) return 0;
+    for (; tolower(*string1) == tolower(*string2); string1++, string2++) {
+        if (*string1 == '\0') return 0;
+    }
+    return tolower(*string1) - tolower(*string2);
+}
+
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string)
+{
+    if (!object || !string) return NULL;
+    cJSON *current_element = object->child;
+    // 键名不区分大小写，重复的键取第一个
+    while (current_element &&
+           case_insensitive_strcmp((const unsigned char *)string, (const unsigned char *)current_element->string) != 0) {
+        current_element = current_element->next;
+    }
+    if (!current_element || !current_element->string) return NULL;
+    return current_element;
+}
+
+int cJSON_GetArraySize(const cJSON *array)
+{
+    int n = 0;
+    for (cJSON *c = array ? array->child : NULL; c; c = c->next) n++;
+    return n;
+}
+
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index)
+{
+    if (index < 0) return NULL;
+    cJSON *c = array ? array->child : NULL;
+    while (c && index > 0) {
+        c = c->next;
+        index--;
+    }
+    return c;
+}
+
+bool cJSON_IsBool(const cJSON *item)
+{
+    return item && (item->type & (cJSON_True | cJSON_False));
+}
+
+bool cJSON_IsTrue(const cJSON *item)
+{
+    return item && item->type == cJSON_True;
+}
+
+bool cJSON_IsNumber(const cJSON *item)
+{
+    return item && item->type == cJSON_Number;
+}
+
+bool cJSON_IsString(const cJSON *item)
+{
+    return item && item->type == cJSON_String;
+}
+
+bool cJSON_IsArray(const cJSON *item)
+{
+    return item && item->type == cJSON_Array;
+}
+
+bool cJSON_IsObject(const cJSON *item)
+{
+    return item && item->type == cJSON_Object;
+}
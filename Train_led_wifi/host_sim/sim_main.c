@@ -0,0 +1,696 @@
+/* 主机模拟器：在 Linux 上运行点阵固件的绘图、动画和 HTTP 处理逻辑
+ *
+ * 固件源文件整体包含进来 (静态函数和变量都可以直接调用)，灯带换成 fake_led_strip.c，
+ * FreeRTOS 和 esp_timer 运行在 sim_rtos.c 的虚拟时钟上。每次灯带刷新记录一帧：
+ * 虚拟时间戳、发送的灯珠数、估算的发送时间、距上一帧固件消耗的 CPU 时间，可输出为 PPM 图片或字符画。
+ *
+ * 用法见 README 或 sim --help
+ */
+#include "blink_example_main.c"
+
+#include <errno.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "sim.h"
+
+#define SIM_GRACE_US    (100 * 1000)    // 命令执行完后再运行一会，让最后一帧被渲染任务输出
+
+static struct {
+    const char *out_dir;
+    int scale;
+    bool text;
+    bool quiet_frames;
+    uint64_t max_frame_cpu_ns;          // 0 表示不检查
+    const char *nvs_file;               // 启动时加载、结束时写回的 NVS 内容
+    char **cmds;
+    int cmd_count;
+} s_opt = {
+    .scale = 8,
+};
+
+static struct {
+    uint32_t count;
+    uint32_t partial;
+    uint32_t over_budget;
+    uint64_t cpu_total_ns;
+    uint64_t cpu_max_ns;
+    uint32_t cpu_max_frame;
+    uint32_t wire_max_us;
+} s_stats;
+
+static bool s_cmd_failed;
+static uint8_t *s_last_rgb;             // 灯带上最后一帧的颜色
+static size_t s_last_rgb_len;
+
+/* ================== 帧输出 ================== */
+
+// 灯带索引 -> 画布坐标：按当前布局查找表反查
+static const uint8_t *frame_canvas_pixel(const sim_frame_t *frame, int x, int y)
+{
+    uint32_t index = s_layout_lut[y * s_canvas_width + x];
+    return index < frame->strip_len ? frame->rgb + index * 3 : (const uint8_t *)"\0\0\0";
+}
+
+static void frame_write_ppm(const sim_frame_t *frame, uint32_t seq)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s/frame_%05u.ppm", s_opt.out_dir, (unsigned)seq);
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "sim: cannot write %s: %s\n", path, strerror(errno));
+        return;
+    }
+    int s = s_opt.scale;
+    fprintf(f, "P6\n%d %d\n255\n", s_canvas_width * s, s_canvas_height * s);
+    for (int y = 0; y < s_canvas_height * s; y++) {
+        for (int x = 0; x < s_canvas_width * s; x++) {
+            fwrite(frame_canvas_pixel(frame, x / s, y / s), 1, 3, f);
+        }
+    }
+    fclose(f);
+}
+
+// 每个像素一个字符：熄灭为 '.'，否则取最亮的通道 r/g/b，三个通道接近时为 w；亮度 >= 64 时大写
+static void frame_print_text(const sim_frame_t *frame)
+{
+    for (int y = 0; y < s_canvas_height; y++) {
+        putchar(' ');
+        for (int x = 0; x < s_canvas_width; x++) {
+            const uint8_t *p = frame_canvas_pixel(frame, x, y);
+            int max = MAX(p[0], MAX(p[1], p[2]));
+            int min = MIN(p[0], MIN(p[1], p[2]));
+            char c = '.';
+            if (max) {
+                c = min * 4 >= max * 3 ? 'w' : p[0] == max ? 'r' : p[1] == max ? 'g' : 'b';
+                if (max >= 64) c -= 'a' - 'A';
+            }
+            putchar(c);
+        }
+        putchar('\n');
+    }
+}
+
+static void on_frame(const sim_frame_t *frame)
+{
+    uint32_t seq = s_stats.count++;
+    if (frame->num_leds < frame->strip_len) s_stats.partial++;
+    s_stats.cpu_total_ns += frame->cpu_ns;
+    if (frame->cpu_ns > s_stats.cpu_max_ns) {
+        s_stats.cpu_max_ns = frame->cpu_ns;
+        s_stats.cpu_max_frame = seq;
+    }
+    s_stats.wire_max_us = MAX(s_stats.wire_max_us, frame->wire_us);
+    bool over = s_opt.max_frame_cpu_ns && frame->cpu_ns > s_opt.max_frame_cpu_ns;
+    if (over) s_stats.over_budget++;
+
+    if (!s_opt.quiet_frames || over) {
+        printf("frame %5u  t=%9.3f ms  leds=%4u  wire=%5u us  cpu=%8.1f us%s\n", (unsigned)seq,
+               frame->time_us / 1000.0, (unsigned)frame->num_leds, (unsigned)frame->wire_us,
+               frame->cpu_ns / 1000.0, over ? "  OVER BUDGET" : "");
+    }
+    if (s_last_rgb_len != frame->strip_len * 3) {
+        s_last_rgb_len = frame->strip_len * 3;
+        s_last_rgb = realloc(s_last_rgb, s_last_rgb_len);
+    }
+    memcpy(s_last_rgb, frame->rgb, s_last_rgb_len);
+    if (s_opt.text) frame_print_text(frame);
+    if (s_opt.out_dir) frame_write_ppm(frame, seq);
+}
+
+static int on_exit_report(const char *reason)
+{
+    printf("\nsimulation ended at %.3f ms: %s\n", sim_now_us() / 1000.0, reason);
+    printf("frames %u (partial %u), firmware cpu %.3f ms total, %.1f us/frame avg, %.1f us max (frame %u)\n",
+           (unsigned)s_stats.count, (unsigned)s_stats.partial, s_stats.cpu_total_ns / 1e6,
+           s_stats.count ? s_stats.cpu_total_ns / 1e3 / s_stats.count : 0.0,
+           s_stats.cpu_max_ns / 1e3, (unsigned)s_stats.cpu_max_frame);
+    printf("longest transfer %u us, render period %d us\n", (unsigned)s_stats.wire_max_us, RENDER_PERIOD_US);
+    sim_nvs_stats_t nvs = sim_nvs_stats();
+    printf("nvs %u writes (%u bytes), %u commits\n", (unsigned)nvs.writes, (unsigned)nvs.bytes, (unsigned)nvs.commits);
+    sim_report_tasks(stdout);
+    if (s_opt.nvs_file && !sim_nvs_save(s_opt.nvs_file)) {
+        fprintf(stderr, "sim: cannot write %s\n", s_opt.nvs_file);
+    }
+
+    static const char *const errors[] = { "deadlock", "ESP_ERROR_CHECK", "timer callback" };
+    for (size_t i = 0; i < sizeof(errors) / sizeof(errors[0]); i++) {
+        if (strncmp(reason, errors[i], strlen(errors[i])) == 0) return 1;
+    }
+    if (s_cmd_failed) return 2;
+    if (s_stats.over_budget) {
+        printf("%u frame(s) over the cpu budget of %.1f us\n", (unsigned)s_stats.over_budget, s_opt.max_frame_cpu_ns / 1e3);
+        return 3;
+    }
+    return 0;
+}
+
+/* ================== 命令 ================== */
+
+// 没有运行 boot 时，按需初始化灯带和 HTTP 处理函数
+static void ensure_led(void)
+{
+    if (!led_strip) configure_led();
+}
+
+static void ensure_webserver(void)
+{
+    ensure_led();
+    if (!sim_httpd_running()) start_webserver();
+}
+
+static void ensure_button(void)
+{
+    ensure_led();
+    if (!s_button.events) button_init();
+}
+
+static uint8_t *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *buf = malloc(size > 0 ? size + 1 : 1);
+    if (buf && fread(buf, 1, size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    if (buf) {
+        buf[size] = '\0';
+        *len = size;
+    }
+    return buf;
+}
+
+/* ================== 竞争场景 ================== */
+/* 调度是协作式的，抢占造成的交错只能按固定顺序手工重现：
+ * boot 任务刚判断完 boot_interrupted() 就被抢占，客户端的帧在这时到达并取消开机画面，
+ * 之后 boot 任务接着开始滚动 IP。客户端的帧必须一直留在屏幕上，客户端的动画也不能被停掉。
+ */
+
+static struct {
+    EventGroupHandle_t checked;         // boot 任务已通过判断
+    EventGroupHandle_t resume;          // 客户端的帧已显示，boot 任务继续
+} s_race;
+
+static void race_boot_task(void *pvParameters)
+{
+    // 与 boot_task 中滚动 IP 之前的判断相同
+    if (!boot_interrupted()) {
+        xEventGroupSetBits(s_race.checked, BIT0);
+        xEventGroupWaitBits(s_race.resume, BIT0, pdTRUE, pdFALSE, portMAX_DELAY);
+        scroll_text(s_ip_addr_str, 60, 0, 15, 15);
+    }
+    s_boot.task = NULL;
+    vTaskDelete(NULL);
+}
+
+static bool race_boot_scroll(void)
+{
+    ensure_webserver();
+    if (!s_boot.lock) s_boot.lock = xSemaphoreCreateRecursiveMutex();
+    atomic_store(&s_boot.cancelled, false);
+    strcpy(s_ip_addr_str, "192.168.1.123");
+    s_race.checked = xEventGroupCreate();
+    s_race.resume = xEventGroupCreate();
+    xTaskCreate(race_boot_task, "boot", 4096, NULL, 1, &s_boot.task);
+    xEventGroupWaitBits(s_race.checked, BIT0, pdTRUE, pdFALSE, portMAX_DELAY);
+
+    // 客户端的帧：整屏红色
+    char *body = malloc(s_canvas_pixels * 10 + 64);
+    size_t len = sprintf(body, "{\"brightness\":20,\"data\":[");
+    for (uint32_t i = 0; i < s_canvas_pixels; i++) {
+        len += sprintf(body + len, "%s16711680", i ? "," : "");
+    }
+    len += sprintf(body + len, "]}");
+    int status = sim_http_request("POST", "/api/matrix", "application/json", (const uint8_t *)body, len);
+    free(body);
+    vTaskDelay(pdMS_TO_TICKS(100));
+    if (status != 200 || !s_last_rgb) {
+        fprintf(stderr, "sim: race: client frame not shown (HTTP %d)\n", status);
+        return false;
+    }
+    uint8_t *expect = malloc(s_last_rgb_len);
+    memcpy(expect, s_last_rgb, s_last_rgb_len);
+
+    xEventGroupSetBits(s_race.resume, BIT0);
+    while (s_boot.task) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    bool ok = memcmp(expect, s_last_rgb, s_last_rgb_len) == 0 && !s_scroll.active;
+    if (!ok) fprintf(stderr, "sim: race: the boot scroll replaced the client frame\n");
+    free(expect);
+    return ok;
+}
+
+/* ================== 帧格式基准 ================== */
+/* 同一画面分别用 JSON (POST /api/matrix) 和原始帧 RGB888/GRB888/RGB565 (POST /api/matrix/raw) 发送，
+ * 经过真实的 HTTP 处理函数 (Body 按 TCP 段接收)。先确认各格式写入显存的结果 (整数和小数部分) 完全相同，
+ * 再比较每帧的固件 CPU 时间。颜色取 RGB565 能精确表示的值，四种格式的画面才会一致。
+ * 依次在配置的布局和同向左上角起点的布局 (单块面板时查找表为恒等映射) 下各测一遍。
+ */
+
+typedef struct {
+    const char *name;
+    const char *uri;
+    const char *content_type;
+    uint8_t *body;
+    size_t len;
+} bench_format_t;
+
+static void bench_snapshot(uint8_t *out)
+{
+    int slot = frame_pool_get_latest(&s_fb_pool);
+    memcpy(out, s_fb_frames[slot].px, frame_bytes());
+    frame_pool_release(&s_fb_pool, slot);
+}
+
+static bool bench_layout(bench_format_t *formats, int count, int reps)
+{
+    uint8_t *expect = malloc(frame_bytes());
+    uint8_t *got = malloc(frame_bytes());
+    bool ok = true;
+    printf("layout: origin %d, %s, rotation %d, mirror %d, identity %s\n", s_layout.origin,
+           s_layout.serpentine ? "serpentine" : "progressive", s_layout.rotation, s_layout.mirror,
+           s_layout_identity ? "yes" : "no");
+    printf("  %-8s %8s %12s\n", "format", "bytes", "us/frame");
+    for (int f = 0; f < count && ok; f++) {
+        matrix_clear_all();
+        matrix_refresh();
+        int status = sim_http_request("POST", formats[f].uri, formats[f].content_type, formats[f].body, formats[f].len);
+        bench_snapshot(f == 0 ? expect : got);
+        if (status >= 300) {
+            fprintf(stderr, "sim: bench: %s returned HTTP %d\n", formats[f].name, status);
+            ok = false;
+        } else if (f > 0 && memcmp(expect, got, frame_bytes()) != 0) {
+            fprintf(stderr, "sim: bench: %s frame differs from %s\n", formats[f].name, formats[0].name);
+            ok = false;
+        }
+
+        uint64_t start = sim_cpu_ns();
+        for (int i = 0; i < reps; i++) {
+            sim_http_request("POST", formats[f].uri, formats[f].content_type, formats[f].body, formats[f].len);
+        }
+        printf("  %-8s %8zu %12.1f\n", formats[f].name, formats[f].len, (sim_cpu_ns() - start) / 1e3 / reps);
+    }
+    free(expect);
+    free(got);
+    return ok;
+}
+
+static bool bench_frame_formats(int reps)
+{
+    ensure_webserver();
+    uint32_t n = s_canvas_pixels;
+    uint8_t *rgb = malloc(n * 3);
+    char *json = malloc(n * 10 + 64);
+    uint8_t *grb = malloc(n * 3);
+    uint8_t *rgb565 = malloc(n * 2);
+    size_t json_len = sprintf(json, "{\"brightness\":50,\"data\":[");
+    uint32_t rng = 0x12345678u;
+    for (uint32_t i = 0; i < n; i++) {
+        rng = rng * 1664525u + 1013904223u;
+        uint16_t v = rng >> 16;
+        uint8_t r5 = (v >> 11) & 0x1F, g6 = (v >> 5) & 0x3F, b5 = v & 0x1F;
+        uint8_t r = (r5 << 3) | (r5 >> 2), g = (g6 << 2) | (g6 >> 4), b = (b5 << 3) | (b5 >> 2);
+        rgb[i * 3] = r;
+        rgb[i * 3 + 1] = g;
+        rgb[i * 3 + 2] = b;
+        grb[i * 3] = g;
+        grb[i * 3 + 1] = r;
+        grb[i * 3 + 2] = b;
+        rgb565[i * 2] = v & 0xFF;
+        rgb565[i * 2 + 1] = v >> 8;
+        json_len += sprintf(json + json_len, "%s%u", i ? "," : "", (unsigned)((r << 16) | (g << 8) | b));
+    }
+    json_len += sprintf(json + json_len, "]}");
+
+    bench_format_t formats[] = {
+        { "json", "/api/matrix", "application/json", (uint8_t *)json, json_len },
+        { "rgb888", "/api/matrix/raw?brightness=50", "application/octet-stream", rgb, n * 3 },
+        { "grb888", "/api/matrix/raw?brightness=50", "application/x-grb888", grb, n * 3 },
+        { "rgb565", "/api/matrix/raw?brightness=50", "application/x-rgb565", rgb565, n * 2 },
+    };
+    int count = sizeof(formats) / sizeof(formats[0]);
+
+    sim_http_quiet = true;
+    int log_level = sim_log_level;
+    sim_log_level = MIN(sim_log_level, 2);
+    bool ok = bench_layout(formats, count, reps);
+    matrix_layout_t layout = s_layout;
+    matrix_layout_t plain = { .width = s_layout.width, .height = s_layout.height };
+    if (ok && matrix_set_layout(&plain) == ESP_OK) {
+        ok = bench_layout(formats, count, reps);
+        matrix_set_layout(&layout);
+    }
+    sim_log_level = log_level;
+    sim_http_quiet = false;
+
+    free(rgb);
+    free(json);
+    free(grb);
+    free(rgb565);
+    return ok;
+}
+
+/* ================== 压缩帧参考帧 ================== */
+/* 差分帧只改写变化的像素，前提是屏幕内容就是解码器的参考帧。依次确认：
+ * 关键帧 + 差分帧正常显示；其他来源 (JSON) 改过屏幕后，差分帧返回 409 且屏幕不变；
+ * 补发关键帧后恢复；亮度变了差分帧同样返回 409；差分帧解码的结果与同一画面的关键帧相同。
+ */
+
+static struct {
+    uint8_t *prev;                      // 上一帧 RGB888
+    uint8_t id;
+} s_delta;
+
+// 第 seed 个测试画面
+static void delta_pattern(int seed, uint8_t *rgb)
+{
+    for (uint32_t i = 0; i < s_canvas_pixels * 3; i++) {
+        rgb[i] = (i * (seed * 2 + 1) + seed * 37) & 0xFF;
+    }
+}
+
+// 只用字面量操作编码 (与参考帧 XOR)，关键帧的参考帧为全黑
+static size_t delta_encode(const uint8_t *rgb, bool key, uint8_t *out)
+{
+    uint32_t n = s_canvas_pixels;
+    size_t len = 0;
+    out[len++] = key ? FRAME_CODEC_FLAG_KEY : 0;
+    out[len++] = s_delta.id++;
+    out[len++] = n & 0xFF;
+    out[len++] = n >> 8;
+    for (uint32_t i = 0; i < n; i += FRAME_CODEC_RUN_MAX) {
+        uint32_t count = MIN(n - i, FRAME_CODEC_RUN_MAX);
+        out[len++] = FRAME_CODEC_OP_LITERAL + count - 1;
+        for (uint32_t j = i * 3; j < (i + count) * 3; j++) {
+            out[len++] = key ? rgb[j] : rgb[j] ^ s_delta.prev[j];
+        }
+    }
+    memcpy(s_delta.prev, rgb, n * 3);
+    return len;
+}
+
+// 发送画面 seed，返回 HTTP 状态
+static int delta_post(int seed, bool key, int brightness)
+{
+    uint8_t *rgb = malloc(s_canvas_pixels * 3);
+    uint8_t *frame = malloc(FRAME_CODEC_MAX_LEN(s_canvas_pixels));
+    char uri[64];
+    delta_pattern(seed, rgb);
+    size_t len = delta_encode(rgb, key, frame);
+    snprintf(uri, sizeof(uri), "/api/matrix/raw?brightness=%d", brightness);
+    int status = sim_http_request("POST", uri, "application/x-matrix-delta", frame, len);
+    free(rgb);
+    free(frame);
+    return status;
+}
+
+static bool delta_expect(const char *what, int status, int want)
+{
+    if (status == want) return true;
+    fprintf(stderr, "sim: delta: %s: HTTP %d, expected %d\n", what, status, want);
+    return false;
+}
+
+static bool delta_reference_check(void)
+{
+    ensure_webserver();
+    s_delta.prev = calloc(s_canvas_pixels, 3);
+    uint8_t *before = malloc(frame_bytes());
+    uint8_t *after = malloc(frame_bytes());
+    bool ok = true;
+
+    ok &= delta_expect("keyframe", delta_post(1, true, 50), 204);
+    ok &= delta_expect("delta frame", delta_post(2, false, 50), 204);
+
+    // 其他来源改写屏幕：整屏绿色
+    char *body = malloc(s_canvas_pixels * 10 + 64);
+    size_t len = sprintf(body, "{\"brightness\":50,\"data\":[");
+    for (uint32_t i = 0; i < s_canvas_pixels; i++) {
+        len += sprintf(body + len, "%s65280", i ? "," : "");
+    }
+    len += sprintf(body + len, "]}");
+    ok &= delta_expect("JSON frame", sim_http_request("POST", "/api/matrix", "application/json",
+                                                      (const uint8_t *)body, len), 200);
+    free(body);
+    bench_snapshot(before);
+    ok &= delta_expect("delta frame after a JSON frame", delta_post(3, false, 50), 409);
+    bench_snapshot(after);
+    if (memcmp(before, after, frame_bytes()) != 0) {
+        fprintf(stderr, "sim: delta: a rejected delta frame changed the screen\n");
+        ok = false;
+    }
+
+    ok &= delta_expect("keyframe after a JSON frame", delta_post(3, true, 50), 204);
+    ok &= delta_expect("delta frame at another brightness", delta_post(4, false, 30), 409);
+    ok &= delta_expect("keyframe at the new brightness", delta_post(4, true, 30), 204);
+    ok &= delta_expect("delta frame at the new brightness", delta_post(5, false, 30), 204);
+
+    // 差分帧解码的结果与同一画面的关键帧相同
+    bench_snapshot(before);
+    ok &= delta_expect("keyframe of the same picture", delta_post(5, true, 30), 204);
+    bench_snapshot(after);
+    if (memcmp(before, after, frame_bytes()) != 0) {
+        fprintf(stderr, "sim: delta: the delta frame and the keyframe of the same picture differ\n");
+        ok = false;
+    }
+
+    free(before);
+    free(after);
+    free(s_delta.prev);
+    return ok;
+}
+
+/* ================== 动画上传 ================== */
+/* 经过 POST /api/anim 上传 anim_pack.py testimage 生成的文件：播放中的帧与同一帧经原始帧接口显示的结果相同；
+ * 上传中途断开必须回错误，分区里不能留下能播放的残缺动画 (/api/anim/play 返回 404)；之后重新上传恢复正常。
+ */
+
+static bool upload_expect(const char *what, int status, int want)
+{
+    if (status == want) return true;
+    fprintf(stderr, "sim: upload: %s: HTTP %d, expected %d\n", what, status, want);
+    return false;
+}
+
+static bool anim_upload_check(const char *path)
+{
+    size_t len = 0;
+    uint8_t *image = read_file(path, &len);
+    anim_info_t info;
+    if (!image || !anim_parse(image, len, &info) || info.frame_count < 2) {
+        fprintf(stderr, "sim: upload: cannot load %s\n", path);
+        free(image);
+        return false;
+    }
+    ensure_webserver();
+    uint8_t *played = malloc(frame_bytes());
+    uint8_t *expect = malloc(frame_bytes());
+    bool ok = true;
+
+    // testimage 第 0 帧时长为 0 (按 ANIM_MIN_FRAME_MS 显示)，第 1 帧 65 秒：50ms 后屏幕上是第 1 帧
+    ok &= upload_expect("upload", sim_http_request("POST", "/api/anim", "application/octet-stream", image, len), 200);
+    vTaskDelay(pdMS_TO_TICKS(50));
+    bench_snapshot(played);
+    ok &= upload_expect("stop", sim_http_request("DELETE", "/api/anim", NULL, NULL, 0), 200);
+    ok &= upload_expect("frame 1 as a raw frame", sim_http_request("POST", "/api/matrix/raw?brightness=100",
+                        "application/octet-stream", anim_frame_data(&info, 1), info.frame_size), 204);
+    bench_snapshot(expect);
+    if (memcmp(played, expect, frame_bytes()) != 0) {
+        fprintf(stderr, "sim: upload: the frame played differs from frame 1 of the file\n");
+        ok = false;
+    }
+
+    // 只送出一半 Body 就断开
+    sim_http_body_cut = len / 2;
+    int status = sim_http_request("POST", "/api/anim", "application/octet-stream", image, len);
+    sim_http_body_cut = 0;
+    if (status < 400) {
+        fprintf(stderr, "sim: upload: an aborted upload returned HTTP %d\n", status);
+        ok = false;
+    }
+    ok &= upload_expect("play after an aborted upload", sim_http_request("POST", "/api/anim/play", NULL, NULL, 0), 404);
+
+    ok &= upload_expect("upload again", sim_http_request("POST", "/api/anim", "application/octet-stream", image, len), 200);
+    ok &= upload_expect("play", sim_http_request("POST", "/api/anim/play", NULL, NULL, 0), 200);
+    anim_stop();
+
+    free(image);
+    free(played);
+    free(expect);
+    return ok;
+}
+
+// 依次执行命令，返回后模拟再运行 SIM_GRACE_US 结束
+static void command_task(void *arg)
+{
+    for (int i = 0; i < s_opt.cmd_count; i++) {
+        const char *cmd = s_opt.cmds[i];
+        int left = s_opt.cmd_count - i - 1;
+        if (strcmp(cmd, "boot") == 0 || strcmp(cmd, "start") == 0) {
+            app_main();
+            // boot 等开机画面结束，start 立即执行后面的命令 (开机过程中推送画面)
+            while (cmd[0] == 'b' && s_boot.task) {
+                vTaskDelay(pdMS_TO_TICKS(10));
+            }
+        } else if (strcmp(cmd, "intro") == 0) {
+            ensure_led();
+            play_startup_animation();
+        } else if (strcmp(cmd, "scroll") == 0 && left >= 1) {
+            ensure_led();
+            scroll_text(s_opt.cmds[++i], 60, 15, 15, 15);
+        } else if (strcmp(cmd, "button") == 0 && left >= 1) {
+            // 按下按键保持 MS 毫秒后松开 (不带抖动)
+            ensure_button();
+            sim_gpio_set_level(GPIO_INPUT_PIN, 0);
+            vTaskDelay(pdMS_TO_TICKS(atoi(s_opt.cmds[++i])));
+            sim_gpio_set_level(GPIO_INPUT_PIN, 1);
+        } else if (strcmp(cmd, "bench") == 0 && left >= 1) {
+            int reps = atoi(s_opt.cmds[++i]);
+            if (!bench_frame_formats(MAX(reps, 1))) s_cmd_failed = true;
+        } else if (strcmp(cmd, "race") == 0) {
+            if (!race_boot_scroll()) s_cmd_failed = true;
+        } else if (strcmp(cmd, "delta") == 0) {
+            if (!delta_reference_check()) s_cmd_failed = true;
+        } else if (strcmp(cmd, "upload") == 0 && left >= 1) {
+            if (!anim_upload_check(s_opt.cmds[++i])) s_cmd_failed = true;
+        } else if (strcmp(cmd, "wait") == 0 && left >= 1) {
+            vTaskDelay(pdMS_TO_TICKS(atoi(s_opt.cmds[++i])));
+        } else if (strcmp(cmd, "http") == 0 && left >= 2) {
+            // http METHOD URI [BODY_FILE [CONTENT_TYPE]]
+            const char *method = s_opt.cmds[++i];
+            const char *uri = s_opt.cmds[++i];
+            const char *file = NULL;
+            const char *ctype = NULL;
+            if (i + 1 < s_opt.cmd_count && s_opt.cmds[i + 1][0] == '@') file = s_opt.cmds[++i] + 1;
+            if (file && i + 1 < s_opt.cmd_count && strchr(s_opt.cmds[i + 1], '/')) ctype = s_opt.cmds[++i];
+
+            size_t len = 0;
+            uint8_t *body = NULL;
+            if (file && !(body = read_file(file, &len))) {
+                fprintf(stderr, "sim: cannot read %s\n", file);
+                s_cmd_failed = true;
+                continue;
+            }
+            ensure_webserver();
+            int status = sim_http_request(method, uri, ctype, body, len);
+            if (status >= 400) s_cmd_failed = true;
+            free(body);
+        } else {
+            fprintf(stderr, "sim: bad command '%s'\n", cmd);
+            s_cmd_failed = true;
+            return;
+        }
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] command...\n"
+            "commands (run in order on the main task):\n"
+            "  boot                       run app_main and wait for the boot visuals (animation, text, WiFi, icon)\n"
+            "  start                      run app_main and go on while the boot visuals play\n"
+            "  intro                      play the startup animation\n"
+            "  scroll TEXT                scroll TEXT once\n"
+            "  button MS                  hold the button down for MS ms, then release it\n"
+            "  wait MS                    let the firmware run for MS ms of virtual time\n"
+            "  http METHOD URI [@FILE [CONTENT_TYPE]]\n"
+            "                             call a HTTP handler, METHOD WS sends FILE as a WebSocket frame\n"
+            "  bench REPS                 post the same frame as JSON and as raw RGB888/GRB888/RGB565 REPS times\n"
+            "                             each, fail if the framebuffer contents differ, print us/frame\n"
+            "  race                       replay a client frame arriving between the boot task's cancel check\n"
+            "                             and its IP scroll, fail if the scroll replaces the frame\n"
+            "  delta                      post compressed frames around a JSON frame and a brightness change,\n"
+            "                             fail unless a delta frame after either is refused with 409\n"
+            "  upload FILE                upload animation FILE through POST /api/anim, then again cut off halfway;\n"
+            "                             fail if a frame is shown wrong or the aborted upload leaves a playable file\n"
+            "options:\n"
+            "  -o, --out DIR              write every frame as DIR/frame_NNNNN.ppm\n"
+            "  -s, --scale N              PPM pixel size (default 8)\n"
+            "  -t, --text                 print every frame as text\n"
+            "  -q, --quiet                only warnings and errors from the firmware log, no per-frame lines\n"
+            "  -d, --duration MS          stop after MS ms of virtual time (default 120000)\n"
+            "  -c, --max-frame-cpu US     exit with 3 if the firmware spends more than US us of CPU on a frame\n"
+            "  -a, --anim FILE            load FILE into the anim partition (see tools/anim_pack.py)\n"
+            "  -w, --wifi-fail            WiFi never connects (boot ends with esp_restart)\n"
+            "      --display-off          start with the display switched off, like the real device\n"
+            "  -n, --nvs FILE             load NVS from FILE (if it exists) and write it back at the end,\n"
+            "                             two runs with the same FILE behave like a reboot\n"
+            "exit status: 0 ok, 1 firmware error or deadlock, 2 a command failed, 3 cpu budget exceeded\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_opts[] = {
+        { "out", required_argument, NULL, 'o' },
+        { "scale", required_argument, NULL, 's' },
+        { "text", no_argument, NULL, 't' },
+        { "quiet", no_argument, NULL, 'q' },
+        { "duration", required_argument, NULL, 'd' },
+        { "max-frame-cpu", required_argument, NULL, 'c' },
+        { "anim", required_argument, NULL, 'a' },
+        { "wifi-fail", no_argument, NULL, 'w' },
+        { "display-off", no_argument, NULL, 'D' },
+        { "nvs", required_argument, NULL, 'n' },
+        { "help", no_argument, NULL, 'h' },
+        { 0 },
+    };
+    uint64_t duration_ms = 120000;
+    // 真机上按键按下才亮屏，模拟时默认直接亮屏
+    g_display_enable = true;
+
+    int c;
+    while ((c = getopt_long(argc, argv, "+o:s:tqd:c:a:wn:h", long_opts, NULL)) != -1) {
+        switch (c) {
+        case 'o':
+            s_opt.out_dir = optarg;
+            mkdir(optarg, 0755);
+            break;
+        case 's': s_opt.scale = MAX(atoi(optarg), 1); break;
+        case 't': s_opt.text = true; break;
+        case 'q':
+            s_opt.quiet_frames = true;
+            sim_log_level = 2;
+            break;
+        case 'd': duration_ms = strtoull(optarg, NULL, 10); break;
+        case 'c': s_opt.max_frame_cpu_ns = strtoull(optarg, NULL, 10) * 1000; break;
+        case 'a':
+            if (!sim_partition_load("anim", optarg)) {
+                fprintf(stderr, "sim: cannot load %s\n", optarg);
+                return 2;
+            }
+            break;
+        case 'w': sim_wifi_fail = true; break;
+        case 'D': g_display_enable = false; break;
+        case 'n':
+            s_opt.nvs_file = optarg;
+            if (access(optarg, F_OK) == 0 && !sim_nvs_load(optarg)) {
+                fprintf(stderr, "sim: cannot load %s\n", optarg);
+                return 2;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+    if (optind == argc) {
+        usage(argv[0]);
+        return 2;
+    }
+    s_opt.cmds = argv + optind;
+    s_opt.cmd_count = argc - optind;
+
+    sim_on_frame = on_frame;
+    sim_on_exit = on_exit_report;
+    sim_run(command_task, NULL, duration_ms * 1000, SIM_GRACE_US);
+    return 0;
+}
@@ -0,0 +1,206 @@
+/* 主机模拟：内存中的 NVS
+ *
+ * 每个键保存一块数据，不区分类型；写入立即生效，nvs_commit 只计数。
+ * 按 ESP-IDF 的存储格式估算占用的条目数，分区放不下新写入的内容时返回 ESP_ERR_NVS_NOT_ENOUGH_SPACE。
+ * 统计写入次数和字节数，用来检查固件的写入频率 (flash 磨损)。
+ * 内容可以从文件加载、写回文件，用同一个文件连续运行两次模拟即相当于重启。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "nvs.h"
+#include "sim.h"
+
+#define SIM_NVS_MAX_NAMESPACES  8
+#define SIM_NVS_MAX_ENTRIES     64
+#define SIM_NVS_NAME_LEN        16      // 与 ESP-IDF 相同，含结尾的 '\0'
+#define SIM_NVS_PARTITION_SIZE  0x6000  // partitions.csv 中 nvs 分区的大小
+#define SIM_NVS_PAGE_ENTRIES    126     // 每页 4096 字节，除去页头和状态位图后的 32 字节条目数
+
+static char s_namespaces[SIM_NVS_MAX_NAMESPACES][SIM_NVS_NAME_LEN];
+static int s_namespace_count;
+
+static struct {
+    int ns;
+    char key[SIM_NVS_NAME_LEN];
+    uint8_t *data;
+    size_t len;
+} s_entries[SIM_NVS_MAX_ENTRIES];
+static int s_entry_count;
+
+static sim_nvs_stats_t s_stats;
+
+static int namespace_index(const char *name, bool create)
+{
+    for (int i = 0; i < s_namespace_count; i++) {
+        if (strcmp(s_namespaces[i], name) == 0) return i;
+    }
+    if (!create || s_namespace_count == SIM_NVS_MAX_NAMESPACES) return -1;
+    strcpy(s_namespaces[s_namespace_count], name);
+    return s_namespace_count++;
+}
+
+static int entry_index(int ns, const char *key)
+{
+    for (int i = 0; i < s_entry_count; i++) {
+        if (s_entries[i].ns == ns && strcmp(s_entries[i].key, key) == 0) return i;
+    }
+    return -1;
+}
+
+// 与 ESP-IDF 相同：blob 按页分块，每块一个头条目加数据条目，另有一个索引条目
+static size_t blob_entries(size_t len)
+{
+    size_t entries = 1;
+    do {
+        size_t chunk = len < (SIM_NVS_PAGE_ENTRIES - 1) * 32 ? len : (SIM_NVS_PAGE_ENTRIES - 1) * 32;
+        entries += 1 + (chunk + 31) / 32;
+        len -= chunk;
+    } while (len);
+    return entries;
+}
+
+static esp_err_t entry_store(int ns, const char *key, const void *value, size_t length)
+{
+    int i = entry_index(ns, key);
+    if (i < 0) {
+        if (s_entry_count == SIM_NVS_MAX_ENTRIES) return ESP_ERR_NVS_NO_FREE_PAGES;
+        i = s_entry_count++;
+        s_entries[i].ns = ns;
+        strcpy(s_entries[i].key, key);
+        s_entries[i].data = NULL;
+    }
+    uint8_t *data = realloc(s_entries[i].data, length ? length : 1);
+    if (!data) return ESP_ERR_NO_MEM;
+    memcpy(data, value, length);
+    s_entries[i].data = data;
+    s_entries[i].len = length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name_space, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!name_space || strlen(name_space) >= SIM_NVS_NAME_LEN || !out_handle) return ESP_ERR_INVALID_ARG;
+    int ns = namespace_index(name_space, open_mode == NVS_READWRITE);
+    if (ns < 0) return ESP_ERR_NVS_NOT_FOUND;
+    *out_handle = ns + 1;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    s_stats.commits++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    int i = entry_index((int)handle - 1, key);
+    if (i < 0) return ESP_ERR_NVS_NOT_FOUND;
+    if (out_value) {
+        if (*length < s_entries[i].len) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out_value, s_entries[i].data, s_entries[i].len);
+    }
+    *length = s_entries[i].len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    if (handle == 0 || (int)handle > s_namespace_count || strlen(key) >= SIM_NVS_NAME_LEN) return ESP_ERR_INVALID_ARG;
+    // 旧内容在新内容写好之后才擦除
+    nvs_stats_t stats;
+    nvs_get_stats(NULL, &stats);
+    if (blob_entries(length) > stats.available_entries) return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    esp_err_t err = entry_store((int)handle - 1, key, value, length);
+    if (err == ESP_OK) {
+        s_stats.writes++;
+        s_stats.bytes += length;
+    }
+    return err;
+}
+
+esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats)
+{
+    // 每个命名空间在 0 号命名空间里占一个条目
+    size_t used = s_namespace_count;
+    for (int i = 0; i < s_entry_count; i++) {
+        used += blob_entries(s_entries[i].len);
+    }
+    size_t total = SIM_NVS_PARTITION_SIZE / 4096 * SIM_NVS_PAGE_ENTRIES;
+    size_t free_entries = used < total ? total - used : 0;
+    *nvs_stats = (nvs_stats_t) {
+        .used_entries = used,
+        .free_entries = free_entries,
+        .available_entries = free_entries > SIM_NVS_PAGE_ENTRIES ? free_entries - SIM_NVS_PAGE_ENTRIES : 0,
+        .total_entries = total,
+        .namespace_count = s_namespace_count,
+    };
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_used_entry_count(nvs_handle_t handle, size_t *used_entries)
+{
+    if (handle == 0 || (int)handle > s_namespace_count) return ESP_ERR_NVS_INVALID_HANDLE;
+    *used_entries = 0;
+    for (int i = 0; i < s_entry_count; i++) {
+        if (s_entries[i].ns == (int)handle - 1) *used_entries += blob_entries(s_entries[i].len);
+    }
+    return ESP_OK;
+}
+
+sim_nvs_stats_t sim_nvs_stats(void)
+{
+    return s_stats;
+}
+
+/* 文件格式：每个键一条记录，命名空间和键名各占 16 字节 (以 '\0' 填充)，
+ * 然后是 4 字节小端长度和数据 */
+
+bool sim_nvs_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    char ns[SIM_NVS_NAME_LEN];
+    char key[SIM_NVS_NAME_LEN];
+    uint8_t len_le[4];
+    bool ok = true;
+    while (fread(ns, 1, sizeof(ns), f) == sizeof(ns)) {
+        ns[SIM_NVS_NAME_LEN - 1] = key[SIM_NVS_NAME_LEN - 1] = '\0';
+        if (fread(key, 1, sizeof(key), f) != sizeof(key) || fread(len_le, 1, sizeof(len_le), f) != sizeof(len_le)) {
+            ok = false;
+            break;
+        }
+        size_t len = len_le[0] | len_le[1] << 8 | len_le[2] << 16 | (uint32_t)len_le[3] << 24;
+        uint8_t *data = malloc(len ? len : 1);
+        int n = namespace_index(ns, true);
+        ok = data && n >= 0 && fread(data, 1, len, f) == len && entry_store(n, key, data, len) == ESP_OK;
+        free(data);
+        if (!ok) break;
+    }
+    fclose(f);
+    return ok;
+}
+
+bool sim_nvs_save(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    for (int i = 0; i < s_entry_count; i++) {
+        char ns[SIM_NVS_NAME_LEN] = { 0 };
+        char key[SIM_NVS_NAME_LEN] = { 0 };
+        strcpy(ns, s_namespaces[s_entries[i].ns]);
+        strcpy(key, s_entries[i].key);
+        uint32_t len = s_entries[i].len;
+        uint8_t len_le[4] = { len, len >> 8, len >> 16, len >> 24 };
+        fwrite(ns, 1, sizeof(ns), f);
+        fwrite(key, 1, sizeof(key), f);
+        fwrite(len_le, 1, sizeof(len_le), f);
+        fwrite(s_entries[i].data, 1, len, f);
+    }
+    return fclose(f) == 0;
+}
@@ -0,0 +1,597 @@
+/* 主机模拟：日志、WiFi/事件循环、GPIO、分区、NVS、套接字和 HTTP 服务器的替代实现 */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_system.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_event.h"
+#include "esp_partition.h"
+#include "nvs_flash.h"
+#include "esp_http_server.h"
+#include "lwip/sockets.h"
+#include "driver/gpio.h"
+#include "sim.h"
+
+int sim_log_level = 3;
+bool sim_wifi_fail;
+bool sim_http_quiet;
+size_t sim_http_body_cut;
+uint64_t sim_wifi_delay_us = 1500 * 1000;
+
+/* ================== 日志与错误 ================== */
+
+void sim_log(char level, const char *tag, const char *fmt, ...)
+{
+    static const char levels[] = "EWIDV";
+    const char *p = strchr(levels, level);
+    if (!p || p - levels + 1 > sim_log_level) return;
+
+    fprintf(stderr, "%c (%llu) %s: ", level, (unsigned long long)(sim_now_us() / 1000), tag);
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_INVALID_LENGTH: return "ESP_ERR_NVS_INVALID_LENGTH";
+    case ESP_ERR_NVS_NOT_ENOUGH_SPACE: return "ESP_ERR_NVS_NOT_ENOUGH_SPACE";
+    default:                    return "UNKNOWN ERROR";
+    }
+}
+
+void sim_check_failed(esp_err_t rc, const char *file, int line, const char *expr)
+{
+    fprintf(stderr, "ESP_ERROR_CHECK failed: esp_err_t 0x%x (%s) at %s:%d\nexpression: %s\n",
+            rc, esp_err_to_name(rc), file, line, expr);
+    sim_stop("ESP_ERROR_CHECK failed");
+}
+
+void esp_restart(void)
+{
+    sim_stop("esp_restart");
+}
+
+// 约为 ESP32-C3 连上 WiFi 后的剩余堆
+#define SIM_HEAP_FREE   (180 * 1024)
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return SIM_HEAP_FREE;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return SIM_HEAP_FREE;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    return ESP_OK;
+}
+
+/* ================== 事件循环与 WiFi ================== */
+/* 事件由独立的 sys_evt 任务分发 (与 ESP-IDF 默认事件循环相同)。
+ * esp_wifi_connect 之后经过 sim_wifi_delay_us 的虚拟时间得到 IP，或者在 sim_wifi_fail 时报告断开 */
+
+esp_event_base_t const WIFI_EVENT = "WIFI_EVENT";
+esp_event_base_t const IP_EVENT = "IP_EVENT";
+
+#define SIM_EVENT_HANDLERS_MAX  8
+
+typedef struct {
+    esp_event_base_t base;
+    int32_t id;
+} sim_event_t;
+
+static struct {
+    esp_event_base_t base;
+    int32_t id;
+    esp_event_handler_t handler;
+    void *arg;
+} s_handlers[SIM_EVENT_HANDLERS_MAX];
+static int s_handler_count;
+static QueueHandle_t s_event_queue;
+static esp_timer_handle_t s_wifi_timer;
+
+static void event_post(esp_event_base_t base, int32_t id)
+{
+    sim_event_t evt = { base, id };
+    xQueueSend(s_event_queue, &evt, 0);
+}
+
+static void event_task(void *arg)
+{
+    sim_event_t evt;
+    while (1) {
+        xQueueReceive(s_event_queue, &evt, portMAX_DELAY);
+        ip_event_got_ip_t got_ip = {
+            // 192.168.4.2
+            .ip_info.ip.addr = 192 | (168 << 8) | (4 << 16) | (2u << 24),
+        };
+        for (int i = 0; i < s_handler_count; i++) {
+            if (s_handlers[i].base == evt.base && (s_handlers[i].id == ESP_EVENT_ANY_ID || s_handlers[i].id == evt.id)) {
+                s_handlers[i].handler(s_handlers[i].arg, evt.base, evt.id, &got_ip);
+            }
+        }
+    }
+}
+
+esp_err_t esp_event_loop_create_default(void)
+{
+    if (s_event_queue) return ESP_ERR_INVALID_STATE;
+    s_event_queue = xQueueCreate(8, sizeof(sim_event_t));
+    xTaskCreate(event_task, "sys_evt", 2304, NULL, 20, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_instance_register(esp_event_base_t base, int32_t id, esp_event_handler_t handler,
+                                              void *arg, esp_event_handler_instance_t *instance)
+{
+    if (s_handler_count == SIM_EVENT_HANDLERS_MAX) return ESP_ERR_NO_MEM;
+    s_handlers[s_handler_count].base = base;
+    s_handlers[s_handler_count].id = id;
+    s_handlers[s_handler_count].handler = handler;
+    s_handlers[s_handler_count].arg = arg;
+    s_handler_count++;
+    return ESP_OK;
+}
+
+static void wifi_timer_cb(void *arg)
+{
+    if (sim_wifi_fail) {
+        event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED);
+    } else {
+        event_post(WIFI_EVENT, WIFI_EVENT_STA_CONNECTED);
+        event_post(IP_EVENT, IP_EVENT_STA_GOT_IP);
+    }
+}
+
+esp_err_t esp_netif_init(void)
+{
+    return ESP_OK;
+}
+
+void *esp_netif_create_default_wifi_sta(void)
+{
+    return (void *)1;
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+    const esp_timer_create_args_t args = {
+        .callback = wifi_timer_cb,
+        .name = "sim_wifi",
+    };
+    return esp_timer_create(&args, &s_wifi_timer);
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+    event_post(WIFI_EVENT, WIFI_EVENT_STA_START);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_connect(void)
+{
+    if (esp_timer_is_active(s_wifi_timer)) return ESP_OK;
+    return esp_timer_start_once(s_wifi_timer, sim_wifi_delay_us);
+}
+
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_max_tx_power(int8_t power)
+{
+    return ESP_OK;
+}
+
+/* ================== GPIO ================== */
+
+/* 输入脚默认为高 (上拉)，电平由 sim_gpio_set_level 改变；中断打开时立即调用注册的处理函数
+ * (在调用方任务中执行，相当于边沿中断) */
+#define SIM_GPIO_MAX 32
+
+static struct {
+    gpio_isr_t handler;
+    void *arg;
+    bool intr_enabled;
+    int level;
+} s_gpio[SIM_GPIO_MAX] = { [0 ... SIM_GPIO_MAX - 1] = { .level = 1 } };
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    for (int i = 0; i < SIM_GPIO_MAX; i++) {
+        if (cfg->pin_bit_mask & (1ULL << i)) {
+            s_gpio[i].intr_enabled = cfg->intr_type != GPIO_INTR_DISABLE;
+        }
+    }
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    return gpio_num < SIM_GPIO_MAX ? s_gpio[gpio_num].level : 1;
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (gpio_num >= SIM_GPIO_MAX) return ESP_ERR_INVALID_ARG;
+    s_gpio[gpio_num].handler = isr_handler;
+    s_gpio[gpio_num].arg = args;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num)
+{
+    s_gpio[gpio_num].intr_enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num)
+{
+    s_gpio[gpio_num].intr_enabled = false;
+    return ESP_OK;
+}
+
+void sim_gpio_set_level(int gpio_num, int level)
+{
+    if (gpio_num >= SIM_GPIO_MAX || s_gpio[gpio_num].level == level) return;
+    s_gpio[gpio_num].level = level;
+    if (s_gpio[gpio_num].handler && s_gpio[gpio_num].intr_enabled) {
+        s_gpio[gpio_num].handler(s_gpio[gpio_num].arg);
+    }
+}
+
+/* ================== 分区 ================== */
+
+static esp_partition_t s_anim_part = {
+    .type = ESP_PARTITION_TYPE_DATA,
+    .subtype = 0x40,
+    .address = 0x110000,
+    .size = 0xF0000,
+    .erase_size = 4096,
+    .label = "anim",
+};
+static uint8_t *s_anim_flash;
+
+static uint8_t *partition_data(void)
+{
+    if (!s_anim_flash) {
+        s_anim_flash = malloc(s_anim_part.size);
+        if (!s_anim_flash) abort();
+        memset(s_anim_flash, 0xFF, s_anim_part.size);
+    }
+    return s_anim_flash;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char *label)
+{
+    if (type == s_anim_part.type && label && strcmp(label, s_anim_part.label) == 0) return &s_anim_part;
+    return NULL;
+}
+
+bool sim_partition_load(const char *label, const char *path)
+{
+    if (strcmp(label, s_anim_part.label) != 0) return false;
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    size_t n = fread(partition_data(), 1, s_anim_part.size, f);
+    fclose(f);
+    return n > 0;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    if (src_offset > partition->size || size > partition->size - src_offset) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, partition_data() + src_offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+    if (dst_offset > partition->size || size > partition->size - dst_offset) return ESP_ERR_INVALID_SIZE;
+    // NOR flash 写入只能把 1 变成 0
+    const uint8_t *in = src;
+    uint8_t *flash = partition_data() + dst_offset;
+    for (size_t i = 0; i < size; i++) {
+        flash[i] &= in[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    if (offset % partition->erase_size || size % partition->erase_size) return ESP_ERR_INVALID_ARG;
+    if (offset > partition->size || size > partition->size - offset) return ESP_ERR_INVALID_SIZE;
+    memset(partition_data() + offset, 0xFF, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset, size_t size,
+                             esp_partition_mmap_memory_t memory, const void **out_ptr, esp_partition_mmap_handle_t *out_handle)
+{
+    if (offset > partition->size || size > partition->size - offset) return ESP_ERR_INVALID_SIZE;
+    *out_ptr = partition_data() + offset;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle)
+{
+}
+
+/* ================== 套接字 ================== */
+
+#undef socket
+#undef select
+
+int sim_socket(int domain, int type, int protocol)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int sim_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout)
+{
+    // 没有可用的套接字：一直等下去，不占用虚拟时间
+    sim_block(NULL, NULL, UINT64_MAX);
+    return 0;
+}
+
+/* ================== HTTP 服务器 ================== */
+/* 请求不经过网络，sim_http_request 直接找到处理函数并在调用方任务中执行 */
+
+#define SIM_HTTP_HANDLERS_MAX   32
+#define SIM_HTTP_PRINT_MAX      200
+#define SIM_TCP_MSS             1436    // 以太网 MTU 下的 TCP 段长度
+
+static httpd_uri_t s_uris[SIM_HTTP_HANDLERS_MAX];
+static int s_uri_count;
+static int s_uri_limit;
+
+typedef struct {
+    const char *content_type;
+    const uint8_t *body;
+    size_t len;
+    size_t pos;
+    int status;
+} sim_http_ctx_t;
+
+bool sim_httpd_running(void)
+{
+    return s_uri_limit != 0;
+}
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    s_uri_limit = MIN(config->max_uri_handlers, SIM_HTTP_HANDLERS_MAX);
+    *handle = (httpd_handle_t)s_uris;
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    // 与 ESP-IDF 一样，超过 max_uri_handlers 时注册失败
+    if (s_uri_count >= s_uri_limit) {
+        ESP_LOGW("sim_httpd", "no slots left for %s", uri_handler->uri);
+        return ESP_ERR_NO_MEM;
+    }
+    s_uris[s_uri_count++] = *uri_handler;
+    return ESP_OK;
+}
+
+static const char *method_name(int method)
+{
+    switch (method) {
+    case HTTP_GET:     return "GET";
+    case HTTP_POST:    return "POST";
+    case HTTP_PUT:     return "PUT";
+    case HTTP_DELETE:  return "DELETE";
+    case HTTP_OPTIONS: return "OPTIONS";
+    default:           return "?";
+    }
+}
+
+int sim_http_request(const char *method, const char *uri, const char *content_type,
+                     const uint8_t *body, size_t len)
+{
+    // WS 表示向 WebSocket 端点发送一个二进制帧
+    bool ws = strcmp(method, "WS") == 0;
+    int m = -1;
+    for (int i = HTTP_DELETE; i <= HTTP_OPTIONS; i++) {
+        if (strcmp(method, method_name(i)) == 0) m = i;
+    }
+    if (ws) m = HTTP_GET;
+
+    size_t path_len = strcspn(uri, "?");
+    const httpd_uri_t *h = NULL;
+    for (int i = 0; i < s_uri_count; i++) {
+        if ((int)s_uris[i].method == m && strlen(s_uris[i].uri) == path_len &&
+                strncmp(s_uris[i].uri, uri, path_len) == 0 && s_uris[i].is_websocket == ws) {
+            h = &s_uris[i];
+        }
+    }
+    if (!h) {
+        printf("http %s %s -> 404 (no handler)\n", method, uri);
+        return 404;
+    }
+
+    sim_http_ctx_t ctx = {
+        .content_type = content_type,
+        .body = body,
+        .len = sim_http_body_cut ? MIN(len, sim_http_body_cut) : len,
+        .status = 200,
+    };
+    httpd_req_t *req = calloc(1, sizeof(*req));
+    if (!req) abort();
+    snprintf((char *)req->uri, sizeof(req->uri), "%s", uri);
+    // WebSocket 数据帧不再是 GET (握手才是)
+    req->method = ws ? 0 : m;
+    req->content_len = len;
+    req->aux = &ctx;
+    req->user_ctx = h->user_ctx;
+
+    if (!sim_http_quiet) printf("http %s %s\n", method, uri);
+    esp_err_t ret = h->handler(req);
+    if (!sim_http_quiet) printf("  -> %d (handler returned %s)\n", ctx.status, esp_err_to_name(ret));
+    free(req);
+    return ctx.status;
+}
+
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    sim_http_ctx_t *ctx = r->aux;
+    // 与真实的 socket 一样，一次最多返回一个 TCP 段
+    size_t n = MIN(MIN(buf_len, ctx->len - ctx->pos), SIM_TCP_MSS);
+    if (n == 0) return HTTPD_SOCK_ERR_FAIL;
+    memcpy(buf, ctx->body + ctx->pos, n);
+    ctx->pos += n;
+    return n;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size)
+{
+    sim_http_ctx_t *ctx = r->aux;
+    if (strcasecmp(field, "Content-Type") != 0 || !ctx->content_type) return ESP_ERR_NOT_FOUND;
+    if (strlen(ctx->content_type) >= val_size) return ESP_ERR_INVALID_SIZE;
+    strcpy(val, ctx->content_type);
+    return ESP_OK;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    const char *q = strchr(r->uri, '?');
+    if (!q) return ESP_ERR_NOT_FOUND;
+    if (strlen(q + 1) >= buf_len) return ESP_ERR_INVALID_SIZE;
+    strcpy(buf, q + 1);
+    return ESP_OK;
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size)
+{
+    size_t key_len = strlen(key);
+    for (const char *p = qry; p && *p; p = strchr(p, '&') ? strchr(p, '&') + 1 : NULL) {
+        if (strncmp(p, key, key_len) == 0 && p[key_len] == '=') {
+            const char *v = p + key_len + 1;
+            size_t n = strcspn(v, "&");
+            if (n >= val_size) return ESP_ERR_INVALID_SIZE;
+            memcpy(val, v, n);
+            val[n] = '\0';
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    if (buf && buf_len < 0) buf_len = strlen(buf);
+    if (buf && buf_len > 0 && !sim_http_quiet) {
+        printf("  body (%zd bytes): %.*s%s\n", buf_len, (int)MIN(buf_len, SIM_HTTP_PRINT_MAX), buf,
+               buf_len > SIM_HTTP_PRINT_MAX ? "..." : "");
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value)
+{
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status)
+{
+    ((sim_http_ctx_t *)r->aux)->status = atoi(status);
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
+{
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *r, httpd_err_code_t error, const char *msg)
+{
+    static const int codes[] = {
+        [HTTPD_400_BAD_REQUEST] = 400,
+        [HTTPD_404_NOT_FOUND] = 404,
+        [HTTPD_408_REQ_TIMEOUT] = 408,
+        [HTTPD_500_INTERNAL_SERVER_ERROR] = 500,
+    };
+    ((sim_http_ctx_t *)r->aux)->status = codes[error];
+    return httpd_resp_send(r, msg, -1);
+}
+
+esp_err_t httpd_resp_send_408(httpd_req_t *r)
+{
+    return httpd_resp_send_err(r, HTTPD_408_REQ_TIMEOUT, "Request Timeout");
+}
+
+esp_err_t httpd_resp_send_500(httpd_req_t *r)
+{
+    return httpd_resp_send_err(r, HTTPD_500_INTERNAL_SERVER_ERROR, "Internal Server Error");
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t *req, httpd_ws_frame_t *pkt, size_t max_len)
+{
+    sim_http_ctx_t *ctx = req->aux;
+    pkt->final = true;
+    pkt->type = HTTPD_WS_TYPE_BINARY;
+    pkt->len = ctx->len;
+    if (max_len == 0) return ESP_OK;
+    if (max_len < ctx->len) return ESP_ERR_INVALID_SIZE;
+    memcpy(pkt->payload, ctx->body, ctx->len);
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_send_frame(httpd_req_t *req, httpd_ws_frame_t *pkt)
+{
+    if (sim_http_quiet) return ESP_OK;
+    printf("  ws frame (%zu bytes):", pkt->len);
+    for (size_t i = 0; i < pkt->len; i++) {
+        printf(" %02x", pkt->payload[i]);
+    }
+    printf("\n");
+    return ESP_OK;
+}
@@ -0,0 +1,627 @@
+/* 主机模拟：FreeRTOS 任务/队列/互斥量/事件组 + esp_timer，运行在虚拟时钟上
+ *
+ * 每个任务是一个 pthread，但同一时刻只有 s_current 在运行 (持有 s_lock)，其余都等在各自的条件变量上。
+ * 任务只在阻塞调用处让出 CPU (协作式，没有时间片和抢占)；被唤醒后按优先级挑选，同优先级先等待的先运行。
+ * 所有任务都在等待时才推进虚拟时间：跳到最早到期的定时器或延时，先执行到期的 esp_timer 回调
+ * (相当于最高优先级的定时器任务)，再挑选任务。固件代码本身不消耗虚拟时间，结果完全可复现。
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "sim.h"
+
+#define SIM_MAX_TASKS   16
+#define TICK_US         (1000000ULL / configTICK_RATE_HZ)
+#define NEVER           UINT64_MAX
+
+struct sim_task {
+    pthread_t thread;
+    pthread_cond_t cv;
+    const char *name;
+    TaskFunction_t fn;
+    void *arg;
+    UBaseType_t prio;
+    bool (*ready)(void *arg);           // 阻塞条件，NULL 表示只等超时
+    void *ready_arg;
+    uint64_t wake_us;                   // 超时时刻
+    uint64_t wait_seq;                  // 开始等待的顺序，同优先级先等待的先运行
+    uint32_t notify;
+    bool deleted;
+    uint64_t cpu_ns;
+    void *tls[configNUM_THREAD_LOCAL_STORAGE_POINTERS];
+    TlsDeleteCallbackFunction_t tls_del[configNUM_THREAD_LOCAL_STORAGE_POINTERS];
+};
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+    uint64_t expiry;                    // NEVER 表示未启动
+    uint64_t period;                    // 0 表示单次
+    uint64_t cpu_ns;
+    uint32_t fired;
+    struct esp_timer *next;
+};
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_stop_cv = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t s_never_cv = PTHREAD_COND_INITIALIZER;
+
+static struct sim_task *s_tasks[SIM_MAX_TASKS];
+static int s_task_count;
+static struct sim_task *s_current;
+static struct sim_task *s_main_task;
+static struct esp_timer *s_timers;
+static bool s_in_timer;                 // 正在执行定时器回调，不允许阻塞
+
+static uint64_t s_now_us;
+static uint64_t s_end_us = NEVER;
+static uint64_t s_grace_us;
+static uint64_t s_main_done_us = NEVER;
+static uint64_t s_wait_seq;
+static const char *s_stop_reason;
+
+static uint64_t s_cpu_ns;               // 已结束的时间片累计
+static uint64_t s_slice_start;          // 当前时间片开始时的线程 CPU 时间
+static bool s_slice_open;
+
+int (*sim_on_exit)(const char *reason);
+
+static uint64_t thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void slice_begin(void)
+{
+    s_slice_start = thread_cpu_ns();
+    s_slice_open = true;
+}
+
+static uint64_t slice_end(void)
+{
+    uint64_t used = thread_cpu_ns() - s_slice_start;
+    s_cpu_ns += used;
+    s_slice_open = false;
+    return used;
+}
+
+uint64_t sim_now_us(void)
+{
+    return s_now_us;
+}
+
+uint64_t sim_cpu_ns(void)
+{
+    return s_cpu_ns + (s_slice_open ? thread_cpu_ns() - s_slice_start : 0);
+}
+
+void sim_cpu_exclude(uint64_t ns)
+{
+    if (s_slice_open) s_slice_start += ns;
+}
+
+/* ================== 调度 ================== */
+
+void sim_stop(const char *reason)
+{
+    if (s_slice_open) slice_end();
+    s_stop_reason = reason;
+    pthread_cond_signal(&s_stop_cv);
+    for (;;) {
+        pthread_cond_wait(&s_never_cv, &s_lock);
+    }
+}
+
+static bool task_runnable(const struct sim_task *t)
+{
+    if (t->deleted) return false;
+    if (t->ready && t->ready(t->ready_arg)) return true;
+    return s_now_us >= t->wake_us;
+}
+
+static struct esp_timer *timer_next_due(void)
+{
+    struct esp_timer *due = NULL;
+    for (struct esp_timer *t = s_timers; t; t = t->next) {
+        if (t->expiry <= s_now_us && (!due || t->expiry < due->expiry)) due = t;
+    }
+    return due;
+}
+
+static void fire_timers(void)
+{
+    struct esp_timer *t;
+    while ((t = timer_next_due()) != NULL) {
+        t->expiry = t->period ? t->expiry + t->period : NEVER;
+        t->fired++;
+        s_in_timer = true;
+        slice_begin();
+        t->callback(t->arg);
+        t->cpu_ns += slice_end();
+        s_in_timer = false;
+    }
+}
+
+// 挑选下一个运行的任务；没有可运行的任务时推进虚拟时间
+static struct sim_task *schedule(void)
+{
+    for (;;) {
+        fire_timers();
+
+        struct sim_task *next = NULL;
+        for (int i = 0; i < s_task_count; i++) {
+            struct sim_task *t = s_tasks[i];
+            if (!task_runnable(t)) continue;
+            if (!next || t->prio > next->prio || (t->prio == next->prio && t->wait_seq < next->wait_seq)) {
+                next = t;
+            }
+        }
+        if (next) return next;
+
+        uint64_t when = NEVER;
+        for (struct esp_timer *t = s_timers; t; t = t->next) {
+            when = MIN(when, t->expiry);
+        }
+        for (int i = 0; i < s_task_count; i++) {
+            if (!s_tasks[i]->deleted) when = MIN(when, s_tasks[i]->wake_us);
+        }
+
+        uint64_t limit = s_end_us;
+        if (s_main_done_us != NEVER) limit = MIN(limit, s_main_done_us + s_grace_us);
+        if (when == NEVER) {
+            sim_stop(s_main_done_us != NEVER ? "all tasks idle" : "deadlock: every task is blocked forever");
+        }
+        if (when > limit) {
+            s_now_us = limit;
+            sim_stop(s_main_done_us != NEVER ? "main task finished" : "time limit reached");
+        }
+        s_now_us = when;
+    }
+}
+
+// 把 CPU 交给 next，直到再次被选中
+static void switch_to(struct sim_task *me, struct sim_task *next)
+{
+    if (next == me) return;
+    s_current = next;
+    pthread_cond_signal(&next->cv);
+    while (s_current != me) {
+        pthread_cond_wait(&me->cv, &s_lock);
+    }
+}
+
+bool sim_block(bool (*ready)(void *arg), void *arg, uint64_t timeout_us)
+{
+    if (ready && ready(arg)) return true;
+    if (timeout_us == 0) return false;
+    if (s_in_timer) {
+        fprintf(stderr, "sim: esp_timer callback would block, this deadlocks on the device too\n");
+        sim_stop("timer callback blocked");
+    }
+
+    struct sim_task *me = s_current;
+    me->cpu_ns += slice_end();
+    me->ready = ready;
+    me->ready_arg = arg;
+    me->wake_us = timeout_us == NEVER ? NEVER : s_now_us + timeout_us;
+    me->wait_seq = ++s_wait_seq;
+
+    switch_to(me, schedule());
+
+    me->ready = NULL;
+    me->wake_us = NEVER;
+    slice_begin();
+    return ready ? ready(arg) : false;
+}
+
+// FreeRTOS 的等待以 tick 为单位，到期时刻对齐到 tick 边界
+static uint64_t ticks_to_timeout(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) return NEVER;
+    if (ticks == 0) return 0;
+    return (s_now_us / TICK_US + ticks) * TICK_US - s_now_us;
+}
+
+static void *task_thread(void *arg)
+{
+    struct sim_task *t = arg;
+    pthread_mutex_lock(&s_lock);
+    while (s_current != t) {
+        pthread_cond_wait(&t->cv, &s_lock);
+    }
+    slice_begin();
+    t->fn(t->arg);
+    // 任务函数返回等同于删除自己 (app_main 就是这样结束的)
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+void sim_run(void (*fn)(void *arg), void *arg, uint64_t end_us, uint64_t grace_us)
+{
+    pthread_mutex_lock(&s_lock);
+    s_end_us = end_us;
+    s_grace_us = grace_us;
+    xTaskCreate(fn, "main", 0, arg, 1, &s_main_task);
+
+    s_current = s_main_task;
+    pthread_cond_signal(&s_main_task->cv);
+    while (!s_stop_reason) {
+        pthread_cond_wait(&s_stop_cv, &s_lock);
+    }
+
+    int code = sim_on_exit ? sim_on_exit(s_stop_reason) : 0;
+    fflush(stdout);
+    _Exit(code);
+}
+
+void sim_report_tasks(FILE *out)
+{
+    for (int i = 0; i < s_task_count; i++) {
+        fprintf(out, "  task  %-12s prio %2lu  cpu %8.3f ms\n", s_tasks[i]->name,
+                s_tasks[i]->prio, s_tasks[i]->cpu_ns / 1e6);
+    }
+    for (struct esp_timer *t = s_timers; t; t = t->next) {
+        fprintf(out, "  timer %-12s fired %5lu  cpu %8.3f ms\n", t->name ? t->name : "?",
+                (unsigned long)t->fired, t->cpu_ns / 1e6);
+    }
+}
+
+/* ================== 任务 ================== */
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t prio, TaskHandle_t *out_task)
+{
+    if (s_task_count == SIM_MAX_TASKS) return pdFAIL;
+    struct sim_task *t = calloc(1, sizeof(*t));
+    if (!t) return pdFAIL;
+    pthread_cond_init(&t->cv, NULL);
+    t->name = name;
+    t->fn = fn;
+    t->arg = arg;
+    t->prio = prio;
+    t->wake_us = 0;                     // 新任务立即可运行，但要等当前任务让出 CPU
+    t->wait_seq = ++s_wait_seq;
+    s_tasks[s_task_count++] = t;
+    if (pthread_create(&t->thread, NULL, task_thread, t) != 0) {
+        fprintf(stderr, "sim: pthread_create failed for task %s\n", name);
+        abort();
+    }
+    if (out_task) *out_task = t;
+    return pdPASS;
+}
+
+// 设备上由空闲任务 (删除自己时) 或删除方在释放任务时调用
+static void task_tls_delete(struct sim_task *t)
+{
+    for (int i = 0; i < configNUM_THREAD_LOCAL_STORAGE_POINTERS; i++) {
+        if (t->tls_del[i]) t->tls_del[i](i, t->tls[i]);
+        t->tls_del[i] = NULL;
+    }
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    struct sim_task *me = s_current;
+    if (task && task != me) {
+        task->deleted = true;
+        task_tls_delete(task);
+        return;
+    }
+    task_tls_delete(me);
+    me->cpu_ns += slice_end();
+    me->deleted = true;
+    if (me == s_main_task) s_main_done_us = s_now_us;
+
+    s_current = schedule();
+    pthread_cond_signal(&s_current->cv);
+    pthread_mutex_unlock(&s_lock);
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sim_block(NULL, NULL, ticks_to_timeout(ticks));
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(s_now_us / TICK_US);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    // 设备上 esp_timer 回调都在 esp_timer 任务中执行，这里给它们一个独立的句柄
+    static struct sim_task timer_task = { .name = "esp_timer" };
+    return s_in_timer ? &timer_task : s_current;
+}
+
+char *pcTaskGetName(TaskHandle_t task)
+{
+    return (char *)(task ? task : xTaskGetCurrentTaskHandle())->name;
+}
+
+void *pvTaskGetThreadLocalStoragePointer(TaskHandle_t task, BaseType_t index)
+{
+    if (!task) task = xTaskGetCurrentTaskHandle();
+    return index < configNUM_THREAD_LOCAL_STORAGE_POINTERS ? task->tls[index] : NULL;
+}
+
+void vTaskSetThreadLocalStoragePointerAndDelCallback(TaskHandle_t task, BaseType_t index, void *value,
+                                                     TlsDeleteCallbackFunction_t del_callback)
+{
+    if (!task) task = xTaskGetCurrentTaskHandle();
+    if (index >= configNUM_THREAD_LOCAL_STORAGE_POINTERS) return;
+    task->tls[index] = value;
+    task->tls_del[index] = del_callback;
+}
+
+static bool notify_ready(void *arg)
+{
+    return ((struct sim_task *)arg)->notify != 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    struct sim_task *me = s_current;
+    sim_block(notify_ready, me, ticks_to_timeout(ticks_to_wait));
+    uint32_t value = me->notify;
+    if (value) me->notify = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notify++;
+    return pdPASS;
+}
+
+/* ================== 队列 ================== */
+
+struct sim_queue {
+    size_t item_size;
+    size_t length;
+    size_t count;
+    size_t head;
+    uint8_t *buf;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct sim_queue *q = calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    q->buf = calloc(length, item_size);
+    if (!q->buf) {
+        free(q);
+        return NULL;
+    }
+    q->item_size = item_size;
+    q->length = length;
+    return q;
+}
+
+static bool queue_not_empty(void *arg)
+{
+    return ((struct sim_queue *)arg)->count != 0;
+}
+
+static bool queue_not_full(void *arg)
+{
+    struct sim_queue *q = arg;
+    return q->count < q->length;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks_to_wait)
+{
+    if (!sim_block(queue_not_full, q, ticks_to_timeout(ticks_to_wait))) return pdFALSE;
+    memcpy(q->buf + ((q->head + q->count) % q->length) * q->item_size, item, q->item_size);
+    q->count++;
+    return pdTRUE;
+}
+
+// 只用于长度为1的队列：已有数据时直接覆盖
+BaseType_t xQueueOverwrite(QueueHandle_t q, const void *item)
+{
+    memcpy(q->buf + q->head * q->item_size, item, q->item_size);
+    q->count = 1;
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *buf, TickType_t ticks_to_wait)
+{
+    if (!sim_block(queue_not_empty, q, ticks_to_timeout(ticks_to_wait))) return pdFALSE;
+    memcpy(buf, q->buf + q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    return q->count;
+}
+
+/* ================== 互斥量 ================== */
+
+struct sim_mutex {
+    const void *owner;
+    int depth;                          // 递归互斥量的重入次数
+};
+
+static const char s_timer_owner = 0;    // 定时器回调持有互斥量时的标记
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return calloc(1, sizeof(struct sim_mutex));
+}
+
+static bool mutex_free(void *arg)
+{
+    return ((struct sim_mutex *)arg)->owner == NULL;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    if (!sim_block(mutex_free, sem, ticks_to_timeout(ticks_to_wait))) return pdFALSE;
+    sem->owner = s_in_timer ? (const void *)&s_timer_owner : (const void *)s_current;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    const void *me = s_in_timer ? (const void *)&s_timer_owner : (const void *)s_current;
+    if (sem->owner != me) return pdFALSE;
+    sem->owner = NULL;
+    return pdTRUE;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return xSemaphoreCreateMutex();
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    const void *me = s_in_timer ? (const void *)&s_timer_owner : (const void *)s_current;
+    if (sem->owner == me) {
+        sem->depth++;
+        return pdTRUE;
+    }
+    return xSemaphoreTake(sem, ticks_to_wait);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+    const void *me = s_in_timer ? (const void *)&s_timer_owner : (const void *)s_current;
+    if (sem->owner != me) return pdFALSE;
+    if (sem->depth > 0) {
+        sem->depth--;
+        return pdTRUE;
+    }
+    return xSemaphoreGive(sem);
+}
+
+/* ================== 事件组 ================== */
+
+struct sim_event_group {
+    EventBits_t bits;
+    EventBits_t want;                   // 只支持一个等待者，固件中没有多个任务等同一个事件组
+    bool all;
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return calloc(1, sizeof(struct sim_event_group));
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group)
+{
+    return group->bits;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    group->bits |= bits;
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits)
+{
+    EventBits_t old = group->bits;
+    group->bits &= ~bits;
+    return old;
+}
+
+static bool event_group_satisfied(void *arg)
+{
+    struct sim_event_group *g = arg;
+    return g->all ? (g->bits & g->want) == g->want : (g->bits & g->want) != 0;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait)
+{
+    group->want = bits;
+    group->all = wait_for_all;
+    bool ok = sim_block(event_group_satisfied, group, ticks_to_timeout(ticks_to_wait));
+    EventBits_t value = group->bits;
+    if (ok && clear_on_exit) group->bits &= ~bits;
+    return value;
+}
+
+/* ================== esp_timer ================== */
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *out_handle)
+{
+    if (!args || !args->callback || !out_handle) return ESP_ERR_INVALID_ARG;
+    struct esp_timer *t = calloc(1, sizeof(*t));
+    if (!t) return ESP_ERR_NO_MEM;
+    t->callback = args->callback;
+    t->arg = args->arg;
+    t->name = args->name;
+    t->expiry = NEVER;
+
+    // 按创建顺序排列，同时到期时先创建的先执行
+    struct esp_timer **tail = &s_timers;
+    while (*tail) tail = &(*tail)->next;
+    *tail = t;
+    *out_handle = t;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer->expiry != NEVER) return ESP_ERR_INVALID_STATE;
+    timer->expiry = s_now_us + timeout_us;
+    timer->period = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    if (timer->expiry != NEVER) return ESP_ERR_INVALID_STATE;
+    if (period == 0) return ESP_ERR_INVALID_ARG;
+    timer->expiry = s_now_us + period;
+    timer->period = period;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer->expiry == NEVER) return ESP_ERR_INVALID_STATE;
+    timer->expiry = NEVER;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer->expiry != NEVER) return ESP_ERR_INVALID_STATE;
+    for (struct esp_timer **p = &s_timers; *p; p = &(*p)->next) {
+        if (*p == timer) {
+            *p = timer->next;
+            free(timer);
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    return timer->expiry != NEVER;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)s_now_us;
+}
@@ -0,0 +1,54 @@
+/* Flash 动画文件格式，布局见 anim_format.h */
+#include <string.h>
+#include "anim_format.h"
+
+static inline uint16_t rd_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// 时长表之后补齐到 4 字节，帧数据起始偏移
+static uint32_t anim_frames_offset(uint16_t frame_count)
+{
+    return (ANIM_HEADER_LEN + frame_count * 2u + 3u) & ~3u;
+}
+
+uint32_t anim_image_size(const uint8_t *buf, size_t len)
+{
+    if (!buf || len < ANIM_HEADER_LEN) return 0;
+    if (memcmp(buf, ANIM_MAGIC, 4) != 0 || buf[4] != ANIM_VERSION) return 0;
+
+    uint16_t width = rd_le16(buf + 6);
+    uint16_t height = rd_le16(buf + 8);
+    uint16_t frame_count = rd_le16(buf + 10);
+    if (width == 0 || height == 0 || frame_count == 0) return 0;
+
+    // 最大 65535x65535x3 字节/帧，用 64 位算，超出 32 位的文件视为非法
+    uint64_t size = anim_frames_offset(frame_count) + (uint64_t)width * height * 3 * frame_count;
+    return size > UINT32_MAX ? 0 : (uint32_t)size;
+}
+
+bool anim_parse(const uint8_t *buf, size_t len, anim_info_t *out)
+{
+    uint32_t size = anim_image_size(buf, len);
+    if (size == 0 || size > len || !out) return false;
+
+    out->width = rd_le16(buf + 6);
+    out->height = rd_le16(buf + 8);
+    out->frame_count = rd_le16(buf + 10);
+    out->loop_count = rd_le16(buf + 12);
+    out->frame_size = (uint32_t)out->width * out->height * 3;
+    out->durations = buf + ANIM_HEADER_LEN;
+    out->frames = buf + anim_frames_offset(out->frame_count);
+    return true;
+}
+
+uint16_t anim_frame_duration(const anim_info_t *info, uint16_t index)
+{
+    return rd_le16(info->durations + index * 2);
+}
+
+const uint8_t *anim_frame_data(const anim_info_t *info, uint16_t index)
+{
+    return info->frames + (uint32_t)index * info->frame_size;
+}
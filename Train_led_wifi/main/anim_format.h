@@ -0,0 +1,49 @@
+/* Flash 动画文件格式
+ * 纯数据解析，不依赖 ESP-IDF；动画数据由调用方映射到内存 (esp_partition_mmap) 后直接引用，不做拷贝
+ *
+ * 所有多字节字段均为小端：
+ *   [0..3]   魔数 "LEDA"
+ *   [4]      版本号 (1)
+ *   [5]      保留，填 0
+ *   [6..7]   画布宽度
+ *   [8..9]   画布高度
+ *   [10..11] 帧数
+ *   [12..13] 播放遍数，0 表示无限循环
+ *   [14..15] 保留，填 0
+ *   [16..]   每帧显示时长 (uint16 毫秒) × 帧数，之后补 0 到 4 字节对齐
+ *   [..]     帧数据：每帧 宽×高 个像素，逐行 R,G,B (同 /api/matrix/raw 的 RGB888)
+ */
+#ifndef ANIM_FORMAT_H
+#define ANIM_FORMAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ANIM_MAGIC          "LEDA"
+#define ANIM_VERSION        1
+#define ANIM_HEADER_LEN     16
+
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    uint16_t frame_count;
+    uint16_t loop_count;        // 0: 无限循环
+    uint32_t frame_size;        // 每帧字节数
+    const uint8_t *durations;   // 指向时长表
+    const uint8_t *frames;      // 指向第0帧
+} anim_info_t;
+
+/* 根据文件头计算整个动画文件的字节数，只需要前 ANIM_HEADER_LEN 字节
+ * 文件头非法返回 0
+ */
+uint32_t anim_image_size(const uint8_t *buf, size_t len);
+
+// 解析完整的动画文件，len 小于文件头声明的大小时返回 false
+bool anim_parse(const uint8_t *buf, size_t len, anim_info_t *out);
+
+// 第 index 帧的显示时长 (毫秒) 和像素数据，调用方保证 index < frame_count
+uint16_t anim_frame_duration(const anim_info_t *info, uint16_t index);
+const uint8_t *anim_frame_data(const anim_info_t *info, uint16_t index);
+
+#endif // ANIM_FORMAT_H
@@ -1,28 +1,45 @@
 /* ESP32-C3 LED Matrix Web Server (v4.0)
  * * 核心功能：
- * 1. 启动流程：开机动画 -> 滚动文字 -> 连接WiFi -> 状态指示(IP/超时)
+ * 1. 启动流程：WiFi 和 HTTP 服务立即启动，同时播放开机动画 -> 滚动文字 -> 状态指示(IP/超时)，
+ *    客户端的第一帧到达时开机画面立即结束
  * 2. Web控制：支持亮度调节和像素数组下发
  * 3. 物理按键 (GPIO 10)：
- * - 单击开关屏幕
+ * - 单击开关屏幕，双击切换本地画面，长按循环切换亮度
  * - 关灯模式：仅熄灭LED，显存(Buffer)数据保留
  * - 开灯模式：从显存恢复之前的画面
+ * 4. 断电保存：客户端发来的画面、整体亮度和开关屏状态写入 NVS，重启后立即恢复
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
 #include "nvs_flash.h"
 #include "esp_http_server.h"
+#include "lwip/sockets.h"
 #include "cJSON.h"
 #include "led_strip.h"
 #include "driver/gpio.h"
 #include "font8x8.h"
+#include "pixel_proto.h"
+#include "matrix_layout.h"
+#include "anim_format.h"
+#include "frame_codec.h"
+#include "perf_stats.h"
+#include "frame_pool.h"
+#include "persist.h"
+#include "json_frame.h"
 #include "math.h"
 
 static const char *TAG = "matrix_main";
@@ -31,8 +48,6 @@ static const char *TAG = "matrix_main";
 #define WIFI_SSID       "auto_kx_D710"
 #define WIFI_PASS       "31130100"
 #define LED_STRIP_GPIO  3
-#define MATRIX_WIDTH    8
-#define MATRIX_HEIGHT   8
 #define WIFI_TIMEOUT_MS 10000
 #define GPIO_INPUT_PIN  10    // 物理按键
 
@@ -47,344 +62,2246 @@ typedef struct {
     uint8_t b;
 } pixel_color_t;
 
-// 显存缓冲区 (Shadow Buffer) - 用于关灯时保存状态
-static pixel_color_t s_screen_buffer[64];
+// 虚拟画布：多块面板拼接成的整体画面，尺寸在启动时由配置确定
+static uint16_t s_canvas_width;
+static uint16_t s_canvas_height;
+static uint32_t s_canvas_pixels;
 
-// 屏幕开关状态标志
-volatile bool g_display_enable = false;
+// 一帧画面：8位整数部分 + gamma/亮度换算后被截掉的低8位 (供时间抖动使用)
+// 两部分在同一块连续内存中 (frac 紧跟 px)，整帧可以一次拷贝
+typedef struct {
+    pixel_color_t *px;
+    pixel_color_t *frac;
+} frame_t;
+
+static size_t frame_bytes(void)
+{
+    return s_canvas_pixels * sizeof(pixel_color_t) * 2;
+}
+
+static esp_err_t frame_alloc(frame_t *frame)
+{
+    frame->px = calloc(1, frame_bytes());
+    if (!frame->px) return ESP_ERR_NO_MEM;
+    frame->frac = frame->px + s_canvas_pixels;
+    return ESP_OK;
+}
+
+// 屏幕开关状态标志：只由按键任务写，渲染任务每帧读取
+atomic_bool g_display_enable = false;
 
 // WiFi事件组
 static EventGroupHandle_t s_wifi_event_group;
 #define WIFI_CONNECTED_BIT BIT0
 
+/* ================== 帧缓冲 ================== */
+/* 会绘图的任务 (httpd、esp_timer、主任务、按键、UDP) 各有一块私有的后台帧：
+ * 任务第一次写像素时从帧池取一个空闲帧，以最新提交的画面为底稿，之后的绘制只改这块帧，
+ * matrix_refresh 时整帧发布 (见 frame_pool.h)。渲染任务只读取已发布的帧，
+ * 不会看到另一个任务画了一半或刚清空的画面，绘制和输出之间也没有互斥量。
+ */
+
+#define FB_WRITERS      6                   // 同时存在的绘图任务数上限 (任务结束后登记项可再用)
+#define FB_SLOTS        (FB_WRITERS + 3)    // 每个绘图任务一帧 + 最新帧 + 渲染任务的当前帧和新帧
+#define FB_TLS_INDEX    1                   // 任务的登记项存在这个线程局部存储指针里 (0 号由 pthread/lwIP 使用)
+
+_Static_assert(CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS > FB_TLS_INDEX,
+               "CONFIG_FREERTOS_THREAD_LOCAL_STORAGE_POINTERS is too small for FB_TLS_INDEX");
+
+static frame_pool_t s_fb_pool;
+static frame_t s_fb_frames[FB_SLOTS];
+
+// 绘图任务的登记项：正在绘制的帧槽 (-1 表示没有未提交的修改)，任务删除时释放
+typedef struct {
+    atomic_bool used;
+    int slot;
+    bool delta;         // 后台帧由压缩帧解码器写入 (见 matrix_load_delta_frame)
+} fb_writer_t;
+
+static fb_writer_t s_fb_writers[FB_WRITERS];
+
+// 压缩帧以外的来源提交过帧：解码器的参考帧与屏幕不一致，下一个差分帧要求关键帧
+static atomic_bool s_delta_ref_stale;
+
+static esp_err_t fb_init(void)
+{
+    frame_pool_init(&s_fb_pool, FB_SLOTS);
+    for (int i = 0; i < FB_SLOTS; i++) {
+        if (frame_alloc(&s_fb_frames[i]) != ESP_OK) return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < FB_WRITERS; i++) {
+        s_fb_writers[i].slot = -1;
+    }
+    // 发布一帧黑屏作为第一份底稿
+    frame_pool_publish(&s_fb_pool, frame_pool_acquire(&s_fb_pool));
+    return ESP_OK;
+}
+
+// 任务删除时由 FreeRTOS 调用 (例如开机画面任务结束)：丢掉没提交的帧，登记项留给以后的任务
+static void fb_writer_release(int index, void *ptr)
+{
+    fb_writer_t *w = ptr;
+    if (w->slot >= 0) frame_pool_release(&s_fb_pool, w->slot);
+    w->slot = -1;
+    w->delta = false;
+    atomic_store(&w->used, false);
+}
+
+// 当前任务的登记项：第一次绘图时占一个空闲项并记在任务的线程局部存储里，之后直接取出，不再逐项查找。
+// 登记项用完时返回 NULL (只打印一次错误)，这个任务的绘制被忽略
+static fb_writer_t *fb_writer(void)
+{
+    fb_writer_t *w = pvTaskGetThreadLocalStoragePointer(NULL, FB_TLS_INDEX);
+    if (w) return w;
+    for (int i = 0; i < FB_WRITERS; i++) {
+        bool used = false;
+        if (atomic_compare_exchange_strong(&s_fb_writers[i].used, &used, true)) {
+            vTaskSetThreadLocalStoragePointerAndDelCallback(NULL, FB_TLS_INDEX, &s_fb_writers[i], fb_writer_release);
+            return &s_fb_writers[i];
+        }
+    }
+    static atomic_bool logged;
+    if (!atomic_exchange(&logged, true)) {
+        ESP_LOGE(TAG, "More than %d tasks draw to the matrix, drawing from %s is ignored", FB_WRITERS,
+                 pcTaskGetName(NULL));
+    }
+    return NULL;
+}
+
+// 当前任务的后台帧 (没有空闲登记项时为 NULL)；load_latest 为 false 时不拷贝底稿 (调用方马上整帧覆盖)
+static frame_t *fb_back(bool load_latest)
+{
+    fb_writer_t *w = fb_writer();
+    if (!w) return NULL;
+    if (w->slot < 0) {
+        int slot;
+        // 槽数按上限分配，只会因为读取方的瞬时引用短暂失败
+        while ((slot = frame_pool_acquire(&s_fb_pool)) < 0) {
+            taskYIELD();
+        }
+        if (load_latest) {
+            int base = frame_pool_get_latest(&s_fb_pool);
+            memcpy(s_fb_frames[slot].px, s_fb_frames[base].px, frame_bytes());
+            frame_pool_release(&s_fb_pool, base);
+        }
+        w->slot = slot;
+    }
+    return &s_fb_frames[w->slot];
+}
+
+/* ================== 性能统计 ================== */
+/* 热路径的耗时直方图 (见 perf_stats.h)，由 GET /api/stats 输出。
+ * 每个直方图只有一个写入任务：接收/解析/写显存只在 httpd 任务 (HTTP 与 WebSocket 处理函数) 中记录，
+ * 灯带刷新只在渲染任务中记录 */
+static perf_hist_t s_hist_http_recv = PERF_HIST_INIT("http_recv", "Time to receive the body of a frame request");
+static perf_hist_t s_hist_json_parse = PERF_HIST_INIT("json_parse", "Time to parse POST /api/matrix and write its pixels");
+static perf_hist_t s_hist_fb_update = PERF_HIST_INIT("fb_update", "Time to write a received raw or WebSocket frame into the framebuffer");
+static perf_hist_t s_hist_strip_refresh = PERF_HIST_INIT("strip_refresh", "Time spent in led_strip calls per sent frame, including the wait for the previous transmission");
+
+static inline uint32_t perf_elapsed_us(int64_t start_us)
+{
+    return (uint32_t)(esp_timer_get_time() - start_us);
+}
+
+/* ================== 渲染任务 ================== */
+/* 只有渲染任务访问灯带 (led_strip_*)，按固定帧率输出。
+ * 生产者 (HTTP/UDP/动画) 通过帧池发布整帧，新帧直接替换未取走的旧帧 (latest wins)，
+ * 网络抖动不会影响输出节奏，也不会排队积压。
+ */
+
+#define RENDER_PERIOD_US    (1000000 / CONFIG_MATRIX_RENDER_FPS)
+#define RENDER_REPORT_US    (5 * 1000 * 1000)   // 统计日志间隔
+#define RENDER_FPS_WINDOW_US (1000 * 1000)      // 帧率统计窗口
+
+static TaskHandle_t s_render_task;
+
+#if CONFIG_MATRIX_TEMPORAL_DITHER
+/* 时间抖动：每帧把低8位累加到误差累加器，溢出时该帧输出+1，
+ * 多帧平均后得到8位以下的亮度级，低亮度下渐变不再断层 */
+static uint8_t *s_dither_acc;           // 每通道一个字节
+
+// 返回 true 表示当前帧带有小数部分，需要每个周期都刷新
+static bool frame_has_frac(const frame_t *frame)
+{
+    const uint8_t *frac = (const uint8_t *)frame->frac;
+    for (int i = 0; i < s_canvas_pixels * 3; i++) {
+        if (frac[i]) return true;
+    }
+    return false;
+}
+#endif
+
+/* 整体亮度：按键长按循环切换，在发送前按查找表统一缩放，不改动各来源写入的帧，
+ * 切回 100% 时原样输出 */
+static const uint8_t s_output_levels[] = { 100, 50, 25, 10 };
+static volatile uint8_t s_output_level = 100;
+static uint8_t s_output_lut[256];
+
+// 切换到下一档亮度，返回新的百分比 (渲染任务在下一帧整帧重发)
+int render_next_output_level(void)
+{
+    int next = 0;
+    for (int i = 0; i < sizeof(s_output_levels); i++) {
+        if (s_output_levels[i] == s_output_level) {
+            next = (i + 1) % sizeof(s_output_levels);
+            break;
+        }
+    }
+    s_output_level = s_output_levels[next];
+    return s_output_level;
+}
+
+/* 灯带缓冲区：按灯带原生的颜色顺序存放，挂到 led_strip 上直接作为发送源 (led_strip_attach_buffer)，
+ * 驱动不再另存像素。渲染任务把当前帧一次换算 (抖动、整体亮度、通道顺序) 后写入这里 */
+#define STRIP_COLOR_FORMAT  LED_STRIP_COLOR_COMPONENT_FMT_GRB
+
+static uint8_t *s_strip_buf;
+
+// 把帧的前 len 个灯珠写入灯带缓冲区，调用前上一次发送必须已经结束。
+// 值有变化的灯珠按连续区间报告给驱动 (led_strip_mark_changed)，符号缓存只重新编码这些灯珠
+static void render_output(const frame_t *frame, uint32_t len, bool dithering, uint8_t level)
+{
+    const led_color_component_format_t fmt = STRIP_COLOR_FORMAT;
+    const uint8_t *px = (const uint8_t *)frame->px;
+#if CONFIG_MATRIX_TEMPORAL_DITHER
+    const uint8_t *frac = (const uint8_t *)frame->frac;
+#endif
+    uint8_t *dst = s_strip_buf;
+    uint32_t run_start = 0;     // 当前变化区间的起点
+    uint32_t run_len = 0;
+    for (uint32_t i = 0; i < len * 3; i += 3, dst += 3) {
+        uint8_t rgb[3];
+        for (int c = 0; c < 3; c++) {
+            uint16_t v = px[i + c];
+#if CONFIG_MATRIX_TEMPORAL_DITHER
+            if (dithering) {
+                uint16_t acc = s_dither_acc[i + c] + frac[i + c];
+                s_dither_acc[i + c] = acc & 0xFF;
+                v = MIN(v + (acc >> 8), 255);
+            }
+#endif
+            rgb[c] = level < 100 ? s_output_lut[v] : v;
+        }
+        if (dst[fmt.format.r_pos] == rgb[0] && dst[fmt.format.g_pos] == rgb[1] && dst[fmt.format.b_pos] == rgb[2]) {
+            if (run_len) {
+                led_strip_mark_changed(led_strip, run_start, run_len);
+                run_len = 0;
+            }
+            continue;
+        }
+        if (!run_len) {
+            run_start = i / 3;
+        }
+        run_len++;
+        dst[fmt.format.r_pos] = rgb[0];
+        dst[fmt.format.g_pos] = rgb[1];
+        dst[fmt.format.b_pos] = rgb[2];
+    }
+    if (run_len) {
+        led_strip_mark_changed(led_strip, run_start, run_len);
+    }
+}
+
+/* 返回需要重新发送的灯珠数 (最后一个变化像素的索引+1)，0 表示整帧没有变化。
+ * 灯带只能从头开始串行发送，只有链前段变化时可以只发前段，后段保持原来的颜色 */
+static uint32_t frame_changed_len(const frame_t *a, const frame_t *b)
+{
+    if (memcmp(a->px, b->px, frame_bytes()) == 0) return 0;
+    for (uint32_t i = s_canvas_pixels; i > 0; i--) {
+        if (memcmp(&a->px[i - 1], &b->px[i - 1], sizeof(pixel_color_t)) ||
+            memcmp(&a->frac[i - 1], &b->frac[i - 1], sizeof(pixel_color_t))) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// 渲染统计
+static uint32_t s_render_presented;
+static uint32_t s_render_skipped;   // 内容与当前帧相同、没有发送的帧
+static uint32_t s_render_partial;   // 只发送了链前段的帧
+static uint32_t s_render_dropped;   // 被后来的帧替换、从未显示的帧
+static uint32_t s_render_missed;    // 错过的帧周期 (渲染耗时超过一个周期)
+static uint32_t s_render_fps_x100;  // 上一个统计窗口内实际发送到灯带的帧率 ×100
+
+static void render_tick_cb(void *arg)
+{
+    xTaskNotifyGive(s_render_task);
+}
+
+void render_task(void *pvParameters)
+{
+    bool shown_enable = false;
+    uint8_t shown_level = 100;
+    // 当前显示的帧 (关灯期间保留) 一直持有引用，新帧与它比较后替换
+    int shown_slot = frame_pool_get_latest(&s_fb_pool);
+    uint32_t shown_seq = frame_pool_seq(&s_fb_pool);
+    bool dithering = false;
+    int64_t last_report = esp_timer_get_time();
+    uint32_t last_missed = 0;
+    uint32_t last_presented = 0;
+    uint32_t last_skipped = 0;
+    int64_t fps_window_start = last_report;
+    uint32_t fps_window_presented = 0;
+
+    while (1) {
+        // 每个周期定时器通知一次，积压的通知数 >1 说明上一帧处理超时
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (ticks > 1) {
+            s_render_missed += ticks - 1;
+        }
+
+        // 需要发送的灯珠数，0 表示本周期不刷新
+        uint32_t send_len = 0;
+        uint32_t seq = frame_pool_seq(&s_fb_pool);
+        if (seq != shown_seq) {
+            // 两次读取之间发布的其余帧都被替换掉了
+            s_render_dropped += seq - shown_seq - 1;
+            shown_seq = seq;
+            int next = frame_pool_get_latest(&s_fb_pool);
+            if (next != shown_slot) {
+                send_len = frame_changed_len(&s_fb_frames[next], &s_fb_frames[shown_slot]);
+            }
+            if (send_len) {
+                frame_pool_release(&s_fb_pool, shown_slot);
+                shown_slot = next;
+            } else {
+                frame_pool_release(&s_fb_pool, next);
+                s_render_skipped++;
+            }
+        }
+        const frame_t *frame = &s_fb_frames[shown_slot];
+        bool was_dithering = dithering;
+#if CONFIG_MATRIX_TEMPORAL_DITHER
+        if (send_len) {
+            dithering = frame_has_frac(frame);
+        }
+#endif
+        bool enable = atomic_load(&g_display_enable);
+        bool switched = enable != shown_enable;
+        if (switched) {
+            // 开关屏：开灯时从保留的帧重新生成输出，关灯只灭灯不清帧
+            ESP_LOGI(TAG, "%s", enable ? "Display ON: Restoring frame..." : "Display OFF: Saving power...");
+            shown_enable = enable;
+            send_len = s_canvas_pixels;
+        }
+        uint8_t level = s_output_level;
+        if (level != shown_level) {
+            for (int v = 0; v < 256; v++) {
+                s_output_lut[v] = (v * level + 50) / 100;
+            }
+            shown_level = level;
+            send_len = s_canvas_pixels;
+        }
+        // 抖动输出每帧都可能变化任意像素，抖动结束的那一帧也要整帧覆盖
+        if (enable && (dithering || was_dithering)) {
+            send_len = s_canvas_pixels;
+        }
+        // 关灯期间只在关的那一刻发一帧黑色，之后不再发送，新帧只在帧池中保留
+        if (!enable && !switched) {
+            send_len = 0;
+        }
+
+        if (send_len) {
+            int64_t refresh_start = esp_timer_get_time();
+            if (enable) {
+                // 灯带缓冲区就是发送源，等上一帧发完再写；变化位置之后的像素与缓冲区中的相同，不用再写
+                led_strip_wait_refresh_done(led_strip, -1);
+                render_output(frame, send_len, dithering, level);
+                led_strip_refresh_partial_async(led_strip, send_len);
+                if (send_len < s_canvas_pixels) {
+                    s_render_partial++;
+                }
+            } else {
+                led_strip_clear(led_strip);
+            }
+            perf_hist_record(&s_hist_strip_refresh, perf_elapsed_us(refresh_start));
+            s_render_presented++;
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now - fps_window_start >= RENDER_FPS_WINDOW_US) {
+            s_render_fps_x100 = (uint64_t)(s_render_presented - fps_window_presented) * 100 * 1000000 / (now - fps_window_start);
+            fps_window_presented = s_render_presented;
+            fps_window_start = now;
+        }
+        if (now - last_report >= RENDER_REPORT_US) {
+            if (s_render_missed != last_missed) {
+                ESP_LOGW(TAG, "Render: %lu deadline misses (presented %lu, dropped %lu)",
+                         (unsigned long)(s_render_missed - last_missed),
+                         (unsigned long)s_render_presented, (unsigned long)s_render_dropped);
+                last_missed = s_render_missed;
+            }
+            if (s_render_presented != last_presented || s_render_skipped != last_skipped) {
+                ESP_LOGI(TAG, "Render: sent %lu (partial %lu), skipped %lu unchanged",
+                         (unsigned long)(s_render_presented - last_presented),
+                         (unsigned long)s_render_partial, (unsigned long)(s_render_skipped - last_skipped));
+                last_presented = s_render_presented;
+                last_skipped = s_render_skipped;
+            }
+            last_report = now;
+        }
+    }
+}
+
+static void render_start(void)
+{
+    xTaskCreate(render_task, "render", 3072, NULL, 6, &s_render_task);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = render_tick_cb,
+        .name = "render_tick",
+    };
+    esp_timer_handle_t timer;
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(timer, RENDER_PERIOD_US));
+    ESP_LOGI(TAG, "Render task started at %d fps", CONFIG_MATRIX_RENDER_FPS);
+}
+
+/* ================== 开机流程 ================== */
+/* WiFi 和 HTTP 服务在上电后立即启动，开机画面 (动画、连接中、IP、图标) 在 boot 任务中同时播放。
+ * 客户端的第一帧 (或文字、动画请求) 到达时 boot_cancel 结束开机画面：boot 任务此后提交的帧都被丢弃，
+ * 判断和提交在同一把锁内，客户端的帧不会被一帧迟到的开机画面盖掉。
+ * boot 任务开始的滚动 (IP、TIMEOUT) 由定时器绘制，scroller_start 同样在锁内判断是否已取消，
+ * 取消之后不会再开始；已经开始的由 boot_cancel 停下。锁是递归的，锁内还要经过 matrix_refresh。
+ */
+
+static struct {
+    SemaphoreHandle_t lock;
+    TaskHandle_t task;                  // 正在播放开机画面的任务，播放结束后为 NULL
+    atomic_bool cancelled;
+} s_boot;
+
+// 开机各阶段的时间点 (距上电)
+static void boot_mark(const char *phase)
+{
+    ESP_LOGI(TAG, "Boot %5lld ms: %s", (long long)(esp_timer_get_time() / 1000), phase);
+}
+
+// 开机画面已被客户端的画面取代，只在 boot 任务中为 true
+static bool boot_interrupted(void)
+{
+    return s_boot.task == xTaskGetCurrentTaskHandle() && atomic_load(&s_boot.cancelled);
+}
+
+void scroller_stop(void);
+
+// 客户端开始显示自己的内容：结束开机画面 (只有第一次有效)
+static void boot_cancel(void)
+{
+    if (!s_boot.task || atomic_load(&s_boot.cancelled)) return;
+    xSemaphoreTakeRecursive(s_boot.lock, portMAX_DELAY);
+    bool first = !atomic_exchange(&s_boot.cancelled, true);
+    xSemaphoreGiveRecursive(s_boot.lock);
+    if (first) {
+        // 开机画面里的 IP 滚动在定时器中运行，也要停下
+        scroller_stop();
+        boot_mark("first frame from a client, boot visuals stopped");
+    }
+}
+
 /* ================== LED 驱动层 ================== */
 
-// 刷新LED：只有在开启状态下才推数据
-void matrix_refresh() {
-    if (g_display_enable) {
-        led_strip_refresh(led_strip);
+// 提交当前任务画好的帧：由渲染任务在下一个帧周期输出 (关灯时只保存不显示)
+void matrix_refresh() {
+    fb_writer_t *w = fb_writer();
+    if (!w || w->slot < 0) return;
+    int slot = w->slot;
+    bool delta = w->delta;
+    w->slot = -1;
+    w->delta = false;
+    if (s_boot.task == xTaskGetCurrentTaskHandle()) {
+        // 开机画面：与 boot_cancel 互斥，被取消后不再提交
+        xSemaphoreTakeRecursive(s_boot.lock, portMAX_DELAY);
+        if (atomic_load(&s_boot.cancelled)) {
+            frame_pool_release(&s_fb_pool, slot);
+        } else {
+            atomic_store(&s_delta_ref_stale, true);
+            frame_pool_publish(&s_fb_pool, slot);
+        }
+        xSemaphoreGiveRecursive(s_boot.lock);
+        return;
+    }
+    if (!delta) atomic_store(&s_delta_ref_stale, true);
+    frame_pool_publish(&s_fb_pool, slot);
+}
+
+// 放弃当前任务画了一半的帧 (例如请求中途出错)，屏幕保持原样
+void matrix_discard(void)
+{
+    fb_writer_t *w = fb_writer();
+    if (!w || w->slot < 0) return;
+    int slot = w->slot;
+    w->slot = -1;
+    w->delta = false;
+    frame_pool_release(&s_fb_pool, slot);
+}
+
+// 清屏：只清当前任务的后台帧，下次 matrix_refresh 时整帧生效，不会先闪黑再画
+void matrix_clear_all(void)
+{
+    frame_t *fb = fb_back(false);
+    if (fb) memset(fb->px, 0, frame_bytes());
+}
+
+/* ================== 物理布局 ================== */
+
+// 坐标 -> 灯带索引查找表，由布局描述生成，写像素时只查表
+static uint16_t *s_layout_lut;
+static matrix_layout_t s_layout;     // 当前生效的单块面板布局
+static bool s_layout_identity;       // 灯带按画布的行顺序走线 (查找表为恒等映射)，整帧写入时不用查表
+
+// 面板拼接方式
+static const matrix_tiling_t s_tiling = {
+    .tiles_x = CONFIG_MATRIX_TILES_X,
+    .tiles_y = CONFIG_MATRIX_TILES_Y,
+#if CONFIG_MATRIX_TILES_SERPENTINE
+    .serpentine = true,
+#endif
+};
+
+// menuconfig 中配置的默认布局
+static const matrix_layout_t s_default_layout = {
+    .width = CONFIG_MATRIX_PANEL_WIDTH,
+    .height = CONFIG_MATRIX_PANEL_HEIGHT,
+#if CONFIG_MATRIX_LAYOUT_ORIGIN_TOP_RIGHT
+    .origin = LAYOUT_ORIGIN_TOP_RIGHT,
+#elif CONFIG_MATRIX_LAYOUT_ORIGIN_BOTTOM_LEFT
+    .origin = LAYOUT_ORIGIN_BOTTOM_LEFT,
+#elif CONFIG_MATRIX_LAYOUT_ORIGIN_BOTTOM_RIGHT
+    .origin = LAYOUT_ORIGIN_BOTTOM_RIGHT,
+#else
+    .origin = LAYOUT_ORIGIN_TOP_LEFT,
+#endif
+#if CONFIG_MATRIX_LAYOUT_SERPENTINE
+    .serpentine = true,
+#endif
+    .rotation = CONFIG_MATRIX_LAYOUT_ROTATION,
+#if CONFIG_MATRIX_LAYOUT_MIRROR
+    .mirror = true,
+#endif
+};
+
+// 切换面板布局 (启动时或运行时)，拼接后的画布尺寸必须保持不变
+esp_err_t matrix_set_layout(const matrix_layout_t *layout)
+{
+    if (matrix_layout_logical_width(layout) * s_tiling.tiles_x != s_canvas_width ||
+        matrix_layout_logical_height(layout) * s_tiling.tiles_y != s_canvas_height) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint16_t *lut = malloc(s_canvas_pixels * sizeof(uint16_t));
+    if (!lut) return ESP_ERR_NO_MEM;
+    if (!matrix_layout_build_tiled(layout, &s_tiling, lut, s_canvas_pixels)) {
+        free(lut);
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 运行时切换时正在绘制的那一帧可能新旧混合，下一帧即恢复正常
+    memcpy(s_layout_lut, lut, s_canvas_pixels * sizeof(uint16_t));
+    free(lut);
+    s_layout = *layout;
+    s_layout_identity = true;
+    for (uint32_t i = 0; i < s_canvas_pixels && s_layout_identity; i++) {
+        s_layout_identity = s_layout_lut[i] == i;
+    }
+    ESP_LOGI(TAG, "Layout: origin %d, %s, rotation %d, mirror %d", layout->origin,
+             layout->serpentine ? "serpentine" : "progressive", layout->rotation, layout->mirror);
+    return ESP_OK;
+}
+
+// 调用方保证坐标在范围内
+static inline uint32_t pos_to_index(int x, int y) {
+    return s_layout_lut[y * s_canvas_width + x];
+}
+
+// 按配置确定画布尺寸并分配显存、渲染帧和查找表
+static esp_err_t canvas_init(void)
+{
+    s_canvas_width = matrix_layout_logical_width(&s_default_layout) * s_tiling.tiles_x;
+    s_canvas_height = matrix_layout_logical_height(&s_default_layout) * s_tiling.tiles_y;
+    s_canvas_pixels = (uint32_t)s_canvas_width * s_canvas_height;
+    // 压缩帧的帧头只有 16 位像素数
+    if (s_canvas_pixels > FRAME_CODEC_MAX_PIXELS) {
+        ESP_LOGE(TAG, "Canvas %dx%d has %lu LEDs, at most %d are supported", s_canvas_width, s_canvas_height,
+                 (unsigned long)s_canvas_pixels, FRAME_CODEC_MAX_PIXELS);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    s_layout_lut = calloc(s_canvas_pixels, sizeof(uint16_t));
+    s_strip_buf = calloc(s_canvas_pixels, STRIP_COLOR_FORMAT.format.num_components);
+    if (!s_layout_lut || !s_strip_buf || fb_init() != ESP_OK) {
+        return ESP_ERR_NO_MEM;
+    }
+#if CONFIG_MATRIX_TEMPORAL_DITHER
+    s_dither_acc = calloc(s_canvas_pixels, 3);
+    if (!s_dither_acc) {
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+    ESP_LOGI(TAG, "Canvas: %dx%d (%dx%d panels, %lu LEDs)", s_canvas_width, s_canvas_height,
+             s_tiling.tiles_x, s_tiling.tiles_y, (unsigned long)s_canvas_pixels);
+    return matrix_set_layout(&s_default_layout);
+}
+
+// 按灯带物理索引写像素，分量为 8.8 定点数 (高8位输出，低8位交给时间抖动)
+static void matrix_set_strip_pixel16(uint32_t index, uint16_t r, uint16_t g, uint16_t b)
+{
+    if (index >= s_canvas_pixels) return;
+
+    frame_t *fb = fb_back(true);
+    if (!fb) return;
+    fb->px[index] = (pixel_color_t) { r >> 8, g >> 8, b >> 8 };
+    fb->frac[index] = (pixel_color_t) { r & 0xFF, g & 0xFF, b & 0xFF };
+}
+
+// 按灯带物理索引写像素
+void matrix_set_strip_pixel(uint32_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    matrix_set_strip_pixel16(index, r << 8, g << 8, b << 8);
+}
+
+// 按灯带物理顺序写入一段 RGB 字节流 (offset 为字节偏移，允许不按像素对齐)
+void matrix_write_strip_bytes(uint32_t offset, const uint8_t *data, size_t len)
+{
+    size_t size = s_canvas_pixels * sizeof(pixel_color_t);
+    if (offset >= size) return;
+    len = MIN(len, size - offset);
+    frame_t *fb = fb_back(true);
+    if (!fb) return;
+    memcpy((uint8_t *)fb->px + offset, data, len);
+    memset((uint8_t *)fb->frac + offset, 0, len);
+}
+
+// 写像素核心函数
+void matrix_set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (x < 0 || y < 0 || x >= s_canvas_width || y >= s_canvas_height) return;
+
+    // 计算物理位置后按灯带索引写入
+    matrix_set_strip_pixel(pos_to_index(x, y), r, g, b);
+}
+
+// 把从 top 开始的 rows 行整体左移一列，最右一列清空
+void matrix_shift_rows_left(int top, int rows)
+{
+    int bottom = MIN(top + rows, s_canvas_height);
+    frame_t *fb = fb_back(true);
+    if (!fb) return;
+    for (int y = MAX(top, 0); y < bottom; y++) {
+        for (int x = 0; x < s_canvas_width - 1; x++) {
+            uint32_t dst = pos_to_index(x, y);
+            uint32_t src = pos_to_index(x + 1, y);
+            fb->px[dst] = fb->px[src];
+            fb->frac[dst] = fb->frac[src];
+        }
+        matrix_set_strip_pixel(pos_to_index(s_canvas_width - 1, y), 0, 0, 0);
+    }
+}
+
+/* gamma + 亮度查找表：8位输入 -> 8.8 定点输出，三个通道共用，逐像素换算只剩查表，没有除法。
+ * 每个亮度一张表，第一次用到时在新分配的缓冲区里建好，再用一次指针交换发布；发布后只读、不释放，
+ * httpd 任务、动画定时器等写入方可以同时查不同亮度的表，拿到的指针一直有效 (最多 101 张，每张 512 字节) */
+#define GAMMA_LUT_LEVELS    101
+
+static _Atomic(const uint16_t *) s_gamma_luts[GAMMA_LUT_LEVELS];
+
+// 返回亮度 (0-100，超出范围取边界) 对应的表，内存不足时返回 NULL
+static const uint16_t *gamma_lut_get(int brightness_percent)
+{
+    brightness_percent = MAX(0, MIN(brightness_percent, GAMMA_LUT_LEVELS - 1));
+    const uint16_t *lut = atomic_load(&s_gamma_luts[brightness_percent]);
+    if (lut) return lut;
+
+    uint16_t *table = malloc(256 * sizeof(uint16_t));
+    if (!table) return NULL;
+    const float gamma = CONFIG_MATRIX_GAMMA_X10 / 10.0f;
+    const float scale = 255.0f * 256.0f * brightness_percent / 100.0f;
+    for (int v = 0; v < 256; v++) {
+        table[v] = (uint16_t)lroundf(powf(v / 255.0f, gamma) * scale);
+    }
+    const uint16_t *published = NULL;
+    if (!atomic_compare_exchange_strong(&s_gamma_luts[brightness_percent], &published, table)) {
+        // 另一个写入方先发布了同一亮度的表 (内容相同)，用它的
+        free(table);
+        return published;
+    }
+    return table;
+}
+
+// 辅助：按线性索引设置像素 (带gamma和亮度处理)
+void set_pixel_by_index(int index, int color_val, int brightness_percent) {
+    int x = index % s_canvas_width;
+    int y = index / s_canvas_width;
+    if (index < 0 || y >= s_canvas_height) return;
+
+    const uint16_t *gamma = gamma_lut_get(brightness_percent);
+    if (!gamma) return;
+
+    matrix_set_strip_pixel16(pos_to_index(x, y),
+                             gamma[(color_val >> 16) & 0xFF],
+                             gamma[(color_val >> 8) & 0xFF],
+                             gamma[color_val & 0xFF]);
+}
+
+// 原始帧像素格式 (由 Content-Type 决定)
+typedef enum {
+    RAW_FMT_RGB888, // application/octet-stream: 每像素3字节 R,G,B
+    RAW_FMT_RGB565, // application/x-rgb565: 每像素2字节, 小端
+    RAW_FMT_GRB888, // application/x-grb888: 灯珠原生顺序 G,R,B
+    RAW_FMT_DELTA,  // application/x-matrix-delta: 压缩帧 (见 frame_codec.h)，长度可变
+} raw_frame_fmt_t;
+
+// 压缩帧返回最大长度
+static size_t raw_frame_size(raw_frame_fmt_t fmt)
+{
+    if (fmt == RAW_FMT_DELTA) return FRAME_CODEC_MAX_LEN(s_canvas_pixels);
+    return s_canvas_pixels * (fmt == RAW_FMT_RGB565 ? 2 : 3);
+}
+
+// 原始帧写入显存：整帧覆盖，gamma 表和后台帧只取一次 (不拷贝底稿)，逐像素只剩解包和查 gamma 表；
+// 走线为恒等映射时画布索引就是灯带索引，不再查坐标表
+void matrix_load_raw_frame(raw_frame_fmt_t fmt, const uint8_t *data, int brightness_percent)
+{
+    const uint16_t *gamma = gamma_lut_get(brightness_percent);
+    frame_t *fb = fb_back(false);
+    if (!fb || !gamma) return;
+    const uint16_t *lut = s_layout_identity ? NULL : s_layout_lut;
+
+    for (uint32_t i = 0; i < s_canvas_pixels; i++) {
+        uint8_t r, g, b;
+        if (fmt == RAW_FMT_RGB565) {
+            uint16_t v = data[0] | (data[1] << 8);
+            // 5/6位分量扩展到8位 (高位复制到低位)
+            r = (v >> 11) & 0x1F;
+            g = (v >> 5) & 0x3F;
+            b = v & 0x1F;
+            r = (r << 3) | (r >> 2);
+            g = (g << 2) | (g >> 4);
+            b = (b << 3) | (b >> 2);
+            data += 2;
+        } else if (fmt == RAW_FMT_GRB888) {
+            g = data[0];
+            r = data[1];
+            b = data[2];
+            data += 3;
+        } else {
+            r = data[0];
+            g = data[1];
+            b = data[2];
+            data += 3;
+        }
+        uint32_t index = lut ? lut[i] : i;
+        uint16_t r16 = gamma[r], g16 = gamma[g], b16 = gamma[b];
+        fb->px[index] = (pixel_color_t) { r16 >> 8, g16 >> 8, b16 >> 8 };
+        fb->frac[index] = (pixel_color_t) { r16 & 0xFF, g16 & 0xFF, b16 & 0xFF };
+    }
+}
+
+// 压缩帧解码器，参考帧在第一次收到压缩帧时分配；只在 httpd 任务中使用
+static frame_decoder_t s_frame_decoder;
+static int s_frame_decoder_brightness = -1;
+
+static void delta_pixel_cb(uint32_t index, const uint8_t *rgb, void *ctx)
+{
+    set_pixel_by_index(index, (rgb[0] << 16) | (rgb[1] << 8) | rgb[2], *(int *)ctx);
+}
+
+// 压缩帧直接解码进显存，差分帧只改写变化的像素
+frame_decode_result_t matrix_load_delta_frame(const uint8_t *data, size_t len, int brightness_percent)
+{
+    if (!s_frame_decoder.ref) {
+        s_frame_decoder.ref = calloc(s_canvas_pixels, 3);
+        if (!s_frame_decoder.ref) return FRAME_DECODE_BAD_FRAME;
+        s_frame_decoder.pixels = s_canvas_pixels;
+    }
+    // 差分帧只改写变化的像素，其余像素沿用屏幕上的内容：屏幕被其他来源 (JSON、原始帧、UDP、动画、
+    // 文字等) 改过，或者亮度变了，参考帧就对不上了，让客户端补发关键帧 (NEED_KEY / 409)
+    if (atomic_exchange(&s_delta_ref_stale, false) || brightness_percent != s_frame_decoder_brightness) {
+        s_frame_decoder.valid = false;
+    }
+    frame_decode_result_t res = frame_decode(&s_frame_decoder, data, len, delta_pixel_cb, &brightness_percent);
+    if (res == FRAME_DECODE_OK) {
+        s_frame_decoder_brightness = brightness_percent;
+        fb_writer_t *w = fb_writer();
+        if (w) w->delta = true;
+    }
+    return res;
+}
+
+/* ================== 文字滚动 ================== */
+/* 启动时把整条文字按字体渲染成列位图 (每列一个字节，bit y 对应第 y 行)，
+ * 之后由 esp_timer 定时推进：每步把文字所在的8行左移一列，只画最右边新进入的一列。
+ * 节奏由定时器决定，不受网络负载和调用方任务影响；任何任务都可以随时取消。
+ */
+
+#define SCROLL_TEXT_MAX         128     // 超出部分截断
+#define SCROLL_SPEED_MIN_MS     10
+#define SCROLL_SPEED_MAX_MS     1000
+#define SCROLL_IDLE_BIT         BIT0
+
+static struct {
+    SemaphoreHandle_t lock;             // 定时器回调与启动/取消互斥
+    EventGroupHandle_t events;
+    esp_timer_handle_t timer;
+    uint8_t columns[SCROLL_TEXT_MAX * 8];
+    int text_columns;
+    int pos;                            // 下一列在整条滚动中的序号，超过文字部分后补空白直到完全移出
+    int top;                            // 文字带的第一行，8像素高的字形在画布中垂直居中
+    bool loop;
+    bool active;
+    uint8_t r, g, b;
+} s_scroll;
+
+static void scroll_finish_locked(void)
+{
+    esp_timer_stop(s_scroll.timer);
+    s_scroll.active = false;
+    xEventGroupSetBits(s_scroll.events, SCROLL_IDLE_BIT);
+}
+
+static void scroll_tick_cb(void *arg)
+{
+    xSemaphoreTake(s_scroll.lock, portMAX_DELAY);
+    if (s_scroll.active) {
+        matrix_shift_rows_left(s_scroll.top, 8);
+
+        uint8_t col = s_scroll.pos < s_scroll.text_columns ? s_scroll.columns[s_scroll.pos] : 0;
+        for (int y = 0; y < 8; y++) {
+            if (col & (1 << y)) {
+                matrix_set_pixel(s_canvas_width - 1, s_scroll.top + y, s_scroll.r, s_scroll.g, s_scroll.b);
+            }
+        }
+        matrix_refresh();
+
+        // 文字从右侧进入、左侧完全移出
+        if (++s_scroll.pos >= s_scroll.text_columns + s_canvas_width) {
+            if (s_scroll.loop) {
+                s_scroll.pos = 0;
+            } else {
+                scroll_finish_locked();
+            }
+        }
+    }
+    xSemaphoreGive(s_scroll.lock);
+}
+
+static void scroller_init(void)
+{
+    s_scroll.lock = xSemaphoreCreateMutex();
+    s_scroll.events = xEventGroupCreate();
+    xEventGroupSetBits(s_scroll.events, SCROLL_IDLE_BIT);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = scroll_tick_cb,
+        .name = "scroll_tick",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &s_scroll.timer));
+}
+
+void anim_stop(void);
+
+// 开始滚动 (取代正在进行的滚动或动画)，立即返回；speed_ms 为每移动一列的时间
+void scroller_start(const char *text, int speed_ms, uint8_t r, uint8_t g, uint8_t b, bool loop)
+{
+    speed_ms = MAX(SCROLL_SPEED_MIN_MS, MIN(speed_ms, SCROLL_SPEED_MAX_MS));
+    // 开机画面的滚动：判断和开始都在 boot 锁内，已被客户端取消时不开始，也不停掉客户端的动画
+    bool boot = s_boot.task && s_boot.task == xTaskGetCurrentTaskHandle();
+    if (boot) {
+        xSemaphoreTakeRecursive(s_boot.lock, portMAX_DELAY);
+        if (atomic_load(&s_boot.cancelled)) {
+            xSemaphoreGiveRecursive(s_boot.lock);
+            return;
+        }
+    }
+    anim_stop();
+
+    xSemaphoreTake(s_scroll.lock, portMAX_DELAY);
+    esp_timer_stop(s_scroll.timer);
+
+    int len = MIN(strlen(text), SCROLL_TEXT_MAX);
+    for (int i = 0; i < len; i++) {
+        int char_code = (unsigned char)text[i];
+        if (char_code > 127) char_code = '?';
+        memcpy(&s_scroll.columns[i * 8], font8x8[char_code], 8);
+    }
+    s_scroll.text_columns = len * 8;
+    s_scroll.pos = 0;
+    s_scroll.top = (s_canvas_height - 8) / 2;
+    s_scroll.loop = loop;
+    s_scroll.r = r;
+    s_scroll.g = g;
+    s_scroll.b = b;
+    s_scroll.active = true;
+    xEventGroupClearBits(s_scroll.events, SCROLL_IDLE_BIT);
+
+    // 清掉之前的画面，此后每步只动文字所在的行
+    matrix_clear_all();
+    matrix_refresh();
+    esp_timer_start_periodic(s_scroll.timer, speed_ms * 1000);
+    xSemaphoreGive(s_scroll.lock);
+    if (boot) xSemaphoreGiveRecursive(s_boot.lock);
+}
+
+// 取消滚动，画面停在当前位置
+void scroller_stop(void)
+{
+    xSemaphoreTake(s_scroll.lock, portMAX_DELAY);
+    if (s_scroll.active) {
+        scroll_finish_locked();
+    }
+    xSemaphoreGive(s_scroll.lock);
+}
+
+// 等待滚动结束或被取消
+void scroller_wait(void)
+{
+    xEventGroupWaitBits(s_scroll.events, SCROLL_IDLE_BIT, pdFALSE, pdFALSE, portMAX_DELAY);
+}
+
+// 滚动一遍并等待结束 (启动流程使用)
+void scroll_text(const char *text, int speed_ms, uint8_t r, uint8_t g, uint8_t b)
+{
+    scroller_start(text, speed_ms, r, g, b, false);
+    scroller_wait();
+}
+
+/* ================== Flash 动画 ================== */
+/* 动画存放在独立的 anim 分区 (格式见 anim_format.h)，播放时整个文件映射到地址空间，
+ * 每帧直接从 flash 映射区解包写入显存，不占额外内存，也不需要网络。
+ * 帧时间按绝对时刻排期，单帧处理的抖动不会累积成整体变慢。
+ */
+
+#define ANIM_PARTITION_LABEL    "anim"
+#define ANIM_MIN_FRAME_MS       10
+#define ANIM_UPLOAD_CHUNK       1024
+
+static struct {
+    SemaphoreHandle_t lock;             // 定时器回调与播放/停止互斥
+    esp_timer_handle_t timer;
+    const esp_partition_t *part;
+    esp_partition_mmap_handle_t map;
+    anim_info_t info;                   // 帧数据指向映射区
+    uint16_t frame;                     // 下一帧序号
+    uint16_t loops_done;
+    int brightness;
+    int64_t next_us;                    // 下一帧应显示的时刻
+    bool active;
+} s_anim;
+
+static void anim_stop_locked(void)
+{
+    esp_timer_stop(s_anim.timer);
+    if (s_anim.active) {
+        esp_partition_munmap(s_anim.map);
+        s_anim.active = false;
+    }
+}
+
+static void anim_tick_cb(void *arg)
+{
+    xSemaphoreTake(s_anim.lock, portMAX_DELAY);
+    if (s_anim.active) {
+        matrix_load_raw_frame(RAW_FMT_RGB888, anim_frame_data(&s_anim.info, s_anim.frame), s_anim.brightness);
+        matrix_refresh();
+
+        s_anim.next_us += MAX(anim_frame_duration(&s_anim.info, s_anim.frame), ANIM_MIN_FRAME_MS) * 1000;
+        if (++s_anim.frame >= s_anim.info.frame_count) {
+            s_anim.frame = 0;
+            s_anim.loops_done++;
+        }
+        if (s_anim.info.loop_count && s_anim.loops_done >= s_anim.info.loop_count) {
+            // 最后一帧保持在屏幕上
+            anim_stop_locked();
+        } else {
+            esp_timer_start_once(s_anim.timer, MAX(s_anim.next_us - esp_timer_get_time(), 1));
+        }
+    }
+    xSemaphoreGive(s_anim.lock);
+}
+
+static void anim_init(void)
+{
+    s_anim.lock = xSemaphoreCreateMutex();
+    s_anim.part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, ANIM_PARTITION_LABEL);
+    if (!s_anim.part) {
+        ESP_LOGW(TAG, "No '%s' partition, flash animations disabled", ANIM_PARTITION_LABEL);
+    }
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = anim_tick_cb,
+        .name = "anim_tick",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &s_anim.timer));
+}
+
+// 停止播放，画面停在当前帧
+void anim_stop(void)
+{
+    xSemaphoreTake(s_anim.lock, portMAX_DELAY);
+    anim_stop_locked();
+    xSemaphoreGive(s_anim.lock);
+}
+
+// 播放分区中的动画 (取代正在进行的滚动或动画)
+esp_err_t anim_play(int brightness)
+{
+    if (!s_anim.part) return ESP_ERR_NOT_FOUND;
+    scroller_stop();
+
+    uint8_t hdr[ANIM_HEADER_LEN];
+    if (esp_partition_read(s_anim.part, 0, hdr, sizeof(hdr)) != ESP_OK) return ESP_FAIL;
+    uint32_t size = anim_image_size(hdr, sizeof(hdr));
+    if (size == 0 || size > s_anim.part->size) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(s_anim.lock, portMAX_DELAY);
+    anim_stop_locked();
+
+    const void *base;
+    esp_err_t ret = esp_partition_mmap(s_anim.part, 0, size, ESP_PARTITION_MMAP_DATA, &base, &s_anim.map);
+    if (ret != ESP_OK) {
+        xSemaphoreGive(s_anim.lock);
+        return ret;
+    }
+    if (!anim_parse(base, size, &s_anim.info) ||
+            s_anim.info.width != s_canvas_width || s_anim.info.height != s_canvas_height) {
+        esp_partition_munmap(s_anim.map);
+        xSemaphoreGive(s_anim.lock);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    s_anim.frame = 0;
+    s_anim.loops_done = 0;
+    s_anim.brightness = brightness;
+    s_anim.next_us = esp_timer_get_time();
+    s_anim.active = true;
+    esp_timer_start_once(s_anim.timer, 1);
+    xSemaphoreGive(s_anim.lock);
+
+    ESP_LOGI(TAG, "Playing animation: %d frames, %lu bytes", s_anim.info.frame_count, (unsigned long)size);
+    return ESP_OK;
+}
+
+// 外部下发新画面时停止本地的滚动和动画
+void matrix_stop_effects(void)
+{
+    boot_cancel();
+    scroller_stop();
+    anim_stop();
+}
+
+/* ================== 绘图与动画 ================== */
+
+void play_startup_animation(void)
+{
+    float center_x = (s_canvas_width - 1) / 2.0f;
+    float center_y = (s_canvas_height - 1) / 2.0f;
+    float max_radius = sqrtf(center_x * center_x + center_y * center_y) + 1.0f;
+
+    // 扩散圆环动画；开机时客户端的画面到达后立即结束
+    for (float r = 0; r < max_radius; r += 0.5) {
+        if (boot_interrupted()) return;
+        matrix_clear_all(); // 帧重置
+
+        for (int x = 0; x < s_canvas_width; x++) {
+            for (int y = 0; y < s_canvas_height; y++) {
+                float dx = x - center_x;
+                float dy = y - center_y;
+                float dist = sqrt(dx*dx + dy*dy);
+
+                if (dist <= r) {
+                    int brightness = 15;
+                    uint8_t red = (dist < 1.5) ? 100 : 0;
+                    int green = 255 - (dist * 30);
+                    if (green < 0) green = 0;
+                    uint8_t blue = 200;
+
+                    matrix_set_pixel(x, y, (red * brightness)/100, (green * brightness)/100, (blue * brightness)/100);
+                }
+            }
+        }
+        matrix_refresh();
+        vTaskDelay(pdMS_TO_TICKS(80));
+    }
+
+    // 闪白光特效
+    if (boot_interrupted()) return;
+    for (uint32_t i = 0; i < s_canvas_pixels; i++) {
+        matrix_set_strip_pixel(i, 30, 30, 30);
+    }
+    matrix_refresh();
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    matrix_clear_all();
+    matrix_refresh();
+    vTaskDelay(pdMS_TO_TICKS(500));
+}
+
+// 8x8 图标画在画布中央
+static void icon_set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b)
+{
+    matrix_set_pixel(x + (s_canvas_width - 8) / 2, y + (s_canvas_height - 8) / 2, r, g, b);
+}
+
+void draw_success_icon(void)
+{
+    matrix_clear_all(); // 清除之前的文字残留
+
+    uint8_t R = 0, G = 15, B = 0;
+
+    // 绘制外框
+    for(int x=2; x<=5; x++) { icon_set_pixel(x, 0, R, G, B); icon_set_pixel(x, 7, R, G, B); }
+    for(int y=2; y<=5; y++) { icon_set_pixel(0, y, R, G, B); icon_set_pixel(7, y, R, G, B); }
+    icon_set_pixel(1, 1, R, G, B); icon_set_pixel(6, 1, R, G, B);
+    icon_set_pixel(1, 6, R, G, B); icon_set_pixel(6, 6, R, G, B);
+
+    // 绘制对勾
+    uint8_t G_tick = 30;
+    icon_set_pixel(2, 4, 0, G_tick, 0);
+    icon_set_pixel(3, 5, 0, G_tick, 0);
+    icon_set_pixel(4, 4, 0, G_tick, 0);
+    icon_set_pixel(5, 3, 0, G_tick, 0);
+
+    matrix_refresh();
+}
+
+void draw_failure_icon(void)
+{
+    matrix_clear_all();
+
+    uint8_t R = 20, G = 0, B = 0;
+
+    // 外框
+    for(int x=2; x<=5; x++) { icon_set_pixel(x, 0, R, G, B); icon_set_pixel(x, 7, R, G, B); }
+    for(int y=2; y<=5; y++) { icon_set_pixel(0, y, R, G, B); icon_set_pixel(7, y, R, G, B); }
+    icon_set_pixel(1, 1, R, G, B); icon_set_pixel(6, 1, R, G, B);
+    icon_set_pixel(1, 6, R, G, B); icon_set_pixel(6, 6, R, G, B);
+
+    // 叉号
+    for (int i = 2; i <= 5; i++) {
+        icon_set_pixel(i, i, R, G, B);
+        icon_set_pixel(i, 7-i, R, G, B);
+    }
+
+    matrix_refresh();
+}
+
+/* ================== 状态保存 ================== */
+/* 当前画面、整体亮度和开关屏状态保存在 NVS 中，重启 (包括 WiFi 超时后的 esp_restart) 后
+ * 在 configure_led 中恢复，WiFi 连上之前就能显示。写入的合并和去重见 persist.h。
+ * 画面只保存客户端发来的静态帧 (HTTP/WebSocket/UDP)：保存时屏幕上已经是开机画面、滚动文字等
+ * 别的来源提交的帧时，本次不保存画面。
+ */
+
+#define PERSIST_NAMESPACE       "matrix"
+#define PERSIST_QUIET_MS        2000                // 画面静止这么久后保存
+#define PERSIST_MIN_INTERVAL_MS 10000               // 两次写 flash 的最小间隔
+#define PERSIST_MAX_DELAY_MS    (5 * 60 * 1000)     // 持续推流时最晚这么久保存一次
+
+enum { PERSIST_FRAME, PERSIST_LEVEL, PERSIST_DISPLAY };
+
+// 客户端最后一次提交的帧：帧槽和提交后的发布序号，两者都与最新帧相符时才保存
+static _Atomic int s_persist_frame_slot = -1;
+static _Atomic uint32_t s_persist_frame_seq;
+static bool s_frame_restored;           // 启动时恢复了保存的画面
+static TaskHandle_t s_persist_task;
+
+static bool persist_snapshot_frame(void *buf, void *ctx)
+{
+    int slot = frame_pool_get_latest(&s_fb_pool);
+    bool ok = slot == atomic_load(&s_persist_frame_slot) &&
+              frame_pool_seq(&s_fb_pool) == atomic_load(&s_persist_frame_seq);
+    if (ok) {
+        memcpy(buf, s_fb_frames[slot].px, s_canvas_pixels * sizeof(pixel_color_t));
+    }
+    frame_pool_release(&s_fb_pool, slot);
+    return ok;
+}
+
+static bool persist_snapshot_level(void *buf, void *ctx)
+{
+    *(uint8_t *)buf = s_output_level;
+    return true;
+}
+
+static bool persist_snapshot_display(void *buf, void *ctx)
+{
+    *(uint8_t *)buf = atomic_load(&g_display_enable);
+    return true;
+}
+
+static persist_entry_t s_persist_entries[] = {
+    // 只保存 8 位整数部分，大小在启动时按画布确定
+    [PERSIST_FRAME] = { .key = "frame", .snapshot = persist_snapshot_frame },
+    [PERSIST_LEVEL] = { .key = "level", .size = 1, .snapshot = persist_snapshot_level },
+    [PERSIST_DISPLAY] = { .key = "display", .size = 1, .snapshot = persist_snapshot_display },
+};
+
+static persist_t s_persist = {
+    .name_space = PERSIST_NAMESPACE,
+    .entries = s_persist_entries,
+    .count = sizeof(s_persist_entries) / sizeof(s_persist_entries[0]),
+    .quiet_ms = PERSIST_QUIET_MS,
+    .min_interval_ms = PERSIST_MIN_INTERVAL_MS,
+    .max_delay_ms = PERSIST_MAX_DELAY_MS,
+};
+
+static inline uint32_t persist_now_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+// 需要保存的状态变了：只记下时间，由保存任务择时写入
+static void persist_changed(void)
+{
+    if (s_persist_task && persist_mark_dirty(&s_persist, persist_now_ms())) {
+        xTaskNotifyGive(s_persist_task);
+    }
+}
+
+// 提交客户端发来的画面，并安排保存
+void matrix_refresh_and_save(void)
+{
+    fb_writer_t *w = fb_writer();
+    if (!w || w->slot < 0) return;
+    int slot = w->slot;
+    boot_cancel();
+    matrix_refresh();
+    // 序号里可能已经包含别的任务紧接着的提交，那样只会让这一帧不被保存
+    atomic_store(&s_persist_frame_slot, slot);
+    atomic_store(&s_persist_frame_seq, frame_pool_seq(&s_fb_pool));
+    persist_changed();
+}
+
+// 重启之前调用，未到期的修改也立即写入
+static void persist_flush_now(void)
+{
+    if (s_persist_task) {
+        persist_flush(&s_persist, persist_now_ms());
+    }
+}
+
+static void persist_task(void *pvParameters)
+{
+    esp_err_t reported = ESP_OK;
+    while (1) {
+        uint32_t wait = persist_poll(&s_persist, persist_now_ms());
+        if (s_persist.last_err != reported) {
+            reported = s_persist.last_err;
+            if (reported != ESP_OK) {
+                ESP_LOGW(TAG, "Saving state to NVS failed: %s", esp_err_to_name(reported));
+            }
+        }
+        ulTaskNotifyTake(pdTRUE, wait == PERSIST_IDLE ? portMAX_DELAY : pdMS_TO_TICKS(wait) + 1);
+    }
+}
+
+// 恢复保存的亮度、开关屏状态和画面 (写入当前任务的后台帧，由调用方提交)，然后启动保存任务
+static void persist_start(void)
+{
+    s_persist_entries[PERSIST_FRAME].size = s_canvas_pixels * sizeof(pixel_color_t);
+    esp_err_t err = persist_init(&s_persist);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "NVS unavailable, state will not be saved: %s", esp_err_to_name(err));
+        return;
+    }
+    size_t need, have;
+    if (persist_check_space(&s_persist, &need, &have) == ESP_ERR_NVS_NOT_ENOUGH_SPACE) {
+        ESP_LOGE(TAG, "NVS partition too small to save the %lu-pixel frame: %u entries needed, %u available",
+                 (unsigned long)s_canvas_pixels, (unsigned)need, (unsigned)have);
+    }
+
+    uint8_t value;
+    if (persist_restore(&s_persist, PERSIST_LEVEL, &value) == ESP_OK) {
+        for (int i = 0; i < sizeof(s_output_levels); i++) {
+            if (s_output_levels[i] == value) s_output_level = value;
+        }
+    }
+    if (persist_restore(&s_persist, PERSIST_DISPLAY, &value) == ESP_OK) {
+        atomic_store(&g_display_enable, value != 0);
+    }
+    // 小数部分没有保存，恢复的画面按 8 位颜色显示 (没有抖动)，直到客户端发来新的帧
+    frame_t *fb = fb_back(false);
+    if (fb && persist_restore(&s_persist, PERSIST_FRAME, fb->px) == ESP_OK) {
+        memset(fb->frac, 0, s_canvas_pixels * sizeof(pixel_color_t));
+        s_frame_restored = true;
+    }
+    ESP_LOGI(TAG, "Restored state: frame %s, output level %d%%, display %s", s_frame_restored ? "yes" : "no",
+             s_output_level, atomic_load(&g_display_enable) ? "on" : "off");
+
+    xTaskCreate(persist_task, "persist", 3072, NULL, 1, &s_persist_task);
+}
+
+/* ================== 硬件初始化 ================== */
+
+#define SYMBOL_CACHE_MAX_LEDS   256
+
+// 每个输出通道的数据脚，灯带按顺序平均分成若干段，各段在不同通道上同时发送
+static const int s_output_gpios[CONFIG_MATRIX_OUTPUT_CHANNELS] = {
+    LED_STRIP_GPIO,
+#if CONFIG_MATRIX_OUTPUT_CHANNELS >= 2
+    CONFIG_MATRIX_OUTPUT_GPIO_2,
+#endif
+#if CONFIG_MATRIX_OUTPUT_CHANNELS >= 3
+    CONFIG_MATRIX_OUTPUT_GPIO_3,
+#endif
+#if CONFIG_MATRIX_OUTPUT_CHANNELS >= 4
+    CONFIG_MATRIX_OUTPUT_GPIO_4,
+#endif
+};
+
+static void configure_led(void)
+{
+    // 先确定画布尺寸，显存和灯带长度都由它决定
+    ESP_ERROR_CHECK(canvas_init());
+
+    led_strip_config_t strip_config = {
+        .strip_gpio_num = LED_STRIP_GPIO,
+        .max_leds = s_canvas_pixels,
+        .led_model = LED_MODEL_WS2812,
+        .color_component_format = STRIP_COLOR_FORMAT,
+        .flags.invert_out = false,
+    };
+    led_strip_rmt_config_t rmt_config = {
+        .resolution_hz = 10 * 1000 * 1000,
+        .flags.with_dma = false,
+        // 预编码RMT符号，刷新时只重新编码 render_output 报告变化的像素；每颗灯珠占 96 字节，大画布时关闭
+        .flags.use_symbol_cache = s_canvas_pixels / CONFIG_MATRIX_OUTPUT_CHANNELS <= SYMBOL_CACHE_MAX_LEDS,
+        // 发送源是渲染任务的灯带缓冲区，驱动不用再分配像素缓冲区
+        .flags.external_buffer = true,
+    };
+    if (CONFIG_MATRIX_OUTPUT_CHANNELS > 1) {
+        // 多通道并行输出，刷新时间按通道数缩短
+        ESP_ERROR_CHECK(led_strip_new_rmt_multi_device(&strip_config, &rmt_config, s_output_gpios,
+                                                       CONFIG_MATRIX_OUTPUT_CHANNELS, &led_strip));
+    } else {
+        ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip));
+    }
+    ESP_ERROR_CHECK(led_strip_attach_buffer(led_strip, s_strip_buf));
+    led_strip_clear(led_strip);
+
+    // 此后灯带只由渲染任务访问
+    render_start();
+    scroller_init();
+    anim_init();
+
+    // 恢复上次保存的画面和状态，没有保存过时为黑屏
+    matrix_clear_all();
+    persist_start();
+    matrix_refresh();
+}
+
+/* ================== 物理按键 ================== */
+/* 按键不再轮询：边沿中断只负责关中断并启动消抖定时器，电平稳定后由定时器回调判定按下/松开，
+ * 再由手势定时器区分单击、双击和长按。事件通过队列交给按键任务处理，没有按键时不占 CPU。
+ *   单击：开关屏幕
+ *   双击：切换本地画面 (Flash 动画 -> 滚动 IP 地址 -> 就绪图标)
+ *   长按：循环切换整体亮度
+ * 两个定时器回调都在 esp_timer 任务中串行执行，按键状态不需要加锁。
+ */
+
+#define BUTTON_DEBOUNCE_MS      20
+#define BUTTON_LONG_PRESS_MS    800     // 按住超过该时间算长按，不用等松开
+#define BUTTON_DOUBLE_PRESS_MS  300     // 松开后在该时间内再次按下算双击
+#define BUTTON_QUEUE_LEN        4
+
+typedef enum {
+    BUTTON_EVT_CLICK,
+    BUTTON_EVT_DOUBLE_PRESS,
+    BUTTON_EVT_LONG_PRESS,
+} button_event_t;
+
+static struct {
+    QueueHandle_t events;
+    esp_timer_handle_t debounce_timer;
+    esp_timer_handle_t gesture_timer;   // 按下时计长按，松开后计双击窗口
+    bool pressed;                       // 消抖后的状态
+    bool long_fired;                    // 本次按下已经触发过长按，松开时不再算单击
+    bool click_pending;                 // 单击已松开，等待双击窗口结束
+} s_button;
+
+typedef enum {
+    PATTERN_ANIM,
+    PATTERN_IP,
+    PATTERN_READY,
+    PATTERN_COUNT,
+} local_pattern_t;
+
+static local_pattern_t s_pattern = PATTERN_READY;
+
+static void button_emit(button_event_t evt)
+{
+    // 队列满说明按键任务来不及处理，直接丢弃，不阻塞 esp_timer 任务
+    if (xQueueSend(s_button.events, &evt, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Button event %d dropped", evt);
+    }
+}
+
+static void button_on_press(void)
+{
+    esp_timer_stop(s_button.gesture_timer);
+    s_button.long_fired = false;
+    esp_timer_start_once(s_button.gesture_timer, BUTTON_LONG_PRESS_MS * 1000);
+}
+
+static void button_on_release(void)
+{
+    esp_timer_stop(s_button.gesture_timer);
+    if (s_button.long_fired) return;
+    if (s_button.click_pending) {
+        s_button.click_pending = false;
+        button_emit(BUTTON_EVT_DOUBLE_PRESS);
+    } else {
+        s_button.click_pending = true;
+        esp_timer_start_once(s_button.gesture_timer, BUTTON_DOUBLE_PRESS_MS * 1000);
+    }
+}
+
+static void button_gesture_cb(void *arg)
+{
+    if (s_button.pressed) {
+        // 双击的第二下按住不放，按长按处理
+        s_button.click_pending = false;
+        s_button.long_fired = true;
+        button_emit(BUTTON_EVT_LONG_PRESS);
+    } else if (s_button.click_pending) {
+        s_button.click_pending = false;
+        button_emit(BUTTON_EVT_CLICK);
+    }
+}
+
+static bool button_level_pressed(void)
+{
+    // 内部上拉，按下为低电平
+    return gpio_get_level(GPIO_INPUT_PIN) == 0;
+}
+
+static void button_debounce_cb(void *arg)
+{
+    bool pressed = button_level_pressed();
+    if (pressed != s_button.pressed) {
+        s_button.pressed = pressed;
+        if (pressed) {
+            button_on_press();
+        } else {
+            button_on_release();
+        }
+    }
+    gpio_intr_enable(GPIO_INPUT_PIN);
+    // 中断关闭期间电平又变了 (边沿已经错过)，再消抖一次
+    if (button_level_pressed() != s_button.pressed) {
+        gpio_intr_disable(GPIO_INPUT_PIN);
+        esp_timer_start_once(s_button.debounce_timer, BUTTON_DEBOUNCE_MS * 1000);
+    }
+}
+
+static void button_isr(void *arg)
+{
+    // 抖动期间的边沿不再进中断，由消抖定时器到期后重新打开
+    gpio_intr_disable(GPIO_INPUT_PIN);
+    esp_timer_start_once(s_button.debounce_timer, BUTTON_DEBOUNCE_MS * 1000);
+}
+
+// 依次切换本地画面，Flash 中没有可播放的动画时跳过
+static void button_next_pattern(void)
+{
+    for (int i = 0; i < PATTERN_COUNT; i++) {
+        s_pattern = (s_pattern + 1) % PATTERN_COUNT;
+        switch (s_pattern) {
+        case PATTERN_ANIM:
+            if (anim_play(100) == ESP_OK) return;
+            break;
+        case PATTERN_IP:
+            scroller_start(s_ip_addr_str, 60, 0, 15, 15, true);
+            return;
+        default:
+            matrix_stop_effects();
+            draw_success_icon();
+            return;
+        }
+    }
+}
+
+static void button_task(void *pvParameters)
+{
+    button_event_t evt;
+    while (1) {
+        xQueueReceive(s_button.events, &evt, portMAX_DELAY);
+        switch (evt) {
+        case BUTTON_EVT_CLICK:
+            // 翻转显示状态，渲染任务在下一帧负责灭灯/恢复画面
+            atomic_store(&g_display_enable, !atomic_load(&g_display_enable));
+            break;
+        case BUTTON_EVT_DOUBLE_PRESS:
+            atomic_store(&g_display_enable, true);
+            button_next_pattern();
+            ESP_LOGI(TAG, "Button: pattern %d", s_pattern);
+            break;
+        case BUTTON_EVT_LONG_PRESS:
+            atomic_store(&g_display_enable, true);
+            ESP_LOGI(TAG, "Button: output level %d%%", render_next_output_level());
+            break;
+        }
+        persist_changed();
+    }
+}
+
+static void button_init(void)
+{
+    s_button.events = xQueueCreate(BUTTON_QUEUE_LEN, sizeof(button_event_t));
+
+    const esp_timer_create_args_t debounce_args = {
+        .callback = button_debounce_cb,
+        .name = "btn_debounce",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&debounce_args, &s_button.debounce_timer));
+    const esp_timer_create_args_t gesture_args = {
+        .callback = button_gesture_cb,
+        .name = "btn_gesture",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&gesture_args, &s_button.gesture_timer));
+
+    gpio_config_t io_conf = {};
+    io_conf.intr_type = GPIO_INTR_ANYEDGE;
+    io_conf.pin_bit_mask = (1ULL << GPIO_INPUT_PIN);
+    io_conf.mode = GPIO_MODE_INPUT;
+    // 启用内部上拉，低电平为按下
+    io_conf.pull_up_en = 1;
+    io_conf.pull_down_en = 0;
+    ESP_ERROR_CHECK(gpio_config(&io_conf));
+
+    s_button.pressed = button_level_pressed();
+    xTaskCreate(button_task, "btn_task", 3072, NULL, 5, NULL);
+
+    // 其他模块可能已经安装过 GPIO 中断服务
+    esp_err_t ret = gpio_install_isr_service(0);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_ERROR_CHECK(ret);
+    }
+    ESP_ERROR_CHECK(gpio_isr_handler_add(GPIO_INPUT_PIN, button_isr, NULL));
+    ESP_LOGI(TAG, "Button on GPIO %d ready", GPIO_INPUT_PIN);
+}
+
+/* ================== HTTP Server ================== */
+
+static esp_err_t matrix_options_handler(httpd_req_t *req)
+{
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "POST, DELETE, OPTIONS");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "Content-Type");
+    httpd_resp_set_status(req, "200 OK");
+    httpd_resp_send(req, NULL, 0);
+    return ESP_OK;
+}
+
+// httpd_req_recv 可能分多次返回，必须收满 len 字节
+static esp_err_t httpd_recv_all(httpd_req_t *req, char *buf, size_t len)
+{
+    size_t received = 0;
+    while (received < len) {
+        int ret = httpd_req_recv(req, buf + received, len - received);
+        if (ret <= 0) {
+            // 超时已回复 408，调用方不要再发响应
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+                return ESP_ERR_TIMEOUT;
+            }
+            return ESP_FAIL;
+        }
+        received += ret;
+    }
+    return ESP_OK;
+}
+
+#define JSON_DEFAULT_BRIGHTNESS 20
+#define JSON_RECV_CHUNK         512     // 每次从 socket 取的字节数，Body 不整体缓存
+
+static void json_pixel_cb(uint32_t index, int value, void *ctx)
+{
+    const json_frame_parser_t *parser = ctx;
+    set_pixel_by_index(index, value, parser->brightness);
+}
+
+// brightness 字段在 data 之后时，已写入的像素是按默认亮度换算的：整帧按比例换到新亮度
+// (亮度在 gamma 之后线性作用，与直接按新亮度写入只差舍入)
+static void matrix_rescale_brightness(int from_percent, int to_percent)
+{
+    if (to_percent < 0) to_percent = 0;
+    if (to_percent > 100) to_percent = 100;
+    frame_t *fb = fb_back(true);
+    if (!fb) return;
+    uint8_t *px = (uint8_t *)fb->px;
+    uint8_t *frac = (uint8_t *)fb->frac;
+    for (size_t i = 0; i < s_canvas_pixels * sizeof(pixel_color_t); i++) {
+        uint32_t v = (px[i] << 8) | frac[i];
+        v = (v * to_percent + from_percent / 2) / from_percent;
+        px[i] = v >> 8;
+        frac[i] = v & 0xFF;
+    }
+}
+
+// JSON 帧：边接收边解析 (见 json_frame.h)，元素直接写入后台帧，不缓存 Body、不建 cJSON 树，Body 长度不限
+static esp_err_t matrix_post_handler(httpd_req_t *req)
+{
+    json_frame_parser_t parser;
+    json_frame_init(&parser, s_canvas_pixels, JSON_DEFAULT_BRIGHTNESS, json_pixel_cb, &parser);
+    // 收到新画面前先清屏，避免叠加 (只清本任务的后台帧，解析失败时丢弃)
+    matrix_clear_all();
+
+    char chunk[JSON_RECV_CHUNK];
+    size_t left = req->content_len;
+    json_frame_status_t status = JSON_FRAME_MORE;
+    uint32_t recv_us = 0;
+    uint32_t parse_us = 0;
+    // 根对象结束后剩下的内容由 httpd 丢弃
+    while (left > 0 && status == JSON_FRAME_MORE) {
+        int64_t t0 = esp_timer_get_time();
+        int ret = httpd_req_recv(req, chunk, MIN(left, sizeof(chunk)));
+        recv_us += perf_elapsed_us(t0);
+        if (ret <= 0) {
+            matrix_discard();
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) httpd_resp_send_408(req);
+            return ESP_FAIL;
+        }
+        left -= ret;
+
+        t0 = esp_timer_get_time();
+        status = json_frame_feed(&parser, chunk, ret);
+        parse_us += perf_elapsed_us(t0);
+    }
+    if (status == JSON_FRAME_MORE) status = json_frame_finish(&parser);
+    perf_hist_record(&s_hist_http_recv, recv_us);
+    perf_hist_record(&s_hist_json_parse, parse_us);
+
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if (status != JSON_FRAME_DONE || !parser.has_data) {
+        matrix_discard();
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, status != JSON_FRAME_DONE ? "Invalid JSON" : "Missing data");
+        return ESP_FAIL;
+    }
+    if (parser.brightness_after_data) {
+        matrix_rescale_brightness(JSON_DEFAULT_BRIGHTNESS, parser.brightness);
+    }
+    // 新画面接管屏幕
+    matrix_stop_effects();
+    matrix_refresh_and_save();
+    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
+    return ESP_OK;
+}
+
+// 运行时修改布局：{"origin":"top_left","serpentine":false,"rotation":0,"mirror":true}，未给出的字段保持不变
+static esp_err_t layout_post_handler(httpd_req_t *req)
+{
+    static const char *origin_names[] = { "top_left", "top_right", "bottom_left", "bottom_right" };
+    char content[256];
+    if (req->content_len >= sizeof(content)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body too large");
+        return ESP_FAIL;
+    }
+    if (httpd_recv_all(req, content, req->content_len) != ESP_OK) return ESP_FAIL;
+    content[req->content_len] = '\0';
+
+    cJSON *root = cJSON_Parse(content);
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+        return ESP_FAIL;
+    }
+    matrix_layout_t layout = s_layout;
+    cJSON *item = cJSON_GetObjectItem(root, "origin");
+    if (cJSON_IsString(item)) {
+        for (int i = 0; i < sizeof(origin_names) / sizeof(origin_names[0]); i++) {
+            if (strcmp(item->valuestring, origin_names[i]) == 0) layout.origin = i;
+        }
+    }
+    item = cJSON_GetObjectItem(root, "serpentine");
+    if (cJSON_IsBool(item)) layout.serpentine = cJSON_IsTrue(item);
+    item = cJSON_GetObjectItem(root, "rotation");
+    if (cJSON_IsNumber(item)) layout.rotation = item->valueint;
+    item = cJSON_GetObjectItem(root, "mirror");
+    if (cJSON_IsBool(item)) layout.mirror = cJSON_IsTrue(item);
+    cJSON_Delete(root);
+
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if (matrix_set_layout(&layout) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid layout");
+        return ESP_FAIL;
+    }
+    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
+    return ESP_OK;
+}
+
+// 滚动文字：{"text":"Hello","speed":60,"color":16777215,"loop":false}，speed 为每列毫秒数
+static esp_err_t text_post_handler(httpd_req_t *req)
+{
+    char content[SCROLL_TEXT_MAX * 2 + 128];
+    if (req->content_len >= sizeof(content)) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body too large");
+        return ESP_FAIL;
+    }
+    if (httpd_recv_all(req, content, req->content_len) != ESP_OK) return ESP_FAIL;
+    content[req->content_len] = '\0';
+
+    cJSON *root = cJSON_Parse(content);
+    if (!root) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+        return ESP_FAIL;
+    }
+    cJSON *text = cJSON_GetObjectItem(root, "text");
+    if (!cJSON_IsString(text)) {
+        cJSON_Delete(root);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing text");
+        return ESP_FAIL;
+    }
+    int speed = 60;
+    int color = 0x0F0F0F;
+    bool loop = false;
+    cJSON *item = cJSON_GetObjectItem(root, "speed");
+    if (cJSON_IsNumber(item)) speed = item->valueint;
+    item = cJSON_GetObjectItem(root, "color");
+    if (cJSON_IsNumber(item)) color = item->valueint;
+    item = cJSON_GetObjectItem(root, "loop");
+    if (cJSON_IsBool(item)) loop = cJSON_IsTrue(item);
+
+    boot_cancel();
+    scroller_start(text->valuestring, speed, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF, loop);
+    cJSON_Delete(root);
+
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
+    return ESP_OK;
+}
+
+// 取消滚动
+static esp_err_t text_delete_handler(httpd_req_t *req)
+{
+    scroller_stop();
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
+    return ESP_OK;
+}
+
+// 从 ?brightness=N 读取亮度，没有时返回 def
+static int httpd_query_brightness(httpd_req_t *req, int def)
+{
+    char query[32];
+    char param[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+            httpd_query_key_value(query, "brightness", param, sizeof(param)) == ESP_OK) {
+        return atoi(param);
+    }
+    return def;
+}
+
+// 上传动画文件：Body 直接流式写入 anim 分区，不在内存中缓存整个文件，写完立即播放
+static esp_err_t anim_upload_handler(httpd_req_t *req)
+{
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    if (!s_anim.part) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No anim partition");
+        return ESP_FAIL;
+    }
+
+    // 先收文件头，确认大小与 Content-Length 一致再擦除
+    uint8_t hdr[ANIM_HEADER_LEN];
+    esp_err_t ret = req->content_len < sizeof(hdr) ? ESP_FAIL : httpd_recv_all(req, (char *)hdr, sizeof(hdr));
+    if (ret != ESP_OK) {
+        if (ret != ESP_ERR_TIMEOUT) httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing header");
+        return ESP_FAIL;
+    }
+    uint32_t size = anim_image_size(hdr, sizeof(hdr));
+    if (size == 0 || size != req->content_len || size > s_anim.part->size) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid animation");
+        return ESP_FAIL;
+    }
+
+    char *buf = malloc(ANIM_UPLOAD_CHUNK);
+    if (!buf) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    // 正在播放的映射区即将被擦除
+    anim_stop();
+    // 文件头最后写：擦除后分区开头为全 1，不是合法的文件头，上传中途失败或断电都不会留下能播放的残缺动画
+    size_t erase_len = (size + s_anim.part->erase_size - 1) / s_anim.part->erase_size * s_anim.part->erase_size;
+    esp_err_t flash_ret = esp_partition_erase_range(s_anim.part, 0, erase_len);
+    ret = ESP_OK;
+    for (size_t offset = sizeof(hdr); flash_ret == ESP_OK && offset < size; ) {
+        size_t n = MIN(size - offset, ANIM_UPLOAD_CHUNK);
+        ret = httpd_recv_all(req, buf, n);
+        if (ret != ESP_OK) break;
+        flash_ret = esp_partition_write(s_anim.part, offset, buf, n);
+        offset += n;
+    }
+    free(buf);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Animation upload aborted");
+        if (ret != ESP_ERR_TIMEOUT) httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Incomplete animation");
+        return ESP_FAIL;
+    }
+    if (flash_ret == ESP_OK) {
+        flash_ret = esp_partition_write(s_anim.part, 0, hdr, sizeof(hdr));
+    }
+    if (flash_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Write animation failed: %s", esp_err_to_name(flash_ret));
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    boot_cancel();
+    if (anim_play(httpd_query_brightness(req, 100)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Animation does not match canvas");
+        return ESP_FAIL;
     }
+    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
+    return ESP_OK;
 }
 
-// 彻底清屏：同时清除显存和物理LED状态
-void matrix_clear_all(void)
+// 播放分区中已有的动画，可用 ?brightness=N 指定亮度 (默认 100)
+static esp_err_t anim_play_handler(httpd_req_t *req)
 {
-    // 如果屏幕亮着，先灭物理灯
-    if (g_display_enable) {
-        led_strip_clear(led_strip);
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    boot_cancel();
+    if (anim_play(httpd_query_brightness(req, 100)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "No valid animation");
+        return ESP_FAIL;
     }
-    // 同步清空显存，防止开灯瞬间闪烁旧数据
-    memset(s_screen_buffer, 0, sizeof(s_screen_buffer));
+    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
+    return ESP_OK;
 }
 
-uint32_t pos_to_index(uint8_t x, uint8_t y) {
-    uint32_t index=0;
-
-    // TODO: 根据实际走线（如S型/Z型）计算物理index
-
-    return index;
+// 停止播放
+static esp_err_t anim_delete_handler(httpd_req_t *req)
+{
+    anim_stop();
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
+    return ESP_OK;
 }
 
-// 写像素核心函数
-void matrix_set_pixel(uint8_t x, uint8_t y, uint8_t r, uint8_t g, uint8_t b)
+// 画布信息：客户端据此决定整帧大小
+static esp_err_t canvas_get_handler(httpd_req_t *req)
 {
-    if (x >= MATRIX_WIDTH || y >= MATRIX_HEIGHT) return;
-
-    // 1. 计算物理位置
-    uint32_t index;
-    index = pos_to_index(x, y);
+    char resp[96];
+    snprintf(resp, sizeof(resp), "{\"width\":%d,\"height\":%d,\"panels\":%d}",
+             s_canvas_width, s_canvas_height, s_tiling.tiles_x * s_tiling.tiles_y);
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, resp, -1);
+    return ESP_OK;
+}
 
-    // 2. 始终更新显存 (保证后台数据同步)
-    s_screen_buffer[index].r = r;
-    s_screen_buffer[index].g = g;
-    s_screen_buffer[index].b = b;
+// 原始二进制帧：Body 为打包好的像素数据，整帧覆盖，无需JSON解析
+static esp_err_t matrix_raw_post_handler(httpd_req_t *req)
+{
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
 
-    // 3. 若屏幕开启，同步写入硬件
-    if (g_display_enable) {
-        led_strip_set_pixel(led_strip, index, r, g, b);
+    raw_frame_fmt_t fmt = RAW_FMT_RGB888;
+    char content_type[32] = "";
+    httpd_req_get_hdr_value_str(req, "Content-Type", content_type, sizeof(content_type));
+    if (strncmp(content_type, "application/x-rgb565", strlen("application/x-rgb565")) == 0) {
+        fmt = RAW_FMT_RGB565;
+    } else if (strncmp(content_type, "application/x-grb888", strlen("application/x-grb888")) == 0) {
+        fmt = RAW_FMT_GRB888;
+    } else if (strncmp(content_type, "application/x-matrix-delta", strlen("application/x-matrix-delta")) == 0) {
+        fmt = RAW_FMT_DELTA;
     }
-}
-
-// 辅助：按线性索引设置像素 (带亮度处理)
-void set_pixel_by_index(int index, int color_val, int brightness_percent) {
-    int x = index % 8;
-    int y = index / 8;
 
-    uint8_t r = (color_val >> 16) & 0xFF;
-    uint8_t g = (color_val >> 8) & 0xFF;
-    uint8_t b = color_val & 0xFF;
+    size_t frame_len = raw_frame_size(fmt);
+    if (fmt == RAW_FMT_DELTA ? req->content_len > frame_len : req->content_len != frame_len) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Frame size mismatch");
+        return ESP_FAIL;
+    }
+    frame_len = req->content_len;
 
-    if (brightness_percent < 0) brightness_percent = 0;
-    if (brightness_percent > 100) brightness_percent = 100;
+    // 原始帧默认不缩放亮度，可用 ?brightness=N 指定
+    int brightness = httpd_query_brightness(req, 100);
 
-    r = (r * brightness_percent) / 100;
-    g = (g * brightness_percent) / 100;
-    b = (b * brightness_percent) / 100;
+    // 大画布的整帧有几KB，不放在 httpd 任务栈上
+    uint8_t *frame = malloc(frame_len);
+    if (!frame) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    int64_t t0 = esp_timer_get_time();
+    if (httpd_recv_all(req, (char *)frame, frame_len) != ESP_OK) {
+        free(frame);
+        return ESP_FAIL;
+    }
+    perf_hist_record(&s_hist_http_recv, perf_elapsed_us(t0));
+
+    matrix_stop_effects();
+    t0 = esp_timer_get_time();
+    if (fmt == RAW_FMT_DELTA) {
+        frame_decode_result_t res = matrix_load_delta_frame(frame, frame_len, brightness);
+        perf_hist_record(&s_hist_fb_update, perf_elapsed_us(t0));
+        free(frame);
+        if (res == FRAME_DECODE_NEED_KEY) {
+            // 差分帧接不上 (丢帧或乱序)，客户端应改发关键帧
+            httpd_resp_set_status(req, "409 Conflict");
+            httpd_resp_send(req, "Keyframe required", -1);
+            return ESP_FAIL;
+        }
+        if (res != FRAME_DECODE_OK) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid frame");
+            return ESP_FAIL;
+        }
+    } else {
+        matrix_load_raw_frame(fmt, frame, brightness);
+        perf_hist_record(&s_hist_fb_update, perf_elapsed_us(t0));
+        free(frame);
+    }
+    matrix_refresh_and_save();
 
-    // 注意：这里做了x轴翻转处理 (7-x)，视具体硬件摆放调整
-    matrix_set_pixel(7-x, y, r, g, b);
+    httpd_resp_set_status(req, HTTPD_204);
+    httpd_resp_send(req, NULL, 0);
+    return ESP_OK;
 }
 
-/* ================== 绘图与动画 ================== */
-
-void scroll_text(const char *text, int speed_ms, uint8_t r, uint8_t g, uint8_t b)
+// WebSocket 帧格式 (二进制消息)：
+//   [0..3] 序号 uint32 小端
+//   [4]    像素格式 raw_frame_fmt_t
+//   [5]    亮度 0-100
+//   [6..]  像素数据，长度 = raw_frame_size(fmt)，压缩帧长度可变
+// 每帧回一个 5 字节二进制 ACK：[0..3] 序号，[4] 状态 (0=成功)
+#define WS_FRAME_HDR_LEN  6
+#define WS_ACK_OK         0
+#define WS_ACK_BAD_FRAME  1
+#define WS_ACK_NEED_KEY   2     // 差分帧接不上，需要补发关键帧
+
+static esp_err_t matrix_ws_send_ack(httpd_req_t *req, uint32_t seq, uint8_t status)
 {
-    int len = strlen(text);
-    int total_columns = len * 8 + 8;
-
-    for (int offset = 0; offset < total_columns; offset++) {
-        // 帧清空，防止残影
-        matrix_clear_all();
-
-        for (int x = 0; x < 8; x++) {
-            int current_msg_col = offset + x - 8;
-
-            if (current_msg_col >= 0 && current_msg_col < len * 8) {
-                int char_idx = current_msg_col / 8;
-                int col_in_char = current_msg_col % 8;
+    uint8_t ack[5] = { seq & 0xFF, (seq >> 8) & 0xFF, (seq >> 16) & 0xFF, (seq >> 24) & 0xFF, status };
+    httpd_ws_frame_t ack_pkt = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_BINARY,
+        .payload = ack,
+        .len = sizeof(ack),
+    };
+    return httpd_ws_send_frame(req, &ack_pkt);
+}
 
-                int char_code = (int)text[char_idx];
-                if (char_code < 0 || char_code > 127) char_code = '?';
+static esp_err_t matrix_ws_handler(httpd_req_t *req)
+{
+    if (req->method == HTTP_GET) {
+        ESP_LOGI(TAG, "WebSocket client connected");
+        return ESP_OK;
+    }
 
-                uint8_t col_data = font8x8[char_code][col_in_char];
+    httpd_ws_frame_t ws_pkt;
+    memset(&ws_pkt, 0, sizeof(ws_pkt));
 
-                for (int y = 0; y < 8; y++) {
-                    if (col_data & (1 << y)) {
-                        matrix_set_pixel(7-x, y, r, g, b);
-                    }
-                }
-            }
+    // 先取帧长度，再按长度接收
+    esp_err_t ret = httpd_ws_recv_frame(req, &ws_pkt, 0);
+    if (ret != ESP_OK) return ret;
+    // 不收的帧其负载还留在 socket 里，会被当成下一帧的帧头解析：返回错误，由 httpd 关闭这个连接
+    if (ws_pkt.type != HTTPD_WS_TYPE_BINARY || ws_pkt.len < WS_FRAME_HDR_LEN ||
+            ws_pkt.len > WS_FRAME_HDR_LEN + raw_frame_size(RAW_FMT_DELTA)) {
+        ESP_LOGW(TAG, "WebSocket: bad frame type=%d len=%d, closing", ws_pkt.type, (int)ws_pkt.len);
+        return ESP_FAIL;
+    }
+    uint8_t *buf = malloc(ws_pkt.len);
+    if (!buf) return ESP_ERR_NO_MEM;
+    ws_pkt.payload = buf;
+    int64_t t0 = esp_timer_get_time();
+    ret = httpd_ws_recv_frame(req, &ws_pkt, ws_pkt.len);
+    if (ret != ESP_OK) {
+        free(buf);
+        return ret;
+    }
+    perf_hist_record(&s_hist_http_recv, perf_elapsed_us(t0));
+
+    uint32_t seq = buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+    raw_frame_fmt_t fmt = buf[4];
+    int brightness = buf[5];
+
+    if (fmt == RAW_FMT_DELTA) {
+        matrix_stop_effects();
+        t0 = esp_timer_get_time();
+        frame_decode_result_t res = matrix_load_delta_frame(buf + WS_FRAME_HDR_LEN, ws_pkt.len - WS_FRAME_HDR_LEN, brightness);
+        perf_hist_record(&s_hist_fb_update, perf_elapsed_us(t0));
+        free(buf);
+        if (res != FRAME_DECODE_OK) {
+            return matrix_ws_send_ack(req, seq, res == FRAME_DECODE_NEED_KEY ? WS_ACK_NEED_KEY : WS_ACK_BAD_FRAME);
         }
-        matrix_refresh();
-        vTaskDelay(pdMS_TO_TICKS(speed_ms));
+        matrix_refresh_and_save();
+        return matrix_ws_send_ack(req, seq, WS_ACK_OK);
+    }
+    if (fmt > RAW_FMT_GRB888 || ws_pkt.len != WS_FRAME_HDR_LEN + raw_frame_size(fmt)) {
+        free(buf);
+        return matrix_ws_send_ack(req, seq, WS_ACK_BAD_FRAME);
     }
-}
-
-void play_startup_animation(void)
-{
-    float center_x = 3.5;
-    float center_y = 3.5;
-    float max_radius = 6.0;
 
-    // 扩散圆环动画
-    for (float r = 0; r < max_radius; r += 0.5) {
-        matrix_clear_all(); // 帧重置
+    matrix_stop_effects();
+    t0 = esp_timer_get_time();
+    matrix_load_raw_frame(fmt, buf + WS_FRAME_HDR_LEN, brightness);
+    perf_hist_record(&s_hist_fb_update, perf_elapsed_us(t0));
+    matrix_refresh_and_save();
+    free(buf);
 
-        for (int x = 0; x < 8; x++) {
-            for (int y = 0; y < 8; y++) {
-                float dx = x - center_x;
-                float dy = y - center_y;
-                float dist = sqrt(dx*dx + dy*dy);
+    return matrix_ws_send_ack(req, seq, WS_ACK_OK);
+}
 
-                if (dist <= r) {
-                    int brightness = 15;
-                    uint8_t red = (dist < 1.5) ? 100 : 0;
-                    uint8_t green = 255 - (dist * 30);
-                    if (green > 255) green = 0;
-                    uint8_t blue = 200;
+// Prometheus 文本格式约 5KB (每个直方图 15 行)，JSON 更短
+#define STATS_BUF_LEN   6144
 
-                    matrix_set_pixel(x, y, (red * brightness)/100, (green * brightness)/100, (blue * brightness)/100);
-                }
-            }
-        }
-        matrix_refresh();
-        vTaskDelay(pdMS_TO_TICKS(80));
+// 性能统计：默认输出 JSON，?format=prometheus 输出 Prometheus 文本格式；GET /metrics 总是 Prometheus 格式
+static esp_err_t stats_get_handler(httpd_req_t *req)
+{
+    bool prometheus = req->user_ctx != NULL;
+    char query[32];
+    char param[16];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+            httpd_query_key_value(query, "format", param, sizeof(param)) == ESP_OK) {
+        prometheus = strcmp(param, "prometheus") == 0;
     }
 
-    // 闪白光特效
-    for(int i=0; i<64; i++) {
-        int x = i % 8; int y = i / 8;
-        matrix_set_pixel(x, y, 30, 30, 30);
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    char *buf = malloc(STATS_BUF_LEN);
+    if (!buf) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
     }
-    matrix_refresh();
-    vTaskDelay(pdMS_TO_TICKS(100));
-
-    matrix_clear_all();
-    matrix_refresh();
-    vTaskDelay(pdMS_TO_TICKS(500));
+    perf_writer_t w;
+    perf_writer_init(&w, buf, STATS_BUF_LEN, prometheus);
+    perf_write_gauge(&w, "uptime_seconds", "Time since boot", esp_timer_get_time() / 1e6);
+    perf_write_gauge(&w, "fps", "Frames sent to the LED strip per second, over the last second", s_render_fps_x100 / 100.0);
+    perf_write_counter(&w, "frames_presented", "Frames sent to the LED strip", s_render_presented);
+    perf_write_counter(&w, "frames_partial", "Frames of which only the front of the chain was sent", s_render_partial);
+    perf_write_counter(&w, "frames_skipped", "Submitted frames identical to the one on screen", s_render_skipped);
+    perf_write_counter(&w, "frames_dropped", "Submitted frames replaced by a newer one before being shown", s_render_dropped);
+    perf_write_counter(&w, "render_deadline_misses", "Render periods missed because a frame took too long", s_render_missed);
+    perf_write_counter(&w, "state_writes", "Entries written to NVS by the state saver", s_persist.writes);
+    perf_write_counter(&w, "state_writes_skipped", "State entries not written because their content was unchanged", s_persist.skipped);
+    perf_write_gauge(&w, "heap_free_bytes", "Free heap", esp_get_free_heap_size());
+    perf_write_gauge(&w, "heap_min_free_bytes", "Lowest free heap since boot", esp_get_minimum_free_heap_size());
+    perf_write_hist(&w, &s_hist_http_recv);
+    perf_write_hist(&w, &s_hist_json_parse);
+    perf_write_hist(&w, &s_hist_fb_update);
+    perf_write_hist(&w, &s_hist_strip_refresh);
+    size_t len = perf_writer_finish(&w);
+    if (len == 0) {
+        free(buf);
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+    httpd_resp_set_type(req, prometheus ? "text/plain; version=0.0.4" : "application/json");
+    httpd_resp_send(req, buf, len);
+    free(buf);
+    return ESP_OK;
 }
 
-void draw_success_icon(void)
+static httpd_handle_t start_webserver(void)
 {
-    matrix_clear_all(); // 清除之前的文字残留
-
-    uint8_t R = 0, G = 15, B = 0;
-
-    // 绘制外框
-    for(int x=2; x<=5; x++) { matrix_set_pixel(x, 0, R, G, B); matrix_set_pixel(x, 7, R, G, B); }
-    for(int y=2; y<=5; y++) { matrix_set_pixel(0, y, R, G, B); matrix_set_pixel(7, y, R, G, B); }
-    matrix_set_pixel(1, 1, R, G, B); matrix_set_pixel(6, 1, R, G, B);
-    matrix_set_pixel(1, 6, R, G, B); matrix_set_pixel(6, 6, R, G, B);
-
-    // 绘制对勾
-    uint8_t G_tick = 30;
-    matrix_set_pixel(7-2, 4, 0, G_tick, 0);
-    matrix_set_pixel(7-3, 5, 0, G_tick, 0);
-    matrix_set_pixel(7-4, 4, 0, G_tick, 0);
-    matrix_set_pixel(7-5, 3, 0, G_tick, 0);
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.max_open_sockets = 5;
+    config.lru_purge_enable = true;
+    config.max_uri_handlers = 24;
 
-    matrix_refresh();
+    httpd_handle_t server = NULL;
+    if (httpd_start(&server, &config) == ESP_OK) {
+        httpd_uri_t uri_opt = { .uri = "/api/matrix", .method = HTTP_OPTIONS, .handler = matrix_options_handler };
+        httpd_register_uri_handler(server, &uri_opt);
+        httpd_uri_t uri_post = { .uri = "/api/matrix", .method = HTTP_POST, .handler = matrix_post_handler };
+        httpd_register_uri_handler(server, &uri_post);
+        httpd_uri_t uri_raw_opt = { .uri = "/api/matrix/raw", .method = HTTP_OPTIONS, .handler = matrix_options_handler };
+        httpd_register_uri_handler(server, &uri_raw_opt);
+        httpd_uri_t uri_raw_post = { .uri = "/api/matrix/raw", .method = HTTP_POST, .handler = matrix_raw_post_handler };
+        httpd_register_uri_handler(server, &uri_raw_post);
+        httpd_uri_t uri_ws = { .uri = "/ws/matrix", .method = HTTP_GET, .handler = matrix_ws_handler, .is_websocket = true };
+        httpd_register_uri_handler(server, &uri_ws);
+        httpd_uri_t uri_layout_opt = { .uri = "/api/layout", .method = HTTP_OPTIONS, .handler = matrix_options_handler };
+        httpd_register_uri_handler(server, &uri_layout_opt);
+        httpd_uri_t uri_layout = { .uri = "/api/layout", .method = HTTP_POST, .handler = layout_post_handler };
+        httpd_register_uri_handler(server, &uri_layout);
+        httpd_uri_t uri_canvas = { .uri = "/api/canvas", .method = HTTP_GET, .handler = canvas_get_handler };
+        httpd_register_uri_handler(server, &uri_canvas);
+        httpd_uri_t uri_text_opt = { .uri = "/api/text", .method = HTTP_OPTIONS, .handler = matrix_options_handler };
+        httpd_register_uri_handler(server, &uri_text_opt);
+        httpd_uri_t uri_text = { .uri = "/api/text", .method = HTTP_POST, .handler = text_post_handler };
+        httpd_register_uri_handler(server, &uri_text);
+        httpd_uri_t uri_text_del = { .uri = "/api/text", .method = HTTP_DELETE, .handler = text_delete_handler };
+        httpd_register_uri_handler(server, &uri_text_del);
+        httpd_uri_t uri_anim_opt = { .uri = "/api/anim", .method = HTTP_OPTIONS, .handler = matrix_options_handler };
+        httpd_register_uri_handler(server, &uri_anim_opt);
+        httpd_uri_t uri_anim = { .uri = "/api/anim", .method = HTTP_POST, .handler = anim_upload_handler };
+        httpd_register_uri_handler(server, &uri_anim);
+        httpd_uri_t uri_anim_del = { .uri = "/api/anim", .method = HTTP_DELETE, .handler = anim_delete_handler };
+        httpd_register_uri_handler(server, &uri_anim_del);
+        httpd_uri_t uri_anim_play = { .uri = "/api/anim/play", .method = HTTP_POST, .handler = anim_play_handler };
+        httpd_register_uri_handler(server, &uri_anim_play);
+        httpd_uri_t uri_stats = { .uri = "/api/stats", .method = HTTP_GET, .handler = stats_get_handler };
+        httpd_register_uri_handler(server, &uri_stats);
+        httpd_uri_t uri_metrics = { .uri = "/metrics", .method = HTTP_GET, .handler = stats_get_handler, .user_ctx = "prometheus" };
+        httpd_register_uri_handler(server, &uri_metrics);
+        return server;
+    }
+    return NULL;
 }
 
-void draw_failure_icon(void)
-{
-    matrix_clear_all();
+/* ================== UDP 实时像素协议 ================== */
 
-    uint8_t R = 20, G = 0, B = 0;
+// E1.31 起始宇宙号
+#define E131_UNIVERSE_START     1
+// 超过该时间没收到包，认为发送端已重启，序号重新同步
+#define UDP_SEQ_RESYNC_MS       1000
 
-    // 外框
-    for(int x=2; x<=5; x++) { matrix_set_pixel(x, 0, R, G, B); matrix_set_pixel(x, 7, R, G, B); }
-    for(int y=2; y<=5; y++) { matrix_set_pixel(0, y, R, G, B); matrix_set_pixel(7, y, R, G, B); }
-    matrix_set_pixel(1, 1, R, G, B); matrix_set_pixel(6, 1, R, G, B);
-    matrix_set_pixel(1, 6, R, G, B); matrix_set_pixel(6, 6, R, G, B);
+static uint8_t s_udp_buf[1500];
 
-    // 叉号
-    for (int i = 2; i <= 5; i++) {
-        matrix_set_pixel(i, i, R, G, B);
-        matrix_set_pixel(i, 7-i, R, G, B);
-    }
+static uint8_t s_ddp_last_seq;
+static TickType_t s_ddp_last_tick;
 
-    matrix_refresh();
-}
+// 整个画布占用的宇宙数 (每宇宙 170 像素)，按宇宙记录序号
+static int s_e131_universe_count;
+static uint8_t *s_e131_last_seq;
+static TickType_t *s_e131_last_tick;
+static uint16_t s_e131_sync_addr;     // 非0：数据已写入，等待该地址的同步包再刷新
+static uint32_t s_udp_stale_count;
 
-/* ================== 硬件初始化 ================== */
+// 当前帧已有数据写入 (还没刷新)
+static bool s_udp_frame_open;
 
-static void configure_led(void)
+// 一帧的第一个数据包：与 HTTP 接口一样先结束开机画面、停掉滚动和动画，否则它们会与 UDP 帧交替显示
+static void udp_frame_begin(void)
 {
-    led_strip_config_t strip_config = {
-        .strip_gpio_num = LED_STRIP_GPIO,
-        .max_leds = 64,
-        .led_model = LED_MODEL_WS2812,
-        .flags.invert_out = false,
-    };
-    led_strip_rmt_config_t rmt_config = {
-        .resolution_hz = 10 * 1000 * 1000,
-        .flags.with_dma = false,
-    };
-    ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip));
+    if (s_udp_frame_open) return;
+    s_udp_frame_open = true;
+    matrix_stop_effects();
+}
 
-    matrix_clear_all();
-    matrix_refresh();
+static void udp_frame_end(void)
+{
+    s_udp_frame_open = false;
+    matrix_refresh_and_save();
 }
 
-/* ================== 按键监控任务 ================== */
+static bool udp_seq_expired(TickType_t last_tick)
+{
+    return (xTaskGetTickCount() - last_tick) > pdMS_TO_TICKS(UDP_SEQ_RESYNC_MS);
+}
 
-void turn_on_and_off_led(void *pvParameters)
+static void udp_handle_ddp(const uint8_t *buf, size_t len)
 {
-    gpio_config_t io_conf = {};
-    io_conf.intr_type = GPIO_INTR_DISABLE;
-    io_conf.pin_bit_mask = (1ULL << GPIO_INPUT_PIN);
-    io_conf.mode = GPIO_MODE_INPUT;
-    // 启用内部上拉，低电平触发
-    io_conf.pull_up_en = 1;
-    io_conf.pull_down_en = 0;
-    gpio_config(&io_conf);
+    ddp_packet_t pkt;
+    if (!ddp_parse(buf, len, &pkt)) return;
+
+    // 序号为0表示发送端不使用序号
+    if (pkt.seq) {
+        if (s_ddp_last_seq && !udp_seq_expired(s_ddp_last_tick) && !ddp_seq_is_newer(s_ddp_last_seq, pkt.seq)) {
+            s_udp_stale_count++;
+            return;
+        }
+        s_ddp_last_seq = pkt.seq;
+    }
+    s_ddp_last_tick = xTaskGetTickCount();
 
-    ESP_LOGI(TAG, "Button Monitor Task Started");
+    udp_frame_begin();
+    matrix_write_strip_bytes(pkt.offset, pkt.data, pkt.len);
+    if (pkt.push) {
+        udp_frame_end();
+    }
+}
 
-    while (1) {
-        if (gpio_get_level(GPIO_INPUT_PIN) == 0) {
-
-            // 简单消抖
-            vTaskDelay(pdMS_TO_TICKS(50));
-            if (gpio_get_level(GPIO_INPUT_PIN) == 0) {
-
-                // 翻转显示状态
-                g_display_enable = !g_display_enable;
-
-                if (g_display_enable) {
-                    // 开灯：将Shadow Buffer的数据刷回灯珠
-                    ESP_LOGI(TAG, "Display ON: Restoring buffer...");
-                    for (int i = 0; i < 64; i++) {
-                        led_strip_set_pixel(led_strip, i,
-                                            s_screen_buffer[i].r,
-                                            s_screen_buffer[i].g,
-                                            s_screen_buffer[i].b);
-                    }
-                    led_strip_refresh(led_strip);
-                }
-                else {
-                    // 关灯：仅清空物理灯珠，不清除Buffer
-                    ESP_LOGI(TAG, "Display OFF: Saving power...");
-                    led_strip_clear(led_strip);
-                    led_strip_refresh(led_strip);
-                }
+static void udp_handle_e131(const uint8_t *buf, size_t len)
+{
+    e131_packet_t pkt;
+    e131_pkt_type_t type = e131_parse(buf, len, &pkt);
 
-                // 等待释放
-                while (gpio_get_level(GPIO_INPUT_PIN) == 0) {
-                    vTaskDelay(pdMS_TO_TICKS(50));
-                }
-            }
+    if (type == E131_PKT_SYNC) {
+        if (s_e131_sync_addr && pkt.universe == s_e131_sync_addr) {
+            s_e131_sync_addr = 0;
+            udp_frame_end();
         }
-        vTaskDelay(pdMS_TO_TICKS(50));
+        return;
     }
-}
-
-/* ================== HTTP Server ================== */
+    if (type != E131_PKT_DATA || pkt.preview || pkt.terminated) return;
+    if (pkt.universe < E131_UNIVERSE_START || pkt.universe >= E131_UNIVERSE_START + s_e131_universe_count) return;
 
-static esp_err_t matrix_options_handler(httpd_req_t *req)
-{
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Methods", "POST, OPTIONS");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Headers", "Content-Type");
-    httpd_resp_set_status(req, "200 OK");
-    httpd_resp_send(req, NULL, 0);
-    return ESP_OK;
+    int slot = pkt.universe - E131_UNIVERSE_START;
+    if (s_e131_last_tick[slot] && !udp_seq_expired(s_e131_last_tick[slot]) &&
+            !e131_seq_is_newer(s_e131_last_seq[slot], pkt.seq)) {
+        s_udp_stale_count++;
+        return;
+    }
+    s_e131_last_seq[slot] = pkt.seq;
+    s_e131_last_tick[slot] = xTaskGetTickCount();
+
+    udp_frame_begin();
+    matrix_write_strip_bytes(slot * E131_CHANNELS_PER_UNIVERSE, pkt.data, MIN(pkt.len, E131_CHANNELS_PER_UNIVERSE));
+
+    if (pkt.sync_addr) {
+        // 发送端要求同步输出：等同步包
+        s_e131_sync_addr = pkt.sync_addr;
+    } else if (slot == s_e131_universe_count - 1) {
+        // 无同步：最后一个宇宙到达即视为整帧完成
+        udp_frame_end();
+    }
 }
 
-static esp_err_t matrix_post_handler(httpd_req_t *req)
+static int udp_open_socket(uint16_t port)
 {
-    char content[1024];
-    size_t recv_size = MIN(req->content_len, sizeof(content));
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) return -1;
 
-    int ret = httpd_req_recv(req, content, recv_size);
-    if (ret <= 0) {
-        if (ret == HTTPD_SOCK_ERR_TIMEOUT) httpd_resp_send_408(req);
-        return ESP_FAIL;
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        ESP_LOGE(TAG, "UDP bind port %d failed: errno %d", port, errno);
+        close(sock);
+        return -1;
     }
-    content[ret] = '\0';
-
-    cJSON *root = cJSON_Parse(content);
-    if (root) {
-        int brightness = 20;
-        cJSON *bri_item = cJSON_GetObjectItem(root, "brightness");
-        if (bri_item) brightness = bri_item->valueint;
-
-        cJSON *data_array = cJSON_GetObjectItem(root, "data");
-        if (cJSON_IsArray(data_array)) {
+    return sock;
+}
 
-            // 收到新画面前先清屏，避免叠加
-            matrix_clear_all();
+void udp_pixel_task(void *pvParameters)
+{
+    s_e131_universe_count = (s_canvas_pixels * 3 + E131_CHANNELS_PER_UNIVERSE - 1) / E131_CHANNELS_PER_UNIVERSE;
+    s_e131_last_seq = calloc(s_e131_universe_count, sizeof(uint8_t));
+    s_e131_last_tick = calloc(s_e131_universe_count, sizeof(TickType_t));
+    if (!s_e131_last_seq || !s_e131_last_tick) {
+        ESP_LOGE(TAG, "UDP: no memory for %d universes", s_e131_universe_count);
+        vTaskDelete(NULL);
+        return;
+    }
 
-            int array_size = cJSON_GetArraySize(data_array);
-            for (int i = 0; i < array_size && i < 64; i++) {
-                cJSON *item = cJSON_GetArrayItem(data_array, i);
-                if (item) set_pixel_by_index(i, item->valueint, brightness);
-            }
-            matrix_refresh();
+    int ddp_sock = udp_open_socket(DDP_PORT);
+    int e131_sock = udp_open_socket(E131_PORT);
+
+    // sACN 默认使用组播 239.255.<宇宙号高字节>.<宇宙号低字节>
+    for (int u = E131_UNIVERSE_START; e131_sock >= 0 && u < E131_UNIVERSE_START + s_e131_universe_count; u++) {
+        struct ip_mreq mreq = {
+            .imr_multiaddr.s_addr = htonl(0xEFFF0000 | u),
+            .imr_interface.s_addr = htonl(INADDR_ANY),
+        };
+        // lwIP 的组播组数量有限，之后的宇宙只能通过单播接收
+        if (setsockopt(e131_sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+            ESP_LOGW(TAG, "E1.31: multicast joined up to universe %d, use unicast beyond", u - 1);
+            break;
         }
-        cJSON_Delete(root);
     }
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, "{\"status\":\"ok\"}", -1);
-    return ESP_OK;
-}
 
-static httpd_handle_t start_webserver(void)
-{
-    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
-    config.max_open_sockets = 5;
-    config.lru_purge_enable = true;
+    ESP_LOGI(TAG, "UDP pixel receiver started (DDP:%d, E1.31:%d universe %d-%d)", DDP_PORT, E131_PORT,
+             E131_UNIVERSE_START, E131_UNIVERSE_START + s_e131_universe_count - 1);
 
-    httpd_handle_t server = NULL;
-    if (httpd_start(&server, &config) == ESP_OK) {
-        httpd_uri_t uri_opt = { .uri = "/api/matrix", .method = HTTP_OPTIONS, .handler = matrix_options_handler };
-        httpd_register_uri_handler(server, &uri_opt);
-        httpd_uri_t uri_post = { .uri = "/api/matrix", .method = HTTP_POST, .handler = matrix_post_handler };
-        httpd_register_uri_handler(server, &uri_post);
-        return server;
+    while (1) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        if (ddp_sock >= 0) FD_SET(ddp_sock, &fds);
+        if (e131_sock >= 0) FD_SET(e131_sock, &fds);
+
+        if (select(MAX(ddp_sock, e131_sock) + 1, &fds, NULL, NULL, NULL) <= 0) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+
+        if (ddp_sock >= 0 && FD_ISSET(ddp_sock, &fds)) {
+            int len = recv(ddp_sock, s_udp_buf, sizeof(s_udp_buf), 0);
+            if (len > 0) udp_handle_ddp(s_udp_buf, len);
+        }
+        if (e131_sock >= 0 && FD_ISSET(e131_sock, &fds)) {
+            int len = recv(e131_sock, s_udp_buf, sizeof(s_udp_buf), 0);
+            if (len > 0) udp_handle_e131(s_udp_buf, len);
+        }
     }
-    return NULL;
 }
 
 /* ================== WiFi Logic ================== */
@@ -401,8 +2318,14 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         sprintf(s_ip_addr_str, IPSTR, IP2STR(&event->ip_info.ip));
         ESP_LOGI(TAG, "Got IP: %s", s_ip_addr_str);
+        boot_mark("got IP");
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
-        start_webserver();
+
+        // UDP 接收任务只需启动一次 (重连后 socket 绑定在 INADDR_ANY 上仍然有效)
+        static TaskHandle_t s_udp_task = NULL;
+        if (s_udp_task == NULL) {
+            xTaskCreate(udp_pixel_task, "udp_pixel", 4096, NULL, 5, &s_udp_task);
+        }
     }
 }
 
@@ -433,87 +2356,120 @@ void wifi_init_sta(void)
 
 /* ================== Main ================== */
 
-void app_main(void)
+// 开机画面：与 WiFi 连接同时进行，客户端的第一帧到达后停止绘制 (见 boot_cancel)
+static void boot_task(void *pvParameters)
 {
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ret = nvs_flash_init();
-    }
-    ESP_ERROR_CHECK(ret);
-
-    // 1. 硬件初始化 (Buffer置0)
-    configure_led();
-
-    // 2. 启动按键扫描任务
-    xTaskCreate(turn_on_and_off_led, "btn_task", 2048, NULL, 5, NULL);
-
-    // 3. 播放开机动画
-    ESP_LOGI(TAG, "Startup Animation...");
-    play_startup_animation();
-
-    scroll_text("Center4Maker by Mao", 60, 15, 15, 15);
+    int64_t wifi_start = esp_timer_get_time();
 
-    // 4. WiFi连接
-    ESP_LOGI(TAG, "Connecting WiFi...");
-    wifi_init_sta();
+    // 1. 开机动画 (可在 menuconfig 中关闭)
+#if CONFIG_MATRIX_BOOT_INTRO
+    if (!boot_interrupted()) {
+        play_startup_animation();
+    }
+    if (!boot_interrupted()) {
+        scroll_text("Center4Maker by Mao", 60, 15, 15, 15);
+    }
+    boot_mark("intro done");
+#endif
 
-    // 5. 等待连接 (带超时动画)
+    // 2. 等待连接 (带超时动画)，从 WiFi 启动时算起
     int frame = 0;
     bool is_connected = false;
-    int max_frames = WIFI_TIMEOUT_MS / 50;
 
-    while (frame < max_frames) {
+    for (;;) {
+        // 开机动画期间可能已经连上，先查连接状态再判断超时
         EventBits_t bits = xEventGroupGetBits(s_wifi_event_group);
         if (bits & WIFI_CONNECTED_BIT) {
             is_connected = true;
             break;
         }
+        if (esp_timer_get_time() - wifi_start >= WIFI_TIMEOUT_MS * 1000LL) break;
 
         // 连接过程中的呼吸灯效果
-        matrix_clear_all();
-        int brightness = (frame % 40);
-        if (brightness > 20) brightness = 40 - brightness;
+        if (!boot_interrupted()) {
+            matrix_clear_all();
+            int brightness = (frame % 40);
+            if (brightness > 20) brightness = 40 - brightness;
 
-        // 中心黄色呼吸
-        matrix_set_pixel(3, 3, brightness, brightness, 0);
-        matrix_set_pixel(3, 4, brightness, brightness, 0);
-        matrix_set_pixel(4, 3, brightness, brightness, 0);
-        matrix_set_pixel(4, 4, brightness, brightness, 0);
+            // 中心黄色呼吸
+            int cx = s_canvas_width / 2 - 1, cy = s_canvas_height / 2 - 1;
+            matrix_set_pixel(cx, cy, brightness, brightness, 0);
+            matrix_set_pixel(cx, cy + 1, brightness, brightness, 0);
+            matrix_set_pixel(cx + 1, cy, brightness, brightness, 0);
+            matrix_set_pixel(cx + 1, cy + 1, brightness, brightness, 0);
 
-        matrix_refresh();
+            matrix_refresh();
+        }
         vTaskDelay(pdMS_TO_TICKS(50));
         frame++;
     }
 
-    // 6. 结果判定
+    // 3. 结果判定
     if (is_connected) {
-        ESP_LOGI(TAG, "WiFi Connected!");
-
-        // 绿屏提示
-        matrix_clear_all();
-        for(int i=0; i<64; i++) {
-            int x=i%8, y=i/8;
-            matrix_set_pixel(x,y, 0, 10, 0);
+        if (!boot_interrupted()) {
+            // 绿屏提示
+            matrix_clear_all();
+            for (uint32_t i = 0; i < s_canvas_pixels; i++) {
+                matrix_set_strip_pixel(i, 0, 10, 0);
+            }
+            matrix_refresh();
+            vTaskDelay(pdMS_TO_TICKS(700));
         }
-        matrix_refresh();
-        vTaskDelay(pdMS_TO_TICKS(700));
 
         // 滚动IP地址
-        scroll_text(s_ip_addr_str, 60, 0, 15, 15);
+        if (!boot_interrupted()) {
+            scroll_text(s_ip_addr_str, 60, 0, 15, 15);
+        }
 
         // 显示常驻对勾，系统就绪
-        ESP_LOGI(TAG, "System Ready.");
-        draw_success_icon();
-
-        return;
+        if (!boot_interrupted()) {
+            draw_success_icon();
+        }
+        boot_mark("boot visuals done");
     } else {
         ESP_LOGE(TAG, "WiFi Connection Timeout!");
 
-        scroll_text("TIMEOUT", 100, 20, 0, 0);
-        draw_failure_icon();
+        if (!boot_interrupted()) {
+            scroll_text("TIMEOUT", 100, 20, 0, 0);
+            draw_failure_icon();
+        }
 
         vTaskDelay(5000/portTICK_PERIOD_MS);
+        // 按键刚改过的状态还没到保存时间，重启前写入
+        persist_flush_now();
         esp_restart();
     }
+
+    s_boot.task = NULL;
+    vTaskDelete(NULL);
+}
+
+void app_main(void)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+    s_boot.lock = xSemaphoreCreateRecursiveMutex();
+
+    // 1. 硬件初始化 (恢复上次保存的画面，没有时 Buffer置0)
+    configure_led();
+    // 恢复了保存的画面时，开机过程中不再覆盖它
+    atomic_store(&s_boot.cancelled, s_frame_restored);
+    boot_mark(s_frame_restored ? "LED ready, saved frame restored" : "LED ready");
+
+    // 2. 按键中断与事件处理任务
+    button_init();
+
+    // 3. WiFi 连接和 HTTP 服务立即启动，不等开机画面
+    ESP_LOGI(TAG, "Connecting WiFi...");
+    wifi_init_sta();
+    boot_mark("WiFi started");
+    start_webserver();
+    boot_mark("HTTP server ready");
+
+    // 4. 开机画面在单独的任务中播放
+    xTaskCreate(boot_task, "boot", 4096, NULL, 1, &s_boot.task);
 }
@@ -0,0 +1,81 @@
+/* 压缩帧格式 (XOR 差分 + 游程编码)，格式说明见 frame_codec.h */
+#include <string.h>
+#include "frame_codec.h"
+
+// 只检查结构：操作不越界、数据不截断、像素数正好覆盖整帧
+static bool frame_validate(const uint8_t *p, const uint8_t *end, uint32_t pixels)
+{
+    uint32_t covered = 0;
+    while (p < end) {
+        uint8_t op = *p++;
+        uint32_t n;
+        size_t data_len;
+        if (op & FRAME_CODEC_OP_SKIP) {
+            n = (op & 0x7F) + 1;
+            data_len = 0;
+        } else if (op & FRAME_CODEC_OP_REPEAT) {
+            n = (op & 0x3F) + 1;
+            data_len = 3;
+        } else {
+            n = op + 1;
+            data_len = n * 3;
+        }
+        if ((size_t)(end - p) < data_len || pixels - covered < n) return false;
+        p += data_len;
+        covered += n;
+    }
+    return covered == pixels;
+}
+
+static inline void frame_xor_pixel(uint8_t *dst, const uint8_t *x)
+{
+    dst[0] ^= x[0];
+    dst[1] ^= x[1];
+    dst[2] ^= x[2];
+}
+
+frame_decode_result_t frame_decode(frame_decoder_t *dec, const uint8_t *buf, size_t len,
+                                   frame_decode_pixel_cb_t cb, void *ctx)
+{
+    if (len < FRAME_CODEC_HDR_LEN) return FRAME_DECODE_BAD_FRAME;
+    bool key = buf[0] & FRAME_CODEC_FLAG_KEY;
+    uint8_t id = buf[1];
+    uint16_t pixels = buf[2] | (buf[3] << 8);
+    const uint8_t *p = buf + FRAME_CODEC_HDR_LEN;
+    const uint8_t *end = buf + len;
+
+    if (pixels != dec->pixels || !frame_validate(p, end, pixels)) return FRAME_DECODE_BAD_FRAME;
+    if (!key && (!dec->valid || id != (uint8_t)(dec->last_id + 1))) return FRAME_DECODE_NEED_KEY;
+
+    if (key) {
+        memset(dec->ref, 0, pixels * 3);
+    }
+    uint32_t index = 0;
+    while (p < end) {
+        uint8_t op = *p++;
+        if (op & FRAME_CODEC_OP_SKIP) {
+            uint32_t n = (op & 0x7F) + 1;
+            // 关键帧中跳过的像素为黑色，同样要写入
+            for (uint32_t i = 0; key && i < n; i++) {
+                if (cb) cb(index + i, dec->ref + (index + i) * 3, ctx);
+            }
+            index += n;
+        } else if (op & FRAME_CODEC_OP_REPEAT) {
+            uint32_t n = (op & 0x3F) + 1;
+            for (uint32_t i = 0; i < n; i++, index++) {
+                frame_xor_pixel(dec->ref + index * 3, p);
+                if (cb) cb(index, dec->ref + index * 3, ctx);
+            }
+            p += 3;
+        } else {
+            uint32_t n = op + 1;
+            for (uint32_t i = 0; i < n; i++, index++, p += 3) {
+                frame_xor_pixel(dec->ref + index * 3, p);
+                if (cb) cb(index, dec->ref + index * 3, ctx);
+            }
+        }
+    }
+    dec->last_id = id;
+    dec->valid = true;
+    return FRAME_DECODE_OK;
+}
@@ -0,0 +1,58 @@
+/* 压缩帧格式 (XOR 差分 + 游程编码)
+ * 纯数据解析，不依赖 ESP-IDF；解码结果通过回调逐像素交给调用方写入显存
+ *
+ * 帧 = 4 字节头 + 操作序列：
+ *   [0]    标志：bit0 = 关键帧
+ *   [1]    帧号，每帧加1 (模256)；差分帧只能接在帧号为 (本帧号-1) 的帧之后
+ *   [2..3] 像素数 (uint16 小端)，必须等于画布像素数 (所以画布最多 FRAME_CODEC_MAX_PIXELS 像素)
+ * 像素按画布从左到右、从上到下排列，每个像素的值 = 本帧 RGB888 XOR 参考帧 RGB888
+ * (关键帧的参考帧为全黑，即直接给出像素值)。操作字节 op：
+ *   0x00-0x3F  字面量：后跟 (op+1) 个像素，每个 3 字节
+ *   0x40-0x7F  重复：后跟 1 个像素，作用于 (op-0x40+1) 个像素
+ *   0x80-0xFF  跳过：(op-0x80+1) 个像素不变 (XOR 值为 0)
+ * 所有操作覆盖的像素数之和必须正好等于像素数
+ */
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FRAME_CODEC_HDR_LEN     4
+#define FRAME_CODEC_FLAG_KEY    0x01
+
+#define FRAME_CODEC_OP_LITERAL  0x00
+#define FRAME_CODEC_OP_REPEAT   0x40
+#define FRAME_CODEC_OP_SKIP     0x80
+#define FRAME_CODEC_RUN_MAX     64      // 字面量/重复一次最多覆盖的像素
+#define FRAME_CODEC_SKIP_MAX    128
+#define FRAME_CODEC_MAX_PIXELS  0xFFFF  // 帧头像素数字段能表示的最大值
+
+// 最坏情况 (全部为字面量) 的帧长度
+#define FRAME_CODEC_MAX_LEN(pixels) \
+    (FRAME_CODEC_HDR_LEN + (pixels) * 3 + ((pixels) + FRAME_CODEC_RUN_MAX - 1) / FRAME_CODEC_RUN_MAX)
+
+typedef struct {
+    uint8_t *ref;           // 参考帧 RGB888 (pixels * 3 字节，调用方分配)，解码时原地更新
+    uint32_t pixels;
+    uint8_t last_id;
+    bool valid;             // ref 是否是帧 last_id 的内容
+} frame_decoder_t;
+
+typedef enum {
+    FRAME_DECODE_OK,
+    FRAME_DECODE_BAD_FRAME,     // 格式错误，参考帧不变
+    FRAME_DECODE_NEED_KEY,      // 差分帧与参考帧不连续，需要发送端补发关键帧
+} frame_decode_result_t;
+
+// 每个写入的像素调用一次，rgb 指向解码后的 R,G,B
+typedef void (*frame_decode_pixel_cb_t)(uint32_t index, const uint8_t *rgb, void *ctx);
+
+/* 解码一帧：先完整校验，再更新参考帧，并对值可能变化的像素调用 cb
+ * (关键帧对所有像素调用，差分帧跳过的像素不调用)
+ */
+frame_decode_result_t frame_decode(frame_decoder_t *dec, const uint8_t *buf, size_t len,
+                                   frame_decode_pixel_cb_t cb, void *ctx);
+
+#endif // FRAME_CODEC_H
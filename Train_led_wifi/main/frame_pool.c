@@ -0,0 +1,54 @@
+/* 无锁帧交换，说明见 frame_pool.h */
+#include "frame_pool.h"
+
+void frame_pool_init(frame_pool_t *pool, int count)
+{
+    pool->count = count < FRAME_POOL_MAX_SLOTS ? count : FRAME_POOL_MAX_SLOTS;
+    for (int i = 0; i < FRAME_POOL_MAX_SLOTS; i++) {
+        atomic_init(&pool->refs[i], 0);
+    }
+    atomic_init(&pool->latest, -1);
+    atomic_init(&pool->seq, 0);
+}
+
+int frame_pool_acquire(frame_pool_t *pool)
+{
+    // 读取方加引用后发现不是最新帧会立即撤销，空闲槽可能短暂显示为占用，多扫几遍
+    for (int pass = 0; pass < 4; pass++) {
+        for (int i = 0; i < pool->count; i++) {
+            int expected = 0;
+            if (atomic_load_explicit(&pool->refs[i], memory_order_relaxed) == 0 &&
+                atomic_compare_exchange_strong(&pool->refs[i], &expected, 1)) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+void frame_pool_publish(frame_pool_t *pool, int slot)
+{
+    // 写入方的引用转交给 latest；交换自带的内存屏障保证读取方看到完整的帧内容
+    int old = atomic_exchange(&pool->latest, slot);
+    atomic_fetch_add(&pool->seq, 1);
+    if (old >= 0) {
+        frame_pool_release(pool, old);
+    }
+}
+
+int frame_pool_get_latest(frame_pool_t *pool)
+{
+    while (1) {
+        int slot = atomic_load(&pool->latest);
+        if (slot < 0) return -1;
+        atomic_fetch_add(&pool->refs[slot], 1);
+        // 加引用之前它可能已被替换并回收：此时撤销，重新读取
+        if (atomic_load(&pool->latest) == slot) return slot;
+        frame_pool_release(pool, slot);
+    }
+}
+
+void frame_pool_release(frame_pool_t *pool, int slot)
+{
+    atomic_fetch_sub(&pool->refs[slot], 1);
+}
@@ -0,0 +1,44 @@
+/* 无锁帧交换：多个写入方各自在私有的后台帧上绘图，画完后整帧发布，读取方只会拿到已完整提交的帧
+ * 只管理帧槽的编号和引用计数，帧内存由调用方按槽数分配；纯计算，不依赖 ESP-IDF
+ *
+ * 每个槽有一个引用计数，0 表示空闲：
+ *   写入方 frame_pool_acquire 独占一个空闲槽，写完后 frame_pool_publish 用原子交换把它设为最新帧，
+ *   被替换的旧帧去掉发布时持有的引用 (没有其他引用时回到空闲)。
+ *   读取方 frame_pool_get_latest 对最新帧加一个引用，用完 frame_pool_release。加引用后再确认它仍是最新帧，
+ *   否则撤销重试，因此拿到的槽在释放前不会被重新分配和改写。
+ * 没有互斥量，读写双方都不会等待对方；最新帧被下一帧替换前没有被读取时直接丢弃 (latest wins)。
+ * 槽数至少为 写入方数 + 同时持有的读取引用数 + 1 (最新帧)，分配才不会失败。
+ *
+ * ESP32-C3 没有原子指令扩展，交换和比较交换由 libatomic 的短临界区实现，只在每帧提交和读取时各用几次。
+ */
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define FRAME_POOL_MAX_SLOTS    16
+
+typedef struct {
+    int count;
+    _Atomic int refs[FRAME_POOL_MAX_SLOTS];
+    _Atomic int latest;                 // 最新发布的槽，-1 表示还没有发布过
+    _Atomic uint32_t seq;               // 发布次数，读取方据此判断有没有新帧
+} frame_pool_t;
+
+void frame_pool_init(frame_pool_t *pool, int count);
+// 写入方：取一个空闲槽独占写入，没有空闲槽时返回 -1
+int frame_pool_acquire(frame_pool_t *pool);
+// 写入方：发布写完的槽，此后不能再写它
+void frame_pool_publish(frame_pool_t *pool, int slot);
+// 读取方：对最新帧加引用并返回槽号，还没有发布过时返回 -1
+int frame_pool_get_latest(frame_pool_t *pool);
+// 去掉一个引用 (读取方用完，或写入方放弃未发布的槽)
+void frame_pool_release(frame_pool_t *pool, int slot);
+
+static inline uint32_t frame_pool_seq(frame_pool_t *pool)
+{
+    return atomic_load(&pool->seq);
+}
+
+#endif // FRAME_POOL_H
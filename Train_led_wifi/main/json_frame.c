@@ -0,0 +1,413 @@
+/* JSON 帧流式解析，说明见 json_frame.h */
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "json_frame.h"
+
+enum {
+    ST_START,           // 输入的第一个字节：可能是 BOM
+    ST_BOM,
+    ST_VALUE,           // 期待一个值
+    ST_ARRAY_FIRST,     // '[' 之后：值或 ']'
+    ST_OBJECT_FIRST,    // '{' 之后：键名或 '}'
+    ST_KEY,             // 对象中 ',' 之后：键名
+    ST_COLON,
+    ST_AFTER_VALUE,     // ',' 或容器结束
+    ST_STRING,
+    ST_ESCAPE,
+    ST_UNICODE,
+    ST_PAIR,            // 代理对第一个码元之后：第二个码元的 \u
+    ST_NUMBER,
+    ST_LITERAL,
+    ST_DONE,
+    ST_ERROR,
+};
+
+enum {
+    ROLE_NONE,
+    ROLE_KEY,           // 对象的键名
+    ROLE_BRIGHTNESS,    // 根对象 brightness 字段的值
+    ROLE_DATA,          // 根对象 data 字段的值
+    ROLE_PIXEL,         // data 数组的元素
+};
+
+void json_frame_init(json_frame_parser_t *p, uint32_t max_pixels, int default_brightness,
+                     json_frame_pixel_cb_t cb, void *ctx)
+{
+    memset(p, 0, sizeof(*p));
+    p->max_pixels = max_pixels;
+    p->cb = cb;
+    p->ctx = ctx;
+    p->brightness = default_brightness;
+    p->state = ST_START;
+}
+
+// 与 cJSON 相同：0x01-0x20 都当作空白
+static inline bool is_space(unsigned char c)
+{
+    return c != 0 && c <= ' ';
+}
+
+static inline bool is_number_char(unsigned char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == 'e' || c == 'E' || c == '.';
+}
+
+static inline int hex_digit(unsigned char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 把一个值交给它的用途；不改变解析状态
+static inline void deliver(json_frame_parser_t *p, int value)
+{
+    if (p->role == ROLE_PIXEL) {
+        if (p->pixels < p->max_pixels && p->cb) p->cb(p->pixels, value, p->ctx);
+        p->pixels++;
+    } else if (p->role == ROLE_BRIGHTNESS) {
+        p->brightness = value;
+        p->has_brightness = true;
+        p->brightness_after_data = p->has_data;
+    }
+}
+
+static inline void value_done(json_frame_parser_t *p, int value)
+{
+    deliver(p, value);
+    p->role = ROLE_NONE;
+    p->state = p->depth ? ST_AFTER_VALUE : ST_DONE;
+}
+
+// 数字转成 cJSON 的 valueint；prefix 为 false 时整个字符串都必须是数字的一部分
+static bool number_value(const char *s, size_t len, bool prefix, int *out)
+{
+    // 常见情况：不超过 9 位的整数，直接累加
+    const char *d = s + (s[0] == '-');
+    size_t digits = len - (d - s);
+    if (digits >= 1 && digits <= 9) {
+        int v = 0;
+        size_t i;
+        for (i = 0; i < digits && d[i] >= '0' && d[i] <= '9'; i++) {
+            v = v * 10 + (d[i] - '0');
+        }
+        if (i == digits) {
+            *out = s[0] == '-' ? -v : v;
+            return true;
+        }
+    }
+
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || (!prefix && end != s + len)) return false;
+    *out = v >= INT_MAX ? INT_MAX : v <= (double)INT_MIN ? INT_MIN : (int)v;
+    return true;
+}
+
+// cJSON_GetObjectItem 不区分大小写
+static bool key_equals(const char *key, const char *name)
+{
+    for (; *name; key++, name++) {
+        if (tolower((unsigned char)*key) != *name) return false;
+    }
+    return *key == '\0';
+}
+
+static void key_put(json_frame_parser_t *p, unsigned char c)
+{
+    if (!p->key_wanted || p->key_ended) return;
+    if (c == '\0') {
+        p->key_ended = true;
+    } else if (p->key_len < JSON_FRAME_KEY_MAX - 1) {
+        p->key[p->key_len++] = c;
+    } else {
+        p->key_overflow = true;
+    }
+}
+
+static void string_done(json_frame_parser_t *p)
+{
+    if (p->role != ROLE_KEY) {
+        value_done(p, 0);
+        return;
+    }
+    p->role = ROLE_NONE;
+    if (p->key_wanted && !p->key_overflow) {
+        p->key[p->key_len] = '\0';
+        // 重复的键只取第一个，与 cJSON_GetObjectItem 相同
+        if (!p->brightness_seen && key_equals(p->key, "brightness")) {
+            p->brightness_seen = true;
+            p->role = ROLE_BRIGHTNESS;
+        } else if (!p->data_seen && key_equals(p->key, "data")) {
+            p->data_seen = true;
+            p->role = ROLE_DATA;
+        }
+    }
+    p->state = ST_COLON;
+}
+
+static inline bool top_is_object(const json_frame_parser_t *p)
+{
+    uint16_t i = p->depth - 1;
+    return (p->stack[i / 8] >> (i % 8)) & 1;
+}
+
+static bool open_container(json_frame_parser_t *p, bool object)
+{
+    if (p->depth >= JSON_FRAME_MAX_DEPTH) return false;
+    // 作为 data 元素或亮度时，容器的整数值为 0
+    deliver(p, 0);
+    uint16_t i = p->depth;
+    if (object) {
+        p->stack[i / 8] |= 1 << (i % 8);
+    } else {
+        p->stack[i / 8] &= ~(1 << (i % 8));
+    }
+    p->depth++;
+    if (p->role == ROLE_DATA && !object) {
+        p->has_data = true;
+        p->data_depth = p->depth;
+    }
+    p->role = ROLE_NONE;
+    p->state = object ? ST_OBJECT_FIRST : ST_ARRAY_FIRST;
+    return true;
+}
+
+static bool close_container(json_frame_parser_t *p, bool object)
+{
+    if (!p->depth || top_is_object(p) != object) return false;
+    if (p->depth == p->data_depth) p->data_depth = 0;
+    p->depth--;
+    p->state = p->depth ? ST_AFTER_VALUE : ST_DONE;
+    return true;
+}
+
+static bool number_done(json_frame_parser_t *p)
+{
+    int value;
+    p->num[p->num_len] = '\0';
+    // 根值的数字只需开头可以转换，cJSON 把剩下的字符当作忽略的尾部内容
+    if (!number_value(p->num, p->num_len, p->depth == 0, &value)) return false;
+    value_done(p, value);
+    return true;
+}
+
+static bool start_value(json_frame_parser_t *p, unsigned char c)
+{
+    if (p->data_depth && p->depth == p->data_depth) p->role = ROLE_PIXEL;
+    switch (c) {
+    case '{':
+    case '[':
+        return open_container(p, c == '{');
+    case '"':
+        p->key_wanted = false;
+        p->raw_escape = false;
+        p->state = ST_STRING;
+        return true;
+    case 't':
+    case 'f':
+    case 'n':
+        p->literal = c == 't' ? "rue" : c == 'f' ? "alse" : "ull";
+        p->literal_value = c == 't';
+        p->state = ST_LITERAL;
+        return true;
+    default:
+        if (c != '-' && !(c >= '0' && c <= '9')) return false;
+        p->num[0] = c;
+        p->num_len = 1;
+        p->state = ST_NUMBER;
+        return true;
+    }
+}
+
+static void unicode_start(json_frame_parser_t *p)
+{
+    p->hex_left = 4;
+    p->hex_value = 0;
+    p->hex_bad = false;
+    p->state = ST_UNICODE;
+}
+
+// 字符串中的一个字节。与 cJSON 相同分两层看：结尾的引号按 "反斜杠跳过下一个字节" 确定 (raw_escape)，
+// 转义则从头按顺序转换，\uXXXX 固定占 6 个字节，可能跨过前一层看到的转义对
+static bool string_byte(json_frame_parser_t *p, unsigned char c)
+{
+    // cJSON 的输入在 '\0' 处结束，字符串没有结尾
+    if (c == '\0') return false;
+    bool end = c == '"' && !p->raw_escape;
+    p->raw_escape = !p->raw_escape && c == '\\';
+    if (end) {
+        // 结尾引号前的反斜杠 (只在 \u 跨过转义对时出现) 与引号一起按 \" 转换
+        if (p->state == ST_ESCAPE) {
+            key_put(p, '"');
+        } else if (p->state != ST_STRING) {
+            return false;
+        }
+        string_done(p);
+        return true;
+    }
+
+    switch (p->state) {
+    case ST_STRING:
+        if (c == '\\') {
+            p->state = ST_ESCAPE;
+        } else {
+            key_put(p, c);
+        }
+        return true;
+
+    case ST_ESCAPE:
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/': key_put(p, c); break;
+        case 'b': key_put(p, '\b'); break;
+        case 'f': key_put(p, '\f'); break;
+        case 'n': key_put(p, '\n'); break;
+        case 'r': key_put(p, '\r'); break;
+        case 't': key_put(p, '\t'); break;
+        case 'u':
+            p->low_surrogate = false;
+            unicode_start(p);
+            return true;
+        default:
+            return false;
+        }
+        p->state = ST_STRING;
+        return true;
+
+    case ST_PAIR:
+        if (c != (unsigned char)*p->literal) return false;
+        if (*++p->literal == '\0') unicode_start(p);
+        return true;
+
+    default: {
+        int d = hex_digit(c);
+        if (d < 0) {
+            p->hex_bad = true;
+        } else {
+            p->hex_value = (p->hex_value << 4) | d;
+        }
+        if (--p->hex_left) return true;
+        uint16_t unit = p->hex_bad ? 0 : p->hex_value;
+        bool low = unit >= 0xDC00 && unit <= 0xDFFF;
+        if (p->low_surrogate != low) return false;
+        if (!low && unit >= 0xD800 && unit <= 0xDBFF) {
+            p->low_surrogate = true;
+            p->literal = "\\u";
+            p->state = ST_PAIR;
+            return true;
+        }
+        // 键名只和 ASCII 比较，非 ASCII 字符用一个不可能匹配的字节代替；码元 0 使键名在此截断
+        key_put(p, !low && unit < 0x80 ? unit : 0x80);
+        p->state = ST_STRING;
+        return true;
+    }
+    }
+}
+
+// 处理一个字节，返回 false 表示语法错误
+static bool step(json_frame_parser_t *p, unsigned char c)
+{
+    for (;;) {
+        switch (p->state) {
+        case ST_START:
+            // 与 cJSON 相同，跳过开头的 UTF-8 BOM
+            p->state = ST_VALUE;
+            if (c != 0xEF) continue;
+            p->literal = "\xBB\xBF";
+            p->state = ST_BOM;
+            return true;
+
+        case ST_BOM:
+            if (c != (unsigned char)*p->literal) return false;
+            if (*++p->literal == '\0') p->state = ST_VALUE;
+            return true;
+
+        case ST_NUMBER:
+            if (is_number_char(c)) {
+                if (p->num_len < JSON_FRAME_NUMBER_MAX - 1) {
+                    p->num[p->num_len++] = c;
+                    return true;
+                }
+                // cJSON 只取前 JSON_FRAME_NUMBER_MAX-1 个字符：容器中接下来的数字字符是语法错误，根值则是尾部内容
+                if (p->depth) return false;
+                return number_done(p);
+            }
+            // 数字由它后面的字符结束，该字符接着按新状态处理
+            if (!number_done(p)) return false;
+            if (p->state == ST_DONE) return true;
+            continue;
+
+        case ST_AFTER_VALUE:
+            if (is_space(c)) return true;
+            if (c == ',') {
+                p->state = top_is_object(p) ? ST_KEY : ST_VALUE;
+                return true;
+            }
+            if (c == '}' || c == ']') return close_container(p, c == '}');
+            return false;
+
+        case ST_VALUE:
+            if (is_space(c)) return true;
+            return start_value(p, c);
+
+        case ST_ARRAY_FIRST:
+            if (is_space(c)) return true;
+            if (c == ']') return close_container(p, false);
+            return start_value(p, c);
+
+        case ST_OBJECT_FIRST:
+        case ST_KEY:
+            if (is_space(c)) return true;
+            if (c == '}' && p->state == ST_OBJECT_FIRST) return close_container(p, true);
+            if (c != '"') return false;
+            p->role = ROLE_KEY;
+            p->key_wanted = p->depth == 1;
+            p->key_overflow = false;
+            p->key_ended = false;
+            p->key_len = 0;
+            p->raw_escape = false;
+            p->state = ST_STRING;
+            return true;
+
+        case ST_COLON:
+            if (is_space(c)) return true;
+            if (c != ':') return false;
+            p->state = ST_VALUE;
+            return true;
+
+        case ST_STRING:
+        case ST_ESCAPE:
+        case ST_UNICODE:
+        case ST_PAIR:
+            return string_byte(p, c);
+
+        case ST_LITERAL:
+            if (c != (unsigned char)*p->literal) return false;
+            if (*++p->literal == '\0') value_done(p, p->literal_value);
+            return true;
+
+        default:
+            return true;
+        }
+    }
+}
+
+json_frame_status_t json_frame_feed(json_frame_parser_t *p, const char *buf, size_t len)
+{
+    for (size_t i = 0; i < len && p->state < ST_DONE; i++) {
+        if (!step(p, (unsigned char)buf[i])) p->state = ST_ERROR;
+    }
+    return p->state == ST_DONE ? JSON_FRAME_DONE : p->state == ST_ERROR ? JSON_FRAME_ERROR : JSON_FRAME_MORE;
+}
+
+json_frame_status_t json_frame_finish(json_frame_parser_t *p)
+{
+    if (p->state == ST_NUMBER && p->depth == 0 && !number_done(p)) p->state = ST_ERROR;
+    if (p->state != ST_DONE) p->state = ST_ERROR;
+    return p->state == ST_DONE ? JSON_FRAME_DONE : JSON_FRAME_ERROR;
+}
@@ -0,0 +1,85 @@
+/* JSON 帧流式解析：{"brightness":20,"data":[16711680,65280,...]}
+ * 纯数据解析，不依赖 ESP-IDF；不建 cJSON 树、不分配内存，Body 可以按任意长度分块喂入
+ * (例如直接来自 httpd_req_recv)，data 数组每解析出一个元素就通过回调交给调用方写入显存，
+ * 状态只占解析器结构体本身，与 Body 长度无关。
+ *
+ * 结果与 cJSON_Parse + cJSON_GetObjectItem 取 valueint 的写法一致：
+ *   - 根对象中的键名不区分大小写，重复的键只取第一个；其它字段 (含任意嵌套) 只校验语法后跳过
+ *   - 元素和亮度取整数值：数字截断取整 (超出 int 时取边界值)，true 为 1，其余类型为 0
+ *   - 开头的 UTF-8 BOM 跳过，根值结束后的内容忽略
+ *   - 字符串的结尾按 "反斜杠跳过下一个字节" 确定，\uXXXX 固定占 6 个字节 (可以跨过转义对)，
+ *     其中有非十六进制字符时码元为 0 (键名在此截断)，代理对不完整时是语法错误
+ * 数字按 cJSON 的规则收集 (以 '-' 或数字开头，由 0-9 + - e E . 组成，最长 JSON_FRAME_NUMBER_MAX-1
+ * 个字符) 后整体转换，容器中的数字必须整个可以转换，根值只需开头可以转换 (其余算作尾部内容)；
+ * 嵌套深度超过 JSON_FRAME_MAX_DEPTH 视为错误。
+ *
+ * 像素在解析过程中就已回调，语法错误出现在中途时已写入的像素由调用方丢弃。
+ * brightness 字段出现在 data 之后时，已回调的像素用的是初始亮度，见 brightness_after_data。
+ */
+#ifndef JSON_FRAME_H
+#define JSON_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define JSON_FRAME_MAX_DEPTH    1000    // 与 cJSON 的 CJSON_NESTING_LIMIT 相同
+#define JSON_FRAME_NUMBER_MAX   64      // 与 cJSON 的数字缓冲区相同
+#define JSON_FRAME_KEY_MAX      16      // 只需要识别 brightness 和 data，更长的键名一定不匹配
+
+typedef enum {
+    JSON_FRAME_MORE,        // 根值还没有结束，继续喂入
+    JSON_FRAME_DONE,        // 根值已结束，之后的输入忽略
+    JSON_FRAME_ERROR,       // 语法错误，之后的输入忽略
+} json_frame_status_t;
+
+// data 数组的第 index 个元素 (只对 index < max_pixels 调用)
+typedef void (*json_frame_pixel_cb_t)(uint32_t index, int value, void *ctx);
+
+typedef struct {
+    // 配置，由 json_frame_init 设置
+    uint32_t max_pixels;
+    json_frame_pixel_cb_t cb;
+    void *ctx;
+
+    // 结果
+    int brightness;                 // 初值为默认亮度，遇到 brightness 字段时更新
+    bool has_brightness;
+    bool has_data;                  // data 字段是数组 (调用方据此决定是否显示)
+    bool brightness_after_data;     // brightness 在 data 之后才给出，已回调的像素需要按新亮度换算
+    uint32_t pixels;                // data 数组的元素个数 (含超出 max_pixels 的部分)
+
+    // 以下为解析状态
+    uint8_t state;
+    uint8_t role;                   // 正在解析的值的用途
+    uint16_t depth;
+    uint16_t data_depth;            // data 数组所在深度，0 表示不在 data 数组中
+    uint8_t stack[(JSON_FRAME_MAX_DEPTH + 7) / 8];  // 每层容器一位：1 为对象，0 为数组
+    bool brightness_seen;
+    bool data_seen;
+    const char *literal;            // true/false/null、BOM 或代理对的 \u 中剩余待匹配的字符
+    uint8_t literal_value;
+    bool raw_escape;                // 字符串中上一个字节是起转义作用的反斜杠 (决定哪个引号是结尾)
+    uint8_t hex_left;               // \uXXXX 中剩余的十六进制位数
+    uint16_t hex_value;
+    bool hex_bad;                   // \uXXXX 中有非十六进制字符，码元按 0 处理
+    bool low_surrogate;             // 正在读代理对的第二个码元
+    bool key_wanted;                // 当前字符串是根对象的键名，需要记录
+    bool key_overflow;
+    bool key_ended;                 // 键名中出现了 \u0000，之后的字符不参与比较 (同 C 字符串)
+    uint8_t key_len;
+    uint8_t num_len;
+    char key[JSON_FRAME_KEY_MAX];
+    char num[JSON_FRAME_NUMBER_MAX];
+} json_frame_parser_t;
+
+void json_frame_init(json_frame_parser_t *p, uint32_t max_pixels, int default_brightness,
+                     json_frame_pixel_cb_t cb, void *ctx);
+
+// 喂入下一段输入；返回 DONE 或 ERROR 之后不需要再喂
+json_frame_status_t json_frame_feed(json_frame_parser_t *p, const char *buf, size_t len);
+
+// 输入结束：根值是一个未结束的数字时在这里完成，根值不完整返回 ERROR
+json_frame_status_t json_frame_finish(json_frame_parser_t *p);
+
+#endif // JSON_FRAME_H
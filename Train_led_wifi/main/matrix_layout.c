@@ -0,0 +1,93 @@
+/* 点阵物理走线映射
+ *
+ * 逻辑坐标 (x,y) 依次经过：左右镜像 -> 顺时针旋转 -> 按起点角翻转 -> 按行展开 (蛇形时奇数行反向)
+ * 拼接时先确定像素所在面板及其在链上的序号，再在面板内按上述规则映射
+ */
+#include "matrix_layout.h"
+
+static bool layout_is_transposed(const matrix_layout_t *layout)
+{
+    return layout->rotation == 90 || layout->rotation == 270;
+}
+
+uint16_t matrix_layout_logical_width(const matrix_layout_t *layout)
+{
+    return layout_is_transposed(layout) ? layout->height : layout->width;
+}
+
+uint16_t matrix_layout_logical_height(const matrix_layout_t *layout)
+{
+    return layout_is_transposed(layout) ? layout->width : layout->height;
+}
+
+static bool layout_is_valid(const matrix_layout_t *layout)
+{
+    return layout && layout->width != 0 && layout->height != 0 &&
+           layout->rotation % 90 == 0 && layout->rotation < 360;
+}
+
+// 面板内逻辑坐标 -> 面板内灯带索引
+static uint32_t layout_map(const matrix_layout_t *layout, uint32_t x, uint32_t y)
+{
+    const uint32_t w = layout->width;
+    const uint32_t h = layout->height;
+    const uint32_t lw = matrix_layout_logical_width(layout);
+    const uint32_t lh = matrix_layout_logical_height(layout);
+    const bool flip_x = layout->origin == LAYOUT_ORIGIN_TOP_RIGHT || layout->origin == LAYOUT_ORIGIN_BOTTOM_RIGHT;
+    const bool flip_y = layout->origin == LAYOUT_ORIGIN_BOTTOM_LEFT || layout->origin == LAYOUT_ORIGIN_BOTTOM_RIGHT;
+
+    uint32_t mx = layout->mirror ? lw - 1 - x : x;
+
+    // 旋转到面板坐标
+    uint32_t px, py;
+    switch (layout->rotation) {
+    case 90:  px = lh - 1 - y; py = mx;          break;
+    case 180: px = w - 1 - mx; py = h - 1 - y;   break;
+    case 270: px = y;          py = lw - 1 - mx; break;
+    default:  px = mx;         py = y;           break;
+    }
+
+    // 以第0颗灯珠为原点
+    if (flip_x) px = w - 1 - px;
+    if (flip_y) py = h - 1 - py;
+
+    // 蛇形走线：从起点行开始数，奇数行方向相反
+    if (layout->serpentine && (py & 1)) px = w - 1 - px;
+
+    return py * w + px;
+}
+
+bool matrix_layout_build(const matrix_layout_t *layout, uint16_t *lut, size_t lut_len)
+{
+    const matrix_tiling_t single = { .tiles_x = 1, .tiles_y = 1 };
+    return matrix_layout_build_tiled(layout, &single, lut, lut_len);
+}
+
+bool matrix_layout_build_tiled(const matrix_layout_t *layout, const matrix_tiling_t *tiling,
+                               uint16_t *lut, size_t lut_len)
+{
+    if (!layout_is_valid(layout) || !tiling || !lut || tiling->tiles_x == 0 || tiling->tiles_y == 0) return false;
+
+    const uint32_t panel_pixels = (uint32_t)layout->width * layout->height;
+    const uint32_t total = panel_pixels * tiling->tiles_x * tiling->tiles_y;
+    if (total > lut_len || total > UINT16_MAX + 1) return false;
+
+    const uint32_t lw = matrix_layout_logical_width(layout);
+    const uint32_t lh = matrix_layout_logical_height(layout);
+    const uint32_t canvas_w = lw * tiling->tiles_x;
+
+    for (uint32_t ty = 0; ty < tiling->tiles_y; ty++) {
+        for (uint32_t tx = 0; tx < tiling->tiles_x; tx++) {
+            // 面板在灯带链上的序号
+            uint32_t chain = (tiling->serpentine && (ty & 1)) ? tiling->tiles_x - 1 - tx : tx;
+            uint32_t base = (ty * tiling->tiles_x + chain) * panel_pixels;
+
+            for (uint32_t y = 0; y < lh; y++) {
+                for (uint32_t x = 0; x < lw; x++) {
+                    lut[(ty * lh + y) * canvas_w + tx * lw + x] = (uint16_t)(base + layout_map(layout, x, y));
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+/* 点阵物理走线映射
+ * 启动时根据布局描述生成一张 坐标 -> 灯带索引 的查找表，之后每次写像素只查表。
+ * 纯计算，不依赖 ESP-IDF
+ */
+#ifndef MATRIX_LAYOUT_H
+#define MATRIX_LAYOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// 灯带第0颗灯珠所在的角 (从正面看)
+typedef enum {
+    LAYOUT_ORIGIN_TOP_LEFT,
+    LAYOUT_ORIGIN_TOP_RIGHT,
+    LAYOUT_ORIGIN_BOTTOM_LEFT,
+    LAYOUT_ORIGIN_BOTTOM_RIGHT,
+} layout_origin_t;
+
+typedef struct {
+    uint16_t width;         // 面板物理宽度 (灯珠列数)
+    uint16_t height;        // 面板物理高度 (灯珠行数)
+    layout_origin_t origin;
+    bool serpentine;        // true: 蛇形走线，相邻行方向相反；false: 每行同向 (Z型)
+    uint16_t rotation;      // 画面顺时针旋转角度：0/90/180/270
+    bool mirror;            // 画面左右镜像 (在旋转之前进行)
+} matrix_layout_t;
+
+// 旋转后的逻辑画面尺寸 (90/270 度时宽高互换)
+uint16_t matrix_layout_logical_width(const matrix_layout_t *layout);
+uint16_t matrix_layout_logical_height(const matrix_layout_t *layout);
+
+// 多块面板拼接：面板按行排列，灯带从左上角面板开始串联
+typedef struct {
+    uint16_t tiles_x;       // 每行面板数
+    uint16_t tiles_y;       // 面板行数
+    bool serpentine;        // true: 奇数行面板从右往左串联
+} matrix_tiling_t;
+
+/* 生成查找表：lut[y * 逻辑宽度 + x] = 灯带索引
+ * lut_len 至少为 width * height，参数非法返回 false
+ */
+bool matrix_layout_build(const matrix_layout_t *layout, uint16_t *lut, size_t lut_len);
+
+/* 生成拼接画布的查找表，每块面板使用相同的布局 layout
+ * 画布宽 = tiles_x * 面板逻辑宽度，高 = tiles_y * 面板逻辑高度
+ * lut[y * 画布宽 + x] = 灯带索引，lut_len 至少为画布像素数
+ */
+bool matrix_layout_build_tiled(const matrix_layout_t *layout, const matrix_tiling_t *tiling,
+                               uint16_t *lut, size_t lut_len);
+
+#endif // MATRIX_LAYOUT_H
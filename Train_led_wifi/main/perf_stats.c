@@ -0,0 +1,151 @@
+/* 运行时性能统计，说明见 perf_stats.h */
+#include <stdio.h>
+#include <stdarg.h>
+#include "perf_stats.h"
+
+#define PERF_METRIC_PREFIX  "matrix_"
+
+const uint32_t perf_hist_bucket_le_us[PERF_HIST_BUCKETS - 1] = {
+    50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000,
+};
+
+// 单写入方：读改写不需要原子指令 (ESP32-C3 没有 A 扩展，原子 RMW 要靠关中断实现)
+static inline void perf_add(_Atomic uint32_t *v, uint32_t n)
+{
+    atomic_store_explicit(v, atomic_load_explicit(v, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+void perf_hist_record(perf_hist_t *hist, uint32_t us)
+{
+    int b = 0;
+    while (b < PERF_HIST_BUCKETS - 1 && us > perf_hist_bucket_le_us[b]) b++;
+    perf_add(&hist->counts[b], 1);
+    perf_add(&hist->sum_us, us);
+    if (us > atomic_load_explicit(&hist->max_us, memory_order_relaxed)) {
+        atomic_store_explicit(&hist->max_us, us, memory_order_relaxed);
+    }
+}
+
+static void perf_printf(perf_writer_t *w, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void perf_printf(perf_writer_t *w, const char *fmt, ...)
+{
+    if (w->truncated) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(w->buf + w->len, w->size - w->len, fmt, ap);
+    va_end(ap);
+    if (n < 0 || (size_t)n >= w->size - w->len) {
+        w->truncated = true;
+        return;
+    }
+    w->len += n;
+}
+
+// JSON 字段名，自动补逗号
+static void perf_json_key(perf_writer_t *w, const char *name, const char *suffix)
+{
+    perf_printf(w, "%s\"%s%s\":", w->fields++ ? "," : "", name, suffix);
+}
+
+void perf_writer_init(perf_writer_t *w, char *buf, size_t size, bool prometheus)
+{
+    *w = (perf_writer_t) {
+        .buf = buf,
+        .size = size,
+        .prometheus = prometheus,
+    };
+    if (size) buf[0] = '\0';
+    if (prometheus) return;
+
+    // 桶上限只输出一次，各直方图的 buckets 数组与之一一对应 (最后一个为溢出桶)
+    perf_printf(w, "{");
+    perf_json_key(w, "bucket_le", "_us");
+    for (int b = 0; b < PERF_HIST_BUCKETS - 1; b++) {
+        perf_printf(w, "%s%lu", b ? "," : "[", (unsigned long)perf_hist_bucket_le_us[b]);
+    }
+    perf_printf(w, "]");
+}
+
+void perf_write_counter(perf_writer_t *w, const char *name, const char *help, uint32_t value)
+{
+    if (w->prometheus) {
+        perf_printf(w, "# HELP " PERF_METRIC_PREFIX "%s_total %s\n# TYPE " PERF_METRIC_PREFIX "%s_total counter\n"
+                    PERF_METRIC_PREFIX "%s_total %lu\n", name, help, name, name, (unsigned long)value);
+    } else {
+        perf_json_key(w, name, "");
+        perf_printf(w, "%lu", (unsigned long)value);
+    }
+}
+
+void perf_write_gauge(perf_writer_t *w, const char *name, const char *help, double value)
+{
+    if (w->prometheus) {
+        perf_printf(w, "# HELP " PERF_METRIC_PREFIX "%s %s\n# TYPE " PERF_METRIC_PREFIX "%s gauge\n"
+                    PERF_METRIC_PREFIX "%s %g\n", name, help, name, name, value);
+    } else {
+        perf_json_key(w, name, "");
+        perf_printf(w, "%g", value);
+    }
+}
+
+// 近似分位数：落在哪个桶就取该桶上限 (不超过最大值)，溢出桶取最大值
+static uint32_t perf_hist_quantile(const uint32_t *counts, uint32_t total, uint32_t max_us, int percent)
+{
+    if (total == 0) return 0;
+    uint32_t rank = (uint32_t)(((uint64_t)total * percent + 99) / 100);
+    uint32_t seen = 0;
+    for (int b = 0; b < PERF_HIST_BUCKETS - 1; b++) {
+        seen += counts[b];
+        if (seen >= rank) {
+            return perf_hist_bucket_le_us[b] < max_us ? perf_hist_bucket_le_us[b] : max_us;
+        }
+    }
+    return max_us;
+}
+
+void perf_write_hist(perf_writer_t *w, const perf_hist_t *hist)
+{
+    // 先取快照，之后的输出都基于同一组数值 (_count 总是等于 +Inf 桶)
+    uint32_t counts[PERF_HIST_BUCKETS];
+    uint32_t total = 0;
+    for (int b = 0; b < PERF_HIST_BUCKETS; b++) {
+        counts[b] = atomic_load_explicit(&hist->counts[b], memory_order_relaxed);
+        total += counts[b];
+    }
+    uint32_t sum_us = atomic_load_explicit(&hist->sum_us, memory_order_relaxed);
+    uint32_t max_us = atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+
+    if (w->prometheus) {
+        const char *name = hist->name;
+        perf_printf(w, "# HELP " PERF_METRIC_PREFIX "%s_seconds %s\n# TYPE " PERF_METRIC_PREFIX "%s_seconds histogram\n",
+                    name, hist->help, name);
+        uint32_t cumulative = 0;
+        for (int b = 0; b < PERF_HIST_BUCKETS - 1; b++) {
+            cumulative += counts[b];
+            perf_printf(w, PERF_METRIC_PREFIX "%s_seconds_bucket{le=\"%g\"} %lu\n",
+                        name, perf_hist_bucket_le_us[b] / 1e6, (unsigned long)cumulative);
+        }
+        perf_printf(w, PERF_METRIC_PREFIX "%s_seconds_bucket{le=\"+Inf\"} %lu\n", name, (unsigned long)total);
+        perf_printf(w, PERF_METRIC_PREFIX "%s_seconds_sum %g\n", name, sum_us / 1e6);
+        perf_printf(w, PERF_METRIC_PREFIX "%s_seconds_count %lu\n", name, (unsigned long)total);
+        return;
+    }
+
+    perf_json_key(w, hist->name, "_us");
+    perf_printf(w, "{\"count\":%lu,\"sum\":%lu,\"max\":%lu,\"p50\":%lu,\"p90\":%lu,\"p99\":%lu,\"buckets\":",
+                (unsigned long)total, (unsigned long)sum_us, (unsigned long)max_us,
+                (unsigned long)perf_hist_quantile(counts, total, max_us, 50),
+                (unsigned long)perf_hist_quantile(counts, total, max_us, 90),
+                (unsigned long)perf_hist_quantile(counts, total, max_us, 99));
+    for (int b = 0; b < PERF_HIST_BUCKETS; b++) {
+        perf_printf(w, "%s%lu", b ? "," : "[", (unsigned long)counts[b]);
+    }
+    perf_printf(w, "]}");
+}
+
+size_t perf_writer_finish(perf_writer_t *w)
+{
+    if (!w->prometheus) perf_printf(w, "}");
+    return w->truncated ? 0 : w->len;
+}
@@ -0,0 +1,53 @@
+/* 运行时性能统计：固定桶的耗时直方图 + 输出为 JSON / Prometheus 文本格式
+ * 纯计算，不依赖 ESP-IDF；计时和取值由调用方完成
+ *
+ * 直方图无锁：每个直方图只允许一个任务写入 (例如只在 httpd 任务或只在渲染任务中记录)，
+ * 写入方对每个字段做普通的 32 位读改写，读取方 (统计接口) 随时读取，不加锁也不关中断。
+ * 读取时各字段可能相差正在进行的那一次记录，这对监控没有影响。
+ * 桶的上限为 1-2-5 序列的微秒数，最后一个桶收集超出上限的值。
+ */
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#define PERF_HIST_BUCKETS   14      // 13 个有上限的桶 + 1 个溢出桶
+
+typedef struct {
+    const char *name;               // 指标名 (小写加下划线)，输出时加前缀和单位
+    const char *help;
+    _Atomic uint32_t counts[PERF_HIST_BUCKETS];
+    _Atomic uint32_t sum_us;        // 累计耗时，约 71 分钟的累计值后回绕 (Prometheus 按计数器重置处理)
+    _Atomic uint32_t max_us;
+} perf_hist_t;
+
+#define PERF_HIST_INIT(metric_name, metric_help) { .name = (metric_name), .help = (metric_help) }
+
+// 各桶的上限 (微秒)，最后一个桶没有上限
+extern const uint32_t perf_hist_bucket_le_us[PERF_HIST_BUCKETS - 1];
+
+// 记录一次耗时，只能由该直方图唯一的写入任务调用
+void perf_hist_record(perf_hist_t *hist, uint32_t us);
+
+// 输出缓冲区：JSON 输出为一个对象，Prometheus 输出为文本格式 0.0.4
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool prometheus;
+    bool truncated;
+    int fields;                     // JSON：已写入的字段数，决定是否需要逗号
+} perf_writer_t;
+
+void perf_writer_init(perf_writer_t *w, char *buf, size_t size, bool prometheus);
+// 计数器 (只增不减) 与瞬时值；name 不带前缀
+void perf_write_counter(perf_writer_t *w, const char *name, const char *help, uint32_t value);
+void perf_write_gauge(perf_writer_t *w, const char *name, const char *help, double value);
+void perf_write_hist(perf_writer_t *w, const perf_hist_t *hist);
+// 结束输出，返回长度；缓冲区不够时返回 0
+size_t perf_writer_finish(perf_writer_t *w);
+
+#endif // PERF_STATS_H
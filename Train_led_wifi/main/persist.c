@@ -0,0 +1,155 @@
+/* 状态保存，说明见 persist.h */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "persist.h"
+
+#define NVS_ENTRY_SIZE      32
+#define NVS_CHUNK_MAX       (125 * NVS_ENTRY_SIZE)  // 一页 126 个条目，blob 按页分块，每块另占一个头条目
+
+// blob 占用的 NVS 条目数：每块一个头条目加数据条目，再加一个索引条目
+static size_t persist_blob_entries(size_t size)
+{
+    size_t entries = 1;
+    do {
+        size_t chunk = MIN(size, NVS_CHUNK_MAX);
+        entries += 1 + (chunk + NVS_ENTRY_SIZE - 1) / NVS_ENTRY_SIZE;
+        size -= chunk;
+    } while (size);
+    return entries;
+}
+
+static uint32_t persist_hash(const uint8_t *data, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h = (h ^ data[i]) * 16777619u;
+    }
+    return h;
+}
+
+esp_err_t persist_init(persist_t *p)
+{
+    size_t max_size = 0;
+    for (int i = 0; i < p->count; i++) {
+        if (p->entries[i].size > max_size) max_size = p->entries[i].size;
+        p->entries[i].stored = false;
+    }
+    p->scratch = malloc(max_size ? max_size : 1);
+    if (!p->scratch) return ESP_ERR_NO_MEM;
+    atomic_store(&p->dirty, false);
+    p->pending = false;
+    p->saved_once = false;
+    p->last_err = ESP_OK;
+    p->writes = 0;
+    p->skipped = 0;
+    esp_err_t err = nvs_open(p->name_space, NVS_READWRITE, &p->nvs);
+    if (err != ESP_OK) {
+        free(p->scratch);
+        p->scratch = NULL;
+    }
+    return err;
+}
+
+esp_err_t persist_check_space(persist_t *p, size_t *need, size_t *have)
+{
+    nvs_stats_t stats;
+    size_t used = 0;
+    esp_err_t err = nvs_get_stats(NULL, &stats);
+    if (err == ESP_OK) err = nvs_get_used_entry_count(p->nvs, &used);
+    if (err != ESP_OK) return err;
+
+    *need = 0;
+    for (int i = 0; i < p->count; i++) {
+        *need += 2 * persist_blob_entries(p->entries[i].size);
+    }
+    // 本命名空间已占用的条目 (上次保存的内容) 也算可用
+    *have = stats.available_entries + used;
+    return *need <= *have ? ESP_OK : ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+}
+
+esp_err_t persist_restore(persist_t *p, int index, void *buf)
+{
+    persist_entry_t *e = &p->entries[index];
+    size_t len = 0;
+    esp_err_t err = nvs_get_blob(p->nvs, e->key, NULL, &len);
+    if (err != ESP_OK) return err;
+    // 画布尺寸等改变后旧内容不再适用
+    if (len != e->size) return ESP_ERR_INVALID_SIZE;
+    err = nvs_get_blob(p->nvs, e->key, p->scratch, &len);
+    if (err != ESP_OK) return err;
+
+    e->hash = persist_hash(p->scratch, len);
+    e->stored = true;
+    memcpy(buf, p->scratch, len);
+    return ESP_OK;
+}
+
+bool persist_mark_dirty(persist_t *p, uint32_t now_ms)
+{
+    // 先写时间再置标志：保存任务看到 dirty 时读到的时间不会早于这次修改
+    atomic_store(&p->last_change_ms, now_ms);
+    return !atomic_exchange(&p->dirty, true);
+}
+
+esp_err_t persist_flush(persist_t *p, uint32_t now_ms)
+{
+    // 先清标志再取快照：取快照期间的修改会重新置位，留给下一次保存
+    atomic_store(&p->dirty, false);
+    p->pending = false;
+    p->saved_once = true;
+    p->last_save_ms = now_ms;
+
+    esp_err_t err = ESP_OK;
+    int written = 0;
+    for (int i = 0; i < p->count && err == ESP_OK; i++) {
+        persist_entry_t *e = &p->entries[i];
+        if (!e->snapshot(p->scratch, e->ctx)) continue;
+        uint32_t hash = persist_hash(p->scratch, e->size);
+        if (e->stored && e->hash == hash) {
+            p->skipped++;
+            continue;
+        }
+        err = nvs_set_blob(p->nvs, e->key, p->scratch, e->size);
+        if (err == ESP_OK) {
+            e->hash = hash;
+            e->stored = true;
+            p->writes++;
+            written++;
+        }
+    }
+    if (err == ESP_OK && written) {
+        err = nvs_commit(p->nvs);
+    }
+    if (err != ESP_OK) {
+        // 写失败的条目保持原来的哈希，过 min_interval_ms 后重试
+        persist_mark_dirty(p, now_ms);
+    }
+    p->last_err = err;
+    return err;
+}
+
+uint32_t persist_poll(persist_t *p, uint32_t now_ms)
+{
+    if (!p->pending) {
+        if (!atomic_load(&p->dirty)) return PERSIST_IDLE;
+        p->pending = true;
+        p->first_change_ms = now_ms;
+    }
+
+    // 修改方的时间可能比这里取的稍晚，差为负时按刚刚修改处理
+    int32_t since_change = (int32_t)(now_ms - atomic_load(&p->last_change_ms));
+    uint32_t quiet = since_change > 0 ? since_change : 0;
+    uint32_t age = now_ms - p->first_change_ms;
+    uint32_t wait = 0;
+    if (quiet < p->quiet_ms && age < p->max_delay_ms) {
+        wait = MIN(p->quiet_ms - quiet, p->max_delay_ms - age);
+    }
+    if (p->saved_once && now_ms - p->last_save_ms < p->min_interval_ms) {
+        wait = MAX(wait, p->min_interval_ms - (now_ms - p->last_save_ms));
+    }
+    if (wait) return wait;
+
+    persist_flush(p, now_ms);
+    return atomic_load(&p->dirty) ? p->min_interval_ms : PERSIST_IDLE;
+}
@@ -0,0 +1,70 @@
+/* 状态保存：把若干条目 (整块二进制) 保存到 NVS，短时间内的多次修改合并成一次写入，内容没变的条目不写 flash
+ * 只依赖 nvs.h，时间由调用方传入 (毫秒，允许回绕)
+ *
+ * 修改方只调用 persist_mark_dirty 记下修改时间 (任意任务，不碰 flash)，保存由一个低优先级任务反复调用
+ * persist_poll 完成，写 flash 的耗时不会落在绘图或网络任务上：
+ *   - 距最后一次修改满 quiet_ms (画面静止下来) 时保存；
+ *   - 一直在修改 (持续推流) 时，最晚在第一次未保存的修改之后 max_delay_ms 保存一次；
+ *   - 两次保存至少间隔 min_interval_ms。
+ * 保存时对每个条目取快照，与上次保存 (或启动时读出) 的内容比较 FNV-1a 哈希，相同就跳过，
+ * 所有写入的条目一次 nvs_commit。
+ */
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "nvs.h"
+
+#define PERSIST_IDLE    UINT32_MAX      // persist_poll：没有未保存的修改，等下一次 persist_mark_dirty
+
+typedef struct {
+    const char *key;                    // NVS 键名，最长 15 个字符
+    size_t size;
+    // 把当前内容写入 buf (size 字节)；返回 false 表示现在没有可保存的内容，本次跳过该条目
+    bool (*snapshot)(void *buf, void *ctx);
+    void *ctx;
+    uint32_t hash;                      // NVS 中内容的哈希，stored 为 true 时有效
+    bool stored;
+} persist_entry_t;
+
+typedef struct {
+    const char *name_space;
+    persist_entry_t *entries;
+    int count;
+    uint32_t quiet_ms;
+    uint32_t min_interval_ms;
+    uint32_t max_delay_ms;
+
+    _Atomic bool dirty;
+    _Atomic uint32_t last_change_ms;
+
+    // 以下只由保存任务访问
+    nvs_handle_t nvs;
+    uint8_t *scratch;                   // 最大条目大小的快照缓冲区
+    bool pending;                       // 已看到 dirty，还没有保存
+    uint32_t first_change_ms;
+    bool saved_once;
+    uint32_t last_save_ms;
+    esp_err_t last_err;                 // 最近一次保存的结果
+    uint32_t writes;                    // 写入 flash 的条目数
+    uint32_t skipped;                   // 内容没变而跳过的条目数
+} persist_t;
+
+// 打开 NVS 命名空间并分配快照缓冲区，entries 等配置字段由调用方先填好
+esp_err_t persist_init(persist_t *p);
+// 检查 NVS 分区能否放下所有条目：保存时先写新内容再擦旧内容，每个条目要能同时放下两份。
+// 放不下时返回 ESP_ERR_NVS_NOT_ENOUGH_SPACE；need/have 为需要和可用的 NVS 条目数 (每条 32 字节)
+esp_err_t persist_check_space(persist_t *p, size_t *need, size_t *have);
+// 读出已保存的条目；不存在或大小不符时返回错误，buf 不变
+esp_err_t persist_restore(persist_t *p, int index, void *buf);
+// 记一次修改；返回 true 表示此前没有未保存的修改 (调用方此时唤醒保存任务)
+bool persist_mark_dirty(persist_t *p, uint32_t now_ms);
+// 到期时保存，返回距下次需要调用的毫秒数，没有未保存的修改时返回 PERSIST_IDLE
+uint32_t persist_poll(persist_t *p, uint32_t now_ms);
+// 不等待，立即保存有变化的条目 (例如重启之前)
+esp_err_t persist_flush(persist_t *p, uint32_t now_ms);
+
+#endif // PERSIST_H
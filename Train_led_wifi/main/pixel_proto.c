@@ -0,0 +1,115 @@
+/* UDP 实时像素协议解析 (DDP / E1.31 sACN)
+ *
+ * DDP 头 (10 字节，带时间码时 14 字节)：
+ *   [0] flags: V1 V0 x T S R Q P   [1] 序号(低4位)   [2] 数据类型
+ *   [3] 目标ID   [4..7] 数据偏移(大端)   [8..9] 数据长度(大端)
+ *
+ * E1.31 数据包 = Root Layer(38) + Framing Layer(77) + DMP Layer(10+通道)
+ */
+#include <string.h>
+#include "pixel_proto.h"
+
+#define DDP_FLAGS_VER_MASK      0xC0
+#define DDP_FLAGS_VER1          0x40
+#define DDP_FLAGS_TIMECODE      0x10
+#define DDP_FLAGS_STORAGE       0x08
+#define DDP_FLAGS_REPLY         0x04
+#define DDP_FLAGS_QUERY         0x02
+#define DDP_FLAGS_PUSH          0x01
+#define DDP_ID_DISPLAY          1
+#define DDP_ID_ALL              255
+
+#define E131_ROOT_VECTOR_DATA       0x00000004
+#define E131_ROOT_VECTOR_EXTENDED   0x00000008
+#define E131_FRAME_VECTOR_DATA      0x00000002
+#define E131_EXT_VECTOR_SYNC        0x00000001
+#define E131_DMP_VECTOR             0x02
+#define E131_DMP_ADDR_TYPE          0xA1
+#define E131_OPT_PREVIEW            0x80
+#define E131_OPT_TERMINATED         0x40
+#define E131_DATA_HEADER_LEN        126
+#define E131_SYNC_PACKET_LEN        49
+
+static const uint8_t s_acn_id[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+
+static inline uint16_t rd_be16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t rd_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+bool ddp_parse(const uint8_t *buf, size_t len, ddp_packet_t *out)
+{
+    if (len < DDP_HEADER_LEN) return false;
+
+    uint8_t flags = buf[0];
+    if ((flags & DDP_FLAGS_VER_MASK) != DDP_FLAGS_VER1) return false;
+    if (flags & (DDP_FLAGS_STORAGE | DDP_FLAGS_REPLY | DDP_FLAGS_QUERY)) return false;
+    if (buf[3] != DDP_ID_DISPLAY && buf[3] != DDP_ID_ALL) return false;
+
+    size_t hdr_len = (flags & DDP_FLAGS_TIMECODE) ? DDP_HEADER_LEN_TIMECODE : DDP_HEADER_LEN;
+    uint16_t data_len = rd_be16(&buf[8]);
+    if (len < hdr_len || len - hdr_len < data_len) return false;
+
+    out->offset = rd_be32(&buf[4]);
+    out->data = buf + hdr_len;
+    out->len = data_len;
+    out->seq = buf[1] & 0x0F;
+    out->push = (flags & DDP_FLAGS_PUSH) != 0;
+    return true;
+}
+
+e131_pkt_type_t e131_parse(const uint8_t *buf, size_t len, e131_packet_t *out)
+{
+    if (len < E131_SYNC_PACKET_LEN) return E131_PKT_INVALID;
+    if (rd_be16(&buf[0]) != 0x0010 || rd_be16(&buf[2]) != 0x0000) return E131_PKT_INVALID;
+    if (memcmp(&buf[4], s_acn_id, sizeof(s_acn_id)) != 0) return E131_PKT_INVALID;
+
+    uint32_t root_vector = rd_be32(&buf[18]);
+    memset(out, 0, sizeof(*out));
+
+    if (root_vector == E131_ROOT_VECTOR_EXTENDED) {
+        if (rd_be32(&buf[40]) != E131_EXT_VECTOR_SYNC) return E131_PKT_INVALID;
+        out->seq = buf[44];
+        out->universe = rd_be16(&buf[45]);
+        return E131_PKT_SYNC;
+    }
+
+    if (root_vector != E131_ROOT_VECTOR_DATA || len < E131_DATA_HEADER_LEN) return E131_PKT_INVALID;
+    if (rd_be32(&buf[40]) != E131_FRAME_VECTOR_DATA) return E131_PKT_INVALID;
+    if (buf[117] != E131_DMP_VECTOR || buf[118] != E131_DMP_ADDR_TYPE) return E131_PKT_INVALID;
+    if (rd_be16(&buf[119]) != 0 || rd_be16(&buf[121]) != 1) return E131_PKT_INVALID;
+
+    // 属性值个数包含 1 字节 DMX 起始码，只接受标准数据 (起始码 0)
+    uint16_t prop_count = rd_be16(&buf[123]);
+    if (prop_count < 1 || buf[125] != 0x00) return E131_PKT_INVALID;
+    if (len - (E131_DATA_HEADER_LEN - 1) < prop_count) return E131_PKT_INVALID;
+
+    out->priority = buf[108];
+    out->sync_addr = rd_be16(&buf[109]);
+    out->seq = buf[111];
+    out->preview = (buf[112] & E131_OPT_PREVIEW) != 0;
+    out->terminated = (buf[112] & E131_OPT_TERMINATED) != 0;
+    out->universe = rd_be16(&buf[113]);
+    out->data = buf + E131_DATA_HEADER_LEN;
+    out->len = prop_count - 1;
+    return E131_PKT_DATA;
+}
+
+bool ddp_seq_is_newer(uint8_t last, uint8_t seq)
+{
+    // 4 位序号 (1-15 循环)，向前 7 个以内视为新包
+    uint8_t diff = (uint8_t)(seq + 15 - last) % 15;
+    return diff != 0 && diff <= 7;
+}
+
+bool e131_seq_is_newer(uint8_t last, uint8_t seq)
+{
+    // E1.31 规范 6.7.2：差值在 (-20, 0] 内视为乱序/重复包
+    int8_t diff = (int8_t)(seq - last);
+    return diff > 0 || diff <= -20;
+}
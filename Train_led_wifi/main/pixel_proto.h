@@ -0,0 +1,54 @@
+/* UDP 实时像素协议解析 (DDP / E1.31 sACN)
+ * 纯数据解析，不依赖 FreeRTOS/lwIP，收包与写显存由调用方负责
+ */
+#ifndef PIXEL_PROTO_H
+#define PIXEL_PROTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define DDP_PORT                    4048
+#define DDP_HEADER_LEN              10
+#define DDP_HEADER_LEN_TIMECODE     14
+
+#define E131_PORT                   5568
+#define E131_CHANNELS_PER_UNIVERSE  510   // 170 个 RGB 像素
+
+// DDP 数据包 (只关心像素数据部分)
+typedef struct {
+    uint32_t offset;       // 数据在整条灯带中的字节偏移
+    const uint8_t *data;   // 指向接收缓冲区内的像素数据
+    uint16_t len;          // 像素数据字节数
+    uint8_t seq;           // 序号 1-15，0 表示发送端未使用序号
+    bool push;             // PUSH 标志：本帧数据已发完，可以刷新
+} ddp_packet_t;
+
+typedef enum {
+    E131_PKT_INVALID,
+    E131_PKT_DATA,         // 数据包
+    E131_PKT_SYNC,         // 同步包 (E1.31-2016 Universe Sync)
+} e131_pkt_type_t;
+
+typedef struct {
+    uint16_t universe;     // DATA: 宇宙号；SYNC: 同步地址
+    uint16_t sync_addr;    // DATA: 非0表示需等待对应同步包后再输出
+    uint8_t seq;
+    uint8_t priority;
+    bool preview;          // 预览数据，不应输出到灯
+    bool terminated;       // 发送端声明流结束
+    const uint8_t *data;   // DMX 通道数据 (已跳过起始码)
+    uint16_t len;          // 通道数
+} e131_packet_t;
+
+// 解析 DDP 包，只接受写入显示设备的数据包 (忽略 query/reply/storage/控制类)
+bool ddp_parse(const uint8_t *buf, size_t len, ddp_packet_t *out);
+
+// 解析 E1.31 包，返回包类型
+e131_pkt_type_t e131_parse(const uint8_t *buf, size_t len, e131_packet_t *out);
+
+// 序号比较：true 表示 seq 比 last 新；重复或过期的包返回 false
+bool ddp_seq_is_newer(uint8_t last, uint8_t seq);
+bool e131_seq_is_newer(uint8_t last, uint8_t seq);
+
+#endif // PIXEL_PROTO_H
@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""Build and inspect animation images for the 'anim' flash partition.
+
+Format (little endian, see main/anim_format.h):
+  magic "LEDA", version 1, reserved, width, height, frame count, loop count, reserved
+  uint16 duration in ms per frame, zero padded to 4 bytes
+  frames: width * height pixels each, row by row, R,G,B
+
+Usage:
+  anim_pack.py build input.gif -o anim.bin [--size 8x8] [--loops 0] [--duration 100]
+  anim_pack.py build frames_dir/ -o anim.bin --duration 80
+  anim_pack.py play anim.bin          # replay on the terminal with the firmware's timing
+  anim_pack.py selftest
+  anim_pack.py testimage -o test.bin [--size 8x8] [--frames 5] [--loops 2]   # known content, for host_sim/anim_format_test
+
+Upload to a running device:
+  curl --data-binary @anim.bin http://<ip>/api/anim
+or write it at flash time:
+  parttool.py write_partition --partition-name anim --input anim.bin
+"""
+import argparse
+import os
+import struct
+import sys
+import time
+
+MAGIC = b"LEDA"
+VERSION = 1
+HEADER = struct.Struct("<4sBBHHHHH")    # 16 bytes
+MIN_FRAME_MS = 10                       # same clamp as the firmware player
+PARTITION_SIZE = 0xF0000                # anim partition in partitions.csv
+
+
+def frames_offset(frame_count):
+    return (HEADER.size + frame_count * 2 + 3) & ~3
+
+
+def pack(width, height, frames, durations, loops=0):
+    """frames: list of bytes objects, width*height*3 each."""
+    if not frames or len(frames) != len(durations):
+        raise ValueError("need one duration per frame")
+    frame_size = width * height * 3
+    out = bytearray(HEADER.pack(MAGIC, VERSION, 0, width, height, len(frames), loops, 0))
+    for d in durations:
+        out += struct.pack("<H", max(0, min(int(d), 0xFFFF)))
+    out += bytes(frames_offset(len(frames)) - len(out))
+    for f in frames:
+        if len(f) != frame_size:
+            raise ValueError("frame is %d bytes, expected %d" % (len(f), frame_size))
+        out += f
+    return bytes(out)
+
+
+class Animation:
+    """Reads an image the same way the firmware does: no copies, frames are views into the buffer."""
+
+    def __init__(self, data):
+        if len(data) < HEADER.size:
+            raise ValueError("image too short")
+        magic, ver, _, self.width, self.height, self.frame_count, self.loop_count, _ = HEADER.unpack_from(data)
+        if magic != MAGIC or ver != VERSION:
+            raise ValueError("bad magic or version")
+        if not self.width or not self.height or not self.frame_count:
+            raise ValueError("empty animation")
+        self.frame_size = self.width * self.height * 3
+        self.size = frames_offset(self.frame_count) + self.frame_size * self.frame_count
+        if len(data) < self.size:
+            raise ValueError("image truncated: %d of %d bytes" % (len(data), self.size))
+        self._data = memoryview(data)
+
+    def duration(self, i):
+        return struct.unpack_from("<H", self._data, HEADER.size + i * 2)[0]
+
+    def frame(self, i):
+        start = frames_offset(self.frame_count) + i * self.frame_size
+        return self._data[start:start + self.frame_size]
+
+    def schedule(self, max_loops=None):
+        """Yield (start_ms, frame_index) like the firmware: absolute deadlines, so rounding never accumulates."""
+        t = 0
+        loops = 0
+        while True:
+            for i in range(self.frame_count):
+                yield t, i
+                t += max(self.duration(i), MIN_FRAME_MS)
+            loops += 1
+            if self.loop_count and loops >= self.loop_count:
+                return
+            if max_loops is not None and loops >= max_loops:
+                return
+
+
+def load_frames(path, width, height, default_ms):
+    try:
+        from PIL import Image, ImageSequence
+    except ImportError:
+        sys.exit("Pillow is required to read images: pip install pillow")
+
+    def to_rgb(img):
+        img = img.convert("RGB")
+        if img.size != (width, height):
+            img = img.resize((width, height), Image.NEAREST)
+        return img.tobytes()
+
+    frames, durations = [], []
+    if os.path.isdir(path):
+        names = sorted(n for n in os.listdir(path) if n.lower().endswith((".png", ".bmp", ".gif", ".jpg")))
+        for n in names:
+            with Image.open(os.path.join(path, n)) as img:
+                frames.append(to_rgb(img))
+                durations.append(default_ms)
+    else:
+        with Image.open(path) as img:
+            for f in ImageSequence.Iterator(img):
+                frames.append(to_rgb(f))
+                durations.append(f.info.get("duration", default_ms) or default_ms)
+    if not frames:
+        sys.exit("no frames found in %s" % path)
+    return frames, durations
+
+
+def cmd_build(args):
+    width, height = (int(v) for v in args.size.lower().split("x"))
+    frames, durations = load_frames(args.input, width, height, args.duration)
+    image = pack(width, height, frames, durations, args.loops)
+    if len(image) > PARTITION_SIZE:
+        sys.exit("image is %d bytes, partition holds %d" % (len(image), PARTITION_SIZE))
+    with open(args.output, "wb") as f:
+        f.write(image)
+    total = sum(max(d, MIN_FRAME_MS) for d in durations)
+    print("%s: %d frames %dx%d, %d bytes, %.2f s per loop" % (args.output, len(frames), width, height, len(image), total / 1000))
+
+
+def cmd_play(args):
+    with open(args.image, "rb") as f:
+        anim = Animation(f.read())
+    print("%dx%d, %d frames, loops %s" % (anim.width, anim.height, anim.frame_count, anim.loop_count or "forever"))
+    start = time.monotonic()
+    for t_ms, i in anim.schedule(max_loops=args.loops):
+        delay = start + t_ms / 1000 - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+        px = anim.frame(i)
+        rows = []
+        for y in range(anim.height):
+            row = ""
+            for x in range(anim.width):
+                r, g, b = px[(y * anim.width + x) * 3:(y * anim.width + x) * 3 + 3]
+                row += "\x1b[48;2;%d;%d;%dm  " % (r, g, b)
+            rows.append(row + "\x1b[0m")
+        sys.stdout.write("\x1b[H\x1b[2J" + "\n".join(rows) + "\nframe %d @ %d ms\n" % (i, t_ms))
+        sys.stdout.flush()
+
+
+def test_pattern(width, height, frame_count):
+    """Frames and durations whose content is a formula of the position, host_sim/anim_format_test.c checks the same one."""
+    frames = []
+    for i in range(frame_count):
+        px = bytearray()
+        for p in range(width * height):
+            px += bytes([(i * 7 + p) & 0xFF, (255 - p - i) & 0xFF, (p * 3 + i * 11) & 0xFF])
+        frames.append(bytes(px))
+    # zero and the largest value reach the clamps of the player
+    durations = [0 if i == 0 else 0xFFFF if i == 1 else i * 33 for i in range(frame_count)]
+    return frames, durations
+
+
+def cmd_testimage(args):
+    width, height = (int(v) for v in args.size.lower().split("x"))
+    frames, durations = test_pattern(width, height, args.frames)
+    with open(args.output, "wb") as f:
+        f.write(pack(width, height, frames, durations, args.loops))
+
+
+def cmd_selftest(args):
+    w, h = 8, 8
+    frames = [bytes([i, 255 - i, i * 3 % 256]) * (w * h) for i in range(5)]
+    durations = [0, 33, 100, 65535, 20]
+    image = pack(w, h, frames, durations, loops=2)
+    anim = Animation(image)
+    assert anim.size == len(image) and frames_offset(5) % 4 == 0
+    assert [anim.duration(i) for i in range(5)] == durations
+    assert all(bytes(anim.frame(i)) == frames[i] for i in range(5))
+    sched = list(anim.schedule())
+    assert [i for _, i in sched] == list(range(5)) * 2
+    # zero duration is clamped, start times are cumulative
+    assert [t for t, _ in sched[:5]] == [0, 10, 43, 143, 65678]
+    for bad in (image[:-1], b"XXXX" + image[4:], image[:HEADER.size]):
+        try:
+            Animation(bad)
+        except ValueError:
+            continue
+        raise AssertionError("corrupt image accepted")
+    print("selftest ok")
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = p.add_subparsers(dest="cmd", required=True)
+    b = sub.add_parser("build", help="build an image from a GIF or a directory of frames")
+    b.add_argument("input")
+    b.add_argument("-o", "--output", default="anim.bin")
+    b.add_argument("--size", default="8x8", help="canvas WxH, must match the firmware canvas")
+    b.add_argument("--duration", type=int, default=100, help="ms per frame when the input has none")
+    b.add_argument("--loops", type=int, default=0, help="0 loops forever")
+    b.set_defaults(func=cmd_build)
+    pl = sub.add_parser("play", help="replay an image on the terminal")
+    pl.add_argument("image")
+    pl.add_argument("--loops", type=int, default=1)
+    pl.set_defaults(func=cmd_play)
+    sub.add_parser("selftest", help="check packing and the player schedule").set_defaults(func=cmd_selftest)
+    t = sub.add_parser("testimage", help="write an image with known content (no Pillow needed)")
+    t.add_argument("-o", "--output", default="test.bin")
+    t.add_argument("--size", default="8x8")
+    t.add_argument("--frames", type=int, default=5)
+    t.add_argument("--loops", type=int, default=2)
+    t.set_defaults(func=cmd_testimage)
+    args = p.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()